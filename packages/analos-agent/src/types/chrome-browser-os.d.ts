@@ -8,6 +8,11 @@ declare namespace chrome.analOS {
     isPageComplete: boolean;
   }
 
+  // Standard response for interaction methods
+  interface InteractionResponse {
+    success: boolean;
+  }
+
   // Rectangle bounds
   interface Rect {
     x: number;
@@ -57,11 +62,29 @@ declare namespace chrome.analOS {
     elements: InteractiveNode[];
     hierarchicalStructure?: string; // Hierarchical text representation with context
     processingTimeMs: number; // Performance metrics
+    timings?: SnapshotTimings; // Present if includeTimings was set
+    truncated?: boolean; // Tree hit maxNodes or timeoutMs; elements may be missing
+  }
+
+  // Per-phase timing breakdown of a snapshot, in milliseconds
+  interface SnapshotTimings {
+    requestMs: number; // Renderer AX serialization + IPC
+    treeBuildMs?: number;
+    batchMs?: number;
+    extractMs?: number;
+    serializeMs?: number;
+    totalMs: number;
+    nodeCount: number;
+    resultCount: number;
+    batchCount?: number;
   }
 
   // Options for getInteractiveSnapshot
   interface InteractiveSnapshotOptions {
     viewportOnly?: boolean;
+    includeTimings?: boolean;
+    maxNodes?: number; // Defaults to 50000
+    timeoutMs?: number; // Defaults to 5000
   }
 
   // Accessibility node
@@ -88,6 +111,17 @@ declare namespace chrome.analOS {
 
   function getPageLoadStatus(callback: (status: PageLoadStatus) => void): void;
 
+  // Options for getAccessibilityTree
+  interface AccessibilityTreeOptions {
+    includeInlineTextBoxes?: boolean; // Can double the node count
+  }
+
+  function getAccessibilityTree(
+    tabId: number,
+    options: AccessibilityTreeOptions,
+    callback: (tree: AccessibilityTree) => void,
+  ): void;
+
   function getAccessibilityTree(
     tabId: number,
     callback: (tree: AccessibilityTree) => void,
@@ -117,6 +151,52 @@ declare namespace chrome.analOS {
     callback: (snapshot: InteractiveSnapshot) => void,
   ): void;
 
+  // Per-tab results of the batch APIs; either the payload or error is set
+  interface TabResult {
+    tabId: number;
+    error?: string;
+    elapsedMs: number;
+  }
+
+  interface TabInteractiveSnapshotResult extends TabResult {
+    snapshot?: InteractiveSnapshot;
+  }
+
+  interface TabPageContentResult extends TabResult {
+    content?: {
+      items: ContentItem[];
+      timestamp: number;
+      processingTimeMs: number;
+      truncated?: boolean;
+    };
+  }
+
+  interface TabScreenshotResult extends TabResult {
+    dataUrl?: string;
+  }
+
+  // Batch variants: all tabs are requested concurrently
+  function getInteractiveSnapshots(
+    tabIds: number[],
+    callback: (results: TabInteractiveSnapshotResult[]) => void,
+  ): void;
+
+  function getSnapshots(
+    tabIds: number[],
+    callback: (results: TabPageContentResult[]) => void,
+  ): void;
+
+  function captureScreenshots(
+    tabIds: number[],
+    thumbnailSize: number,
+    callback: (results: TabScreenshotResult[]) => void,
+  ): void;
+
+  function captureScreenshots(
+    tabIds: number[],
+    callback: (results: TabScreenshotResult[]) => void,
+  ): void;
+
   function click(tabId: number, nodeId: number, callback: () => void): void;
 
   function click(nodeId: number, callback: () => void): void;
@@ -130,6 +210,23 @@ declare namespace chrome.analOS {
 
   function inputText(nodeId: number, text: string, callback: () => void): void;
 
+  // Text entry strategy for inputText
+  type InputTextMode = "typing" | "bulk";
+
+  // Options for inputText
+  interface InputTextOptions {
+    mode?: InputTextMode;  // "bulk" replaces the value in one SetValue operation
+    verify?: boolean;  // Read the value back from the AX tree (default true)
+  }
+
+  function inputText(
+    tabId: number,
+    nodeId: number,
+    text: string,
+    options: InputTextOptions,
+    callback: (response: InteractionResponse) => void,
+  ): void;
+
   function clear(tabId: number, nodeId: number, callback: () => void): void;
 
   function clear(nodeId: number, callback: () => void): void;
@@ -142,6 +239,50 @@ declare namespace chrome.analOS {
 
   function scrollDown(callback: () => void): void;
 
+  // Options for scrollBy / scrollTo
+  interface ScrollOptions {
+    nodeId?: number;  // Scroll this container instead of the page
+    behavior?: "instant" | "smooth";
+    waitForSettle?: boolean;  // Wait for the page to stop updating (default true)
+    quietPeriodMs?: number;  // Default 150
+    timeoutMs?: number;  // Default 2000
+  }
+
+  interface ScrollResult {
+    settled: boolean;
+    scrolled: boolean;
+    contentChanged: boolean;  // e.g. lazy-loaded items appeared
+    elapsedMs: number;
+  }
+
+  function scrollBy(
+    tabId: number,
+    deltaX: number,
+    deltaY: number,
+    options: ScrollOptions,
+    callback: (result: ScrollResult) => void,
+  ): void;
+
+  function scrollBy(
+    deltaX: number,
+    deltaY: number,
+    callback: (result: ScrollResult) => void,
+  ): void;
+
+  function scrollTo(
+    tabId: number,
+    x: number,
+    y: number,
+    options: ScrollOptions,
+    callback: (result: ScrollResult) => void,
+  ): void;
+
+  function scrollTo(
+    x: number,
+    y: number,
+    callback: (result: ScrollResult) => void,
+  ): void;
+
   function scrollToNode(
     tabId: number,
     nodeId: number,
@@ -334,9 +475,69 @@ declare namespace chrome.analOS {
     callback: (snapshot: Snapshot) => void,
   ): void;
 
+  // Content item returned by harvestContent, in document order
+  interface ContentItem {
+    type: "heading" | "text" | "link" | "image" | "video";
+    text?: string;
+    url?: string;
+    level?: number;
+    alt?: string;
+  }
+
+  interface HarvestOptions {
+    maxItems?: number;  // Default 500
+    maxScrolls?: number;  // Default 20
+    timeoutMs?: number;  // Default 30000
+    scrollDelta?: number;  // Default 90% of the viewport height
+    maxIdleScrolls?: number;  // Scrolls without new content before stopping (default 2)
+    dedupe?: "contentHash" | "nodeId";
+    reset?: boolean;  // Forget items returned by earlier calls for this tab
+  }
+
+  interface HarvestResult {
+    items: ContentItem[];  // Only items not returned by earlier calls
+    scrollCount: number;
+    endOfFeed: boolean;
+    stopReason: "endOfFeed" | "maxItems" | "maxScrolls" | "timeout";
+    processingTimeMs: number;
+  }
+
+  function harvestContent(
+    tabId: number,
+    options: HarvestOptions,
+    callback: (result: HarvestResult) => void,
+  ): void;
+
+  function harvestContent(
+    options: HarvestOptions,
+    callback: (result: HarvestResult) => void,
+  ): void;
+
   // Get AnalOS version number
   function getVersionNumber(callback: (version: string) => void): void;
 
+  // Diagnostics for the local AnalOS server process
+  interface ServerStats {
+    running: boolean;
+    pid?: number;
+    uptimeMs?: number;
+    restartCount: number;
+    // From the latest periodic sample; missing until the first one or where
+    // the platform cannot report it
+    residentSetBytes?: number;
+    cpuTimeMs?: number;
+    openFdCount?: number;
+    // Over the most recent successful /health checks
+    healthCheckCount: number;
+    healthCheckLatencyMedianMs?: number;
+    healthCheckLatencyP95Ms?: number;
+    healthCheckLatencyMaxMs?: number;
+    healthCheckFailures: number;
+  }
+
+  // Get resource usage, restarts and health-check latency of the server
+  function getServerStats(callback: (stats: ServerStats) => void): void;
+
   // Logs a metric event with optional properties
   function logMetric(
     eventName: string,
@@ -362,6 +563,43 @@ declare namespace chrome.analOS {
     callback: (result: any) => void,
   ): void;
 
+  interface ExecuteJavaScriptOptions {
+    isolatedWorld?: boolean;  // Hide the script from page scripts
+    frameId?: number;  // Defaults to the main frame
+    timeoutMs?: number;  // Default 30000
+    maxResultBytes?: number;  // Default 4 MiB of serialized JSON
+  }
+
+  function executeJavaScript(
+    tabId: number,
+    code: string,
+    options: ExecuteJavaScriptOptions,
+    callback: (result: any) => void,
+  ): void;
+
+  // Store a helper script once per profile; |code| is a function body that
+  // receives |args| and returns the result
+  function registerScript(
+    name: string,
+    code: string,
+    callback?: () => void,
+  ): void;
+
+  // Run a registered script; only the name and arguments are sent per call
+  function runScript(
+    tabId: number,
+    name: string,
+    args: any,
+    options: ExecuteJavaScriptOptions,
+    callback: (result: any) => void,
+  ): void;
+
+  function runScript(
+    name: string,
+    args: any,
+    callback: (result: any) => void,
+  ): void;
+
   // Click at specific viewport coordinates
   function clickCoordinates(
     tabId: number,
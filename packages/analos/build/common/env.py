@@ -165,6 +165,13 @@ class EnvConfig:
         """Base64-encoded Sparkle Ed25519 private key for macOS auto-update signing"""
         return os.environ.get("SPARKLE_PRIVATE_KEY")
 
+    # === AnalOS Server Update Signing ===
+
+    @property
+    def server_update_private_key(self) -> Optional[str]:
+        """Base64-encoded PEM Ed25519 key that signs server update manifests"""
+        return os.environ.get("ANALOS_SERVER_UPDATE_KEY")
+
     # === Notifications ===
 
     @property
@@ -254,3 +261,7 @@ class EnvConfig:
     def has_sparkle_key(self) -> bool:
         """Check if Sparkle private key is available"""
         return bool(self.sparkle_private_key)
+
+    def has_server_update_key(self) -> bool:
+        """Check if the server update signing key is available"""
+        return bool(self.server_update_private_key)
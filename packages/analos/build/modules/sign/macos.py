@@ -10,6 +10,7 @@ from typing import Optional, List, Dict, Tuple
 from ...common.module import CommandModule, ValidationError
 from ...common.context import Context
 from ...common.env import EnvConfig
+from .server_manifest import write_server_version_manifest
 from ...common.utils import (
     run_command as utils_run_command,
     log_info,
@@ -434,6 +435,13 @@ def sign_all_components(
             if not sign_component(exe, certificate_name, identifier, options, entitlements):
                 return False
 
+        # Signing rewrote the server binary; its version manifest describes
+        # the signed one and is sealed into the bundle with the resources
+        env = ctx.env if ctx else EnvConfig()
+        for exe in components["executables"]:
+            if exe.name == "analos_server":
+                write_server_version_manifest(exe, env)
+
     # 4. Sign dylibs
     if components["dylibs"]:
         log_info("\n🔏 Signing dynamic libraries...")
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""Signed version manifest for the bundled AnalOS Server binary
+
+The browser reads the server version from resources/version.json instead of
+running the binary with --version. The manifest records the binary's size and
+SHA-512, so it has to be written after code signing, which rewrites the
+binary:
+
+  version.json      {"version": "0.30.0", "size": 123456, "sha512": "<hex>"}
+  version.json.sig  Ed25519 signature of version.json (base64)
+
+The signature is made with the server update key (ANALOS_SERVER_UPDATE_KEY,
+a base64-encoded PEM Ed25519 private key) through `openssl pkeyutl`, which
+needs OpenSSL 3. Without the key no manifest is written and the browser falls
+back to running the binary.
+"""
+
+import base64
+import hashlib
+import json
+import os
+import subprocess
+import tempfile
+from pathlib import Path
+from typing import Optional
+
+from ...common.env import EnvConfig
+from ...common.utils import log_info, log_error, log_success, log_warning
+
+MANIFEST_FILE_NAME = "version.json"
+SIGNATURE_FILE_NAME = "version.json.sig"
+
+
+def write_server_version_manifest(binary_path: Path, env: EnvConfig) -> bool:
+    """Write and sign version.json for a signed server binary
+
+    Args:
+        binary_path: The signed binary, in <resources>/bin/
+        env: Environment holding the server update key
+
+    Returns:
+        True if the manifest was written, False otherwise
+    """
+    resources_dir = binary_path.parent.parent
+    manifest_path = resources_dir / MANIFEST_FILE_NAME
+    signature_path = resources_dir / SIGNATURE_FILE_NAME
+
+    # A manifest from before signing no longer matches the binary
+    for path in (manifest_path, signature_path):
+        if path.exists():
+            path.unlink()
+
+    if not env.has_server_update_key():
+        log_warning(
+            "ANALOS_SERVER_UPDATE_KEY not set, skipping server version manifest"
+        )
+        return False
+
+    version = _read_binary_version(binary_path)
+    if not version:
+        return False
+
+    data = binary_path.read_bytes()
+    manifest = json.dumps(
+        {
+            "version": version,
+            "size": len(data),
+            "sha512": hashlib.sha512(data).hexdigest(),
+        },
+        separators=(",", ":"),
+    ).encode("utf-8")
+
+    signature = _sign_ed25519(manifest, env.server_update_private_key)
+    if not signature:
+        return False
+
+    manifest_path.write_bytes(manifest)
+    signature_path.write_text(base64.b64encode(signature).decode("ascii"))
+    log_success(f"✓ Wrote server version manifest ({version}) to {resources_dir}")
+    return True
+
+
+def _read_binary_version(binary_path: Path) -> Optional[str]:
+    """Run the binary with --version, as the browser would"""
+    try:
+        result = subprocess.run(
+            [str(binary_path), "--version"],
+            capture_output=True,
+            text=True,
+            check=False,
+            timeout=60,
+        )
+    except (OSError, subprocess.TimeoutExpired) as e:
+        log_error(f"Failed to run {binary_path.name} --version: {e}")
+        return None
+
+    version = result.stdout.strip()
+    if result.returncode != 0 or not version:
+        log_error(f"{binary_path.name} --version failed: {result.stderr}")
+        return None
+    return version
+
+
+def _sign_ed25519(data: bytes, key_base64: str) -> Optional[bytes]:
+    """Sign data with a base64-encoded PEM Ed25519 private key"""
+    try:
+        key_pem = base64.b64decode(key_base64)
+    except Exception:
+        log_error("ANALOS_SERVER_UPDATE_KEY is not valid base64")
+        return None
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        key_path = Path(temp_dir) / "server_update.key"
+        data_path = Path(temp_dir) / MANIFEST_FILE_NAME
+        key_path.write_bytes(key_pem)
+        os.chmod(key_path, 0o600)
+        data_path.write_bytes(data)
+
+        log_info("🔐 Signing server version manifest...")
+        result = subprocess.run(
+            [
+                "openssl",
+                "pkeyutl",
+                "-sign",
+                "-rawin",
+                "-inkey",
+                str(key_path),
+                "-in",
+                str(data_path),
+            ],
+            capture_output=True,
+            check=False,
+        )
+        if result.returncode != 0:
+            log_error(
+                f"openssl pkeyutl failed: {result.stderr.decode(errors='replace')}"
+            )
+            return None
+        return result.stdout
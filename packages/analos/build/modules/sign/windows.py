@@ -7,6 +7,7 @@ from typing import List, Optional
 from ...common.module import CommandModule, ValidationError
 from ...common.context import Context
 from ...common.env import EnvConfig
+from .server_manifest import write_server_version_manifest
 from ...common.utils import (
     log_info,
     log_error,
@@ -81,6 +82,12 @@ class WindowsSignModule(CommandModule):
         if not sign_with_codesigntool(existing_binaries, env):
             raise RuntimeError("Failed to sign executables")
 
+        # Signing rewrote the server binary; its version manifest must
+        # describe the signed one, before mini_installer packages both
+        server_binary = get_analos_server_binary_paths(build_output_dir)[0]
+        if server_binary.exists():
+            write_server_version_manifest(server_binary, env)
+
     def _build_mini_installer(self, ctx: Context) -> None:
         log_info("\nStep 2/3: Building mini_installer with signed binaries...")
         if not build_mini_installer(ctx):
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/core/analos_switches.h b/chrome/browser/analos/core/analos_switches.h
 new file mode 100644
-index 0000000000000..4e7932596534c
+index 0000000000000..ae07e116961eb
 --- /dev/null
 +++ b/chrome/browser/analos/core/analos_switches.h
-@@ -0,0 +1,83 @@
+@@ -0,0 +1,94 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -45,6 +45,12 @@ index 0000000000000..4e7932596534c
 +// Overrides the Extension server port.
 +inline constexpr char kExtensionPort[] = "analos-extension-port";
 +
++// Hands the MCP/Agent/Extension listeners to the server as inherited sockets
++// (systemd-style LISTEN_FDS/LISTEN_FDNAMES, no LISTEN_PID) instead of letting
++// it bind the ports itself. POSIX only; needs a server that supports it.
++inline constexpr char kServerSocketActivation[] =
++    "analos-server-socket-activation";
++
 +// === Extension Switches ===
 +
 +// Disables AnalOS managed extensions.
@@ -53,6 +59,11 @@ index 0000000000000..4e7932596534c
 +// Overrides the extensions config URL.
 +inline constexpr char kExtensionsUrl[] = "analos-extensions-url";
 +
++// === Metrics Switches ===
++
++// Overrides the metrics batch endpoint (testing, e.g. a local server).
++inline constexpr char kMetricsUrl[] = "analos-metrics-url";
++
 +// === URL Override Switches ===
 +
 +// Disables chrome://analos/* URL overrides.
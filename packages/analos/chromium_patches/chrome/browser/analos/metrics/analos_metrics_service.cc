@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/metrics/analos_metrics_service.cc b/chrome/browser/analos/metrics/analos_metrics_service.cc
 new file mode 100644
-index 0000000000000..8c8c588df4481
+index 0000000000000..738a550725d38
 --- /dev/null
 +++ b/chrome/browser/analos/metrics/analos_metrics_service.cc
-@@ -0,0 +1,231 @@
+@@ -0,0 +1,453 @@
 +// Copyright 2025 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -12,14 +12,24 @@ index 0000000000000..8c8c588df4481
 +
 +#include <memory>
 +#include <string>
++#include <utility>
 +
++#include "base/command_line.h"
++#include "base/files/file_util.h"
++#include "base/files/important_file_writer.h"
++#include "base/functional/bind.h"
++#include "base/i18n/time_formatting.h"
 +#include "base/uuid.h"
++#include "base/json/json_reader.h"
 +#include "base/json/json_writer.h"
 +#include "base/logging.h"
 +#include "base/strings/string_number_conversions.h"
 +#include "base/system/sys_info.h"
++#include "base/task/thread_pool.h"
 +#include "base/time/time.h"
++#include "chrome/browser/analos/core/analos_switches.h"
 +#include "chrome/common/pref_names.h"
++#include "components/compression/compression_utils.h"
 +#include "components/prefs/pref_service.h"
 +#include "components/version_info/version_info.h"
 +#include "net/base/load_flags.h"
@@ -41,20 +51,47 @@ index 0000000000000..8c8c588df4481
 +
 +// PostHog API configuration
 +constexpr char kPostHogApiKey[] = "phc_PRrpVnBMVJgUumvaXzUnwKZ1dDs3L8MSICLhTdnc8jC";
-+constexpr char kPostHogEndpoint[] = "https://us.i.posthog.com/i/v0/e/";
++constexpr char kPostHogBatchEndpoint[] = "https://us.i.posthog.com/batch/";
 +constexpr size_t kMaxUploadSize = 256 * 1024;  // 256KB max upload size
 +
++// A batch is sent as soon as this many events are queued...
++constexpr size_t kMaxBatchSize = 50;
++// ...or once the oldest queued event has waited this long
++constexpr base::TimeDelta kFlushInterval = base::Seconds(30);
++// Past this many queued events (e.g. while offline), the oldest are dropped
++constexpr size_t kMaxQueuedEvents = 1000;
++// Largest queue file read back at startup
++constexpr size_t kMaxQueueFileSize = 4 * 1024 * 1024;
++
++// Unsent events saved at shutdown, in the profile directory
++constexpr base::FilePath::CharType kQueueFileName[] =
++    FILE_PATH_LITERAL("AnalOS Metrics Queue");
++
++// Failed batch uploads
++constexpr net::BackoffEntry::Policy kUploadRetryPolicy = {
++    0,                   // Number of initial errors to ignore.
++    30 * 1000,           // Initial delay of 30 seconds.
++    2.0,                 // Factor by which the waiting time will be multiplied.
++    0.2,                 // Fuzzing percentage.
++    30 * 60 * 1000,      // Maximum delay of 30 minutes.
++    -1,                  // Never discard the entry.
++    false,               // Don't use initial delay unless the last request was
++                         // an error.
++};
++
 +constexpr net::NetworkTrafficAnnotationTag kAnalOSMetricsTrafficAnnotation =
 +    net::DefineNetworkTrafficAnnotation("analos_metrics", R"(
 +        semantics {
 +          sender: "AnalOS Metrics"
 +          description:
-+            "Sends anonymous usage metrics to PostHog for AnalOS features. "
-+            "This helps improve the browser by understanding how features are "
-+            "used. No personally identifiable information is collected."
++            "Sends anonymous usage metrics to PostHog for AnalOS features, "
++            "in compressed batches. This helps improve the browser by "
++            "understanding how features are used. No personally identifiable "
++            "information is collected."
 +          trigger:
 +            "Triggered when AnalOS features are used, such as extension "
-+            "actions or settings changes."
++            "actions or settings changes. Events are batched for up to 30 "
++            "seconds, and those unsent at shutdown are sent next session."
 +          data:
 +            "Event name, timestamp, anonymous client ID, browser version, "
 +            "OS information, and feature-specific properties without PII."
@@ -72,20 +109,81 @@ index 0000000000000..8c8c588df4481
 +            "the browser experience."
 +        })");
 +
++// Reads the events saved by WriteQueueFile(), oldest first.
++base::Value::List ReadQueueFile(const base::FilePath& path) {
++  std::string json;
++  if (!base::ReadFileToStringWithMaxSize(path, &json, kMaxQueueFileSize)) {
++    return base::Value::List();
++  }
++  std::optional<base::Value> events = base::JSONReader::Read(json);
++  if (!events || !events->is_list()) {
++    LOG(WARNING) << "analos: Discarding invalid metrics queue file";
++    return base::Value::List();
++  }
++  return std::move(*events).TakeList();
++}
++
++// Saves |events| after any the file still holds, keeping the newest
++// kMaxQueuedEvents. Deletes the file if there is nothing to save.
++void WriteQueueFile(const base::FilePath& path, base::Value::List events) {
++  base::Value::List all = ReadQueueFile(path);
++  for (base::Value& event : events) {
++    all.Append(std::move(event));
++  }
++
++  if (all.empty()) {
++    base::DeleteFile(path);
++    return;
++  }
++  if (all.size() > kMaxQueuedEvents) {
++    all.erase(all.begin(), all.begin() + (all.size() - kMaxQueuedEvents));
++  }
++
++  std::string json;
++  if (!base::JSONWriter::Write(all, &json) ||
++      !base::ImportantFileWriter::WriteFileAtomically(path, json)) {
++    LOG(ERROR) << "analos: Failed to save metrics queue";
++  }
++}
++
 +}  // namespace
 +
 +AnalOSMetricsService::AnalOSMetricsService(
 +    PrefService* pref_service,
 +    PrefService* local_state_prefs,
-+    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory)
++    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
++    const base::FilePath& profile_path)
 +    : pref_service_(pref_service),
 +      local_state_prefs_(local_state_prefs),
-+      url_loader_factory_(std::move(url_loader_factory)) {
++      url_loader_factory_(std::move(url_loader_factory)),
++      endpoint_(kPostHogBatchEndpoint),
++      queue_path_(profile_path.Append(kQueueFileName)),
++      file_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
++          {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
++           base::TaskShutdownBehavior::BLOCK_SHUTDOWN})),
++      upload_backoff_(&kUploadRetryPolicy) {
 +  CHECK(pref_service_);
 +  CHECK(local_state_prefs_);
 +  CHECK(url_loader_factory_);
 +  InitializeClientId();
 +  InitializeInstallId();
++
++  // Allow sending to a local endpoint for testing
++  base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
++  if (command_line->HasSwitch(analos::kMetricsUrl)) {
++    GURL url(command_line->GetSwitchValueASCII(analos::kMetricsUrl));
++    if (url.is_valid()) {
++      endpoint_ = url;
++    } else {
++      LOG(WARNING) << "analos: Ignoring invalid metrics URL: " << url;
++    }
++  }
++
++  // Pick up events left unsent by the last session
++  file_task_runner_->PostTaskAndReplyWithResult(
++      FROM_HERE, base::BindOnce(&ReadQueueFile, queue_path_),
++      base::BindOnce(&AnalOSMetricsService::OnPersistedQueueLoaded,
++                     weak_factory_.GetWeakPtr()));
 +}
 +
 +AnalOSMetricsService::~AnalOSMetricsService() = default;
@@ -97,13 +195,24 @@ index 0000000000000..8c8c588df4481
 +    return;
 +  }
 +
++  if (shutdown_) {
++    return;
++  }
++
 +  VLOG(1) << "analos: Capturing event: " << event_name;
 +
 +  // Add default properties
 +  AddDefaultProperties(properties);
 +
-+  // Send to PostHog
-+  SendEventToPostHog(event_name, std::move(properties));
++  base::Value::Dict event;
++  event.Set("event", "analos.native." + event_name);
++  event.Set("distinct_id", client_id_);
++  event.Set("properties", std::move(properties));
++  // Sent later in a batch, so record when it happened
++  event.Set("timestamp", base::TimeFormatAsIso8601(base::Time::Now()));
++
++  EnqueueEvent(std::move(event));
++  ScheduleFlush();
 +}
 +
 +std::string AnalOSMetricsService::GetClientId() const {
@@ -115,8 +224,14 @@ index 0000000000000..8c8c588df4481
 +}
 +
 +void AnalOSMetricsService::Shutdown() {
-+  // Cancel any pending network requests
++  shutdown_ = true;
++  flush_timer_.Stop();
++
++  // Cancel any pending network requests; their events are saved with the
++  // rest
++  upload_loader_.reset();
 +  weak_factory_.InvalidateWeakPtrs();
++  PersistQueue();
 +}
 +
 +void AnalOSMetricsService::InitializeClientId() {
@@ -157,62 +272,169 @@ index 0000000000000..8c8c588df4481
 +  VLOG(1) << "analos: Metrics install ID: " << install_id_;
 +}
 +
-+void AnalOSMetricsService::SendEventToPostHog(
-+    const std::string& event_name,
-+    base::Value::Dict properties) {
++void AnalOSMetricsService::EnqueueEvent(base::Value::Dict event) {
++  if (queue_.size() >= kMaxQueuedEvents) {
++    VLOG(1) << "analos: Metrics queue full, dropping oldest event";
++    queue_.pop_front();
++  }
++  queue_.push_back(std::move(event));
++}
++
++void AnalOSMetricsService::ScheduleFlush() {
++  if (upload_loader_ || queue_.empty()) {
++    return;  // Rescheduled when the upload completes
++  }
++
++  if (queue_.size() >= kMaxBatchSize &&
++      !upload_backoff_.ShouldRejectRequest()) {
++    Flush();
++    return;
++  }
++
++  if (!flush_timer_.IsRunning()) {
++    flush_timer_.Start(FROM_HERE, kFlushInterval, this,
++                       &AnalOSMetricsService::Flush);
++  }
++}
++
++void AnalOSMetricsService::Flush() {
++  flush_timer_.Stop();
++  if (upload_loader_ || queue_.empty()) {
++    return;
++  }
++
++  while (!queue_.empty() && in_flight_.size() < kMaxBatchSize) {
++    in_flight_.Append(std::move(queue_.front()));
++    queue_.pop_front();
++  }
++
 +  // Build the request payload
 +  base::Value::Dict payload;
 +  payload.Set("api_key", kPostHogApiKey);
-+  payload.Set("event", "analos.native." + event_name);
-+  payload.Set("distinct_id", client_id_);
-+  payload.Set("properties", std::move(properties));
++  payload.Set("batch", in_flight_.Clone());
 +
-+  // Convert to JSON
++  // Convert to JSON and compress
 +  std::string json_payload;
-+  if (!base::JSONWriter::Write(payload, &json_payload)) {
++  std::string compressed_payload;
++  if (!base::JSONWriter::Write(payload, &json_payload) ||
++      !compression::GzipCompress(json_payload, &compressed_payload)) {
 +    LOG(ERROR) << "analos: Failed to serialize metrics payload";
++    in_flight_.clear();
++    ScheduleFlush();
 +    return;
 +  }
 +
 +  // Create the request
 +  auto resource_request = std::make_unique<network::ResourceRequest>();
-+  resource_request->url = GURL(kPostHogEndpoint);
++  resource_request->url = endpoint_;
 +  resource_request->method = "POST";
 +  resource_request->load_flags = net::LOAD_DISABLE_CACHE;
 +  resource_request->credentials_mode = network::mojom::CredentialsMode::kOmit;
++  resource_request->headers.SetHeader("Content-Encoding", "gzip");
 +
 +  // Create the URL loader
-+  auto url_loader = network::SimpleURLLoader::Create(
++  upload_loader_ = network::SimpleURLLoader::Create(
 +      std::move(resource_request), kAnalOSMetricsTrafficAnnotation);
-+  url_loader->SetAllowHttpErrorResults(true);
-+  url_loader->AttachStringForUpload(json_payload, "application/json");
++  upload_loader_->SetAllowHttpErrorResults(true);
++  upload_loader_->AttachStringForUpload(compressed_payload,
++                                        "application/json");
++
++  VLOG(2) << "analos: Sending " << in_flight_.size() << " metrics events ("
++          << json_payload.size() << " bytes, " << compressed_payload.size()
++          << " compressed)";
 +
 +  // Send the request
-+  network::SimpleURLLoader* loader_ptr = url_loader.get();
-+  loader_ptr->DownloadToString(
++  upload_loader_->DownloadToString(
 +      url_loader_factory_.get(),
-+      base::BindOnce(&AnalOSMetricsService::OnPostHogResponse,
-+                     weak_factory_.GetWeakPtr(), std::move(url_loader)),
++      base::BindOnce(&AnalOSMetricsService::OnUploadComplete,
++                     weak_factory_.GetWeakPtr()),
 +      kMaxUploadSize);
 +}
 +
-+void AnalOSMetricsService::OnPostHogResponse(
-+    std::unique_ptr<network::SimpleURLLoader> loader,
++void AnalOSMetricsService::OnUploadComplete(
 +    std::unique_ptr<std::string> response_body) {
 +  int response_code = 0;
-+  if (loader->ResponseInfo() && loader->ResponseInfo()->headers) {
-+    response_code = loader->ResponseInfo()->headers->response_code();
++  if (upload_loader_->ResponseInfo() &&
++      upload_loader_->ResponseInfo()->headers) {
++    response_code = upload_loader_->ResponseInfo()->headers->response_code();
 +  }
++  upload_loader_.reset();
 +
 +  if (response_code == net::HTTP_OK) {
-+    VLOG(2) << "analos: Metrics event sent successfully";
-+  } else {
-+    LOG(WARNING) << "analos: Failed to send metrics event. Response code: "
-+                 << response_code;
-+    if (response_body && !response_body->empty()) {
-+      LOG(WARNING) << "analos: Error response: " << *response_body;
++    VLOG(2) << "analos: Metrics batch sent successfully";
++    in_flight_.clear();
++    upload_backoff_.InformOfRequest(true);
++    ScheduleFlush();
++    return;
++  }
++
++  LOG(WARNING) << "analos: Failed to send metrics batch. Response code: "
++               << response_code;
++  if (response_body && !response_body->empty()) {
++    LOG(WARNING) << "analos: Error response: " << *response_body;
++  }
++
++  // A rejected batch won't be accepted later; anything else is retried
++  bool retry = response_code == 0 ||
++               response_code == net::HTTP_TOO_MANY_REQUESTS ||
++               response_code >= net::HTTP_INTERNAL_SERVER_ERROR;
++  if (!retry) {
++    in_flight_.clear();
++    ScheduleFlush();
++    return;
++  }
++
++  // Requeue ahead of newer events, dropping the oldest if the queue is full
++  for (size_t i = in_flight_.size(); i > 0; --i) {
++    if (queue_.size() >= kMaxQueuedEvents) {
++      break;
 +    }
++    queue_.push_front(std::move(in_flight_[i - 1].GetDict()));
 +  }
++  in_flight_.clear();
++
++  upload_backoff_.InformOfRequest(false);
++  flush_timer_.Start(FROM_HERE, upload_backoff_.GetTimeUntilRelease(), this,
++                     &AnalOSMetricsService::Flush);
++}
++
++void AnalOSMetricsService::OnPersistedQueueLoaded(base::Value::List events) {
++  // The file is rewritten at shutdown with whatever is unsent by then
++  file_task_runner_->PostTask(
++      FROM_HERE,
++      base::BindOnce(base::IgnoreResult(&base::DeleteFile), queue_path_));
++
++  if (events.empty()) {
++    return;
++  }
++  VLOG(1) << "analos: Loaded " << events.size() << " unsent metrics events";
++
++  // Older than anything captured since startup
++  for (size_t i = events.size(); i > 0; --i) {
++    if (queue_.size() >= kMaxQueuedEvents) {
++      break;
++    }
++    if (events[i - 1].is_dict()) {
++      queue_.push_front(std::move(events[i - 1].GetDict()));
++    }
++  }
++  ScheduleFlush();
++}
++
++void AnalOSMetricsService::PersistQueue() {
++  base::Value::List events = std::move(in_flight_);
++  in_flight_ = base::Value::List();
++  for (base::Value::Dict& event : queue_) {
++    events.Append(std::move(event));
++  }
++  queue_.clear();
++  if (events.empty()) {
++    return;
++  }
++
++  file_task_runner_->PostTask(
++      FROM_HERE, base::BindOnce(&WriteQueueFile, queue_path_,
++                                std::move(events)));
 +}
 +
 +void AnalOSMetricsService::AddDefaultProperties(
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/metrics/analos_metrics_service.h b/chrome/browser/analos/metrics/analos_metrics_service.h
 new file mode 100644
-index 0000000000000..2157d1eb1698e
+index 0000000000000..2a06060206822
 --- /dev/null
 +++ b/chrome/browser/analos/metrics/analos_metrics_service.h
-@@ -0,0 +1,95 @@
+@@ -0,0 +1,145 @@
 +// Copyright 2025 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -14,10 +14,16 @@ index 0000000000000..2157d1eb1698e
 +#include <memory>
 +#include <string>
 +
++#include "base/containers/circular_deque.h"
++#include "base/files/file_path.h"
 +#include "base/functional/callback.h"
++#include "base/memory/scoped_refptr.h"
 +#include "base/memory/weak_ptr.h"
++#include "base/task/sequenced_task_runner.h"
++#include "base/timer/timer.h"
 +#include "base/values.h"
 +#include "components/keyed_service/core/keyed_service.h"
++#include "net/base/backoff_entry.h"
 +#include "services/network/public/cpp/simple_url_loader.h"
 +#include "url/gurl.h"
 +
@@ -32,12 +38,18 @@ index 0000000000000..2157d1eb1698e
 +// Service for capturing and sending analytics events to PostHog.
 +// This service manages a stable client ID (per-profile) and install ID
 +// (per-installation) and sends events to the PostHog API.
++//
++// Events are queued in memory (oldest dropped past a cap) and sent as
++// gzip-compressed batches, once enough have queued or after a short delay.
++// Failed batches are requeued and retried with backoff. Events still queued
++// at Shutdown() are saved in the profile directory and sent next session.
 +class AnalOSMetricsService : public KeyedService {
 + public:
 +  explicit AnalOSMetricsService(
 +      PrefService* pref_service,
 +      PrefService* local_state_prefs,
-+      scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory);
++      scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
++      const base::FilePath& profile_path);
 +
 +  AnalOSMetricsService(const AnalOSMetricsService&) = delete;
 +  AnalOSMetricsService& operator=(const AnalOSMetricsService&) = delete;
@@ -66,13 +78,23 @@ index 0000000000000..2157d1eb1698e
 +  // Initializes or retrieves the stable install ID from local state.
 +  void InitializeInstallId();
 +
-+  // Sends the event to PostHog API.
-+  void SendEventToPostHog(const std::string& event_name,
-+                          base::Value::Dict properties);
++  // Adds an event to the queue, dropping the oldest one if it is full.
++  void EnqueueEvent(base::Value::Dict event);
++
++  // Sends a batch now if a full one is queued, or arms the flush timer.
++  void ScheduleFlush();
++
++  // Sends the oldest queued events to the PostHog batch API.
++  void Flush();
 +
 +  // Handles the response from PostHog API.
-+  void OnPostHogResponse(std::unique_ptr<network::SimpleURLLoader> loader,
-+                         std::unique_ptr<std::string> response_body);
++  void OnUploadComplete(std::unique_ptr<std::string> response_body);
++
++  // Queues events saved by an earlier session ahead of newer ones.
++  void OnPersistedQueueLoaded(base::Value::List events);
++
++  // Saves unsent events to |queue_path_|.
++  void PersistQueue();
 +
 +  // Adds default properties to the event.
 +  void AddDefaultProperties(base::Value::Dict& properties);
@@ -92,6 +114,34 @@ index 0000000000000..2157d1eb1698e
 +  // Stable install ID for this browser installation.
 +  std::string install_id_;
 +
++  // Batch API endpoint (overridable with --analos-metrics-url).
++  GURL endpoint_;
++
++  // File holding events not sent before the last shutdown.
++  base::FilePath queue_path_;
++
++  // Sequence for reading and writing |queue_path_|.
++  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
++
++  // Events waiting to be sent, oldest first.
++  base::circular_deque<base::Value::Dict> queue_;
++
++  // Events of the batch being uploaded, requeued if it fails.
++  base::Value::List in_flight_;
++
++  // Loader of the batch being uploaded; at most one at a time.
++  std::unique_ptr<network::SimpleURLLoader> upload_loader_;
++
++  // Sends a partial batch once events have waited long enough, or retries a
++  // failed one.
++  base::OneShotTimer flush_timer_;
++
++  // Failed uploads delay the next one exponentially.
++  net::BackoffEntry upload_backoff_;
++
++  // Set by Shutdown(); no more events are accepted.
++  bool shutdown_ = false;
++
 +  // Weak pointer factory for callbacks.
 +  base::WeakPtrFactory<AnalOSMetricsService> weak_factory_{this};
 +};
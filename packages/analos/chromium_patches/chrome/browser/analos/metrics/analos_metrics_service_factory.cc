@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/metrics/analos_metrics_service_factory.cc b/chrome/browser/analos/metrics/analos_metrics_service_factory.cc
 new file mode 100644
-index 0000000000000..794961e6e39aa
+index 0000000000000..d3a9a4ab15a8c
 --- /dev/null
 +++ b/chrome/browser/analos/metrics/analos_metrics_service_factory.cc
-@@ -0,0 +1,58 @@
+@@ -0,0 +1,59 @@
 +// Copyright 2025 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -58,7 +58,8 @@ index 0000000000000..794961e6e39aa
 +      profile->GetPrefs(),
 +      g_browser_process->local_state(),
 +      profile->GetDefaultStoragePartition()
-+          ->GetURLLoaderFactoryForBrowserProcess());
++          ->GetURLLoaderFactoryForBrowserProcess(),
++      profile->GetPath());
 +}
 +
 +}  // namespace analos_metrics
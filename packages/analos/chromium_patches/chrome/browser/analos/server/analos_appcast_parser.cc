@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/server/analos_appcast_parser.cc b/chrome/browser/analos/server/analos_appcast_parser.cc
 new file mode 100644
-index 0000000000000..dd30f75d414ec
+index 0000000000000..b4c5ef7910b4f
 --- /dev/null
 +++ b/chrome/browser/analos/server/analos_appcast_parser.cc
-@@ -0,0 +1,202 @@
+@@ -0,0 +1,254 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -100,11 +100,21 @@ index 0000000000000..dd30f75d414ec
 +    enclosure.signature = it->second;
 +  }
 +
++  it = attrs.find("sparkle:edDigestSignature");
++  if (it != attrs.end()) {
++    enclosure.digest_signature = it->second;
++  }
++
 +  it = attrs.find("length");
 +  if (it != attrs.end()) {
 +    base::StringToInt64(it->second, &enclosure.length);
 +  }
 +
++  it = attrs.find("sparkle:deltaFrom");
++  if (it != attrs.end()) {
++    enclosure.delta_from = base::Version(it->second);
++  }
++
 +  return enclosure;
 +}
 +
@@ -123,25 +133,63 @@ index 0000000000000..dd30f75d414ec
 +  return nullptr;
 +}
 +
++const AppcastEnclosure* AppcastItem::GetDeltaForCurrentPlatform(
++    const base::Version& from) const {
++  if (!from.IsValid()) {
++    return nullptr;
++  }
++  for (const auto& delta : deltas) {
++    if (delta.delta_from == from && delta.MatchesCurrentPlatform()) {
++      return &delta;
++    }
++  }
++  return nullptr;
++}
++
 +// static
 +std::optional<AppcastItem> AnalOSAppcastParser::ParseLatestItem(
 +    const std::string& xml) {
-+  std::vector<AppcastItem> items = ParseAllItems(xml);
-+  if (items.empty()) {
-+    return std::nullopt;
-+  }
-+  return std::move(items[0]);
++  std::optional<AppcastItem> latest;
++  ReadItems(xml, /*current_platform_only=*/false, [&](AppcastItem item) {
++    latest = std::move(item);
++    return false;
++  });
++  return latest;
++}
++
++// static
++std::optional<AppcastItem>
++AnalOSAppcastParser::ParseLatestItemForCurrentPlatform(const std::string& xml) {
++  std::optional<AppcastItem> latest;
++  ReadItems(xml, /*current_platform_only=*/true, [&](AppcastItem item) {
++    latest = std::move(item);
++    return false;
++  });
++  return latest;
 +}
 +
 +// static
 +std::vector<AppcastItem> AnalOSAppcastParser::ParseAllItems(
 +    const std::string& xml) {
 +  std::vector<AppcastItem> items;
++  ReadItems(xml, /*current_platform_only=*/false, [&](AppcastItem item) {
++    items.push_back(std::move(item));
++    return true;
++  });
++
++  VLOG(1) << "analos: Parsed " << items.size() << " appcast items";
++  return items;
++}
 +
++// static
++void AnalOSAppcastParser::ReadItems(
++    const std::string& xml,
++    bool current_platform_only,
++    base::FunctionRef<bool(AppcastItem)> on_item) {
 +  XmlReader reader;
 +  if (!reader.Load(xml)) {
 +    LOG(WARNING) << "analos: Failed to load appcast XML";
-+    return items;
++    return;
 +  }
 +
 +  // State machine for parsing
@@ -177,8 +225,13 @@ index 0000000000000..dd30f75d414ec
 +          std::map<std::string, std::string> attrs;
 +          if (reader.GetAllNodeAttributes(&attrs)) {
 +            AppcastEnclosure enclosure = ParseEnclosureFromAttributes(attrs);
-+            if (!enclosure.url.empty()) {
-+              current_item.enclosures.push_back(std::move(enclosure));
++            bool wanted = !current_platform_only ||
++                          enclosure.MatchesCurrentPlatform();
++            if (!enclosure.url.empty() && wanted) {
++              std::vector<AppcastEnclosure>& list =
++                  enclosure.delta_from.IsValid() ? current_item.deltas
++                                                 : current_item.enclosures;
++              list.push_back(std::move(enclosure));
 +            }
 +          }
 +        }
@@ -191,8 +244,10 @@ index 0000000000000..dd30f75d414ec
 +        in_item = false;
 +        if (current_item.version.IsValid() &&
 +            !current_item.enclosures.empty()) {
-+          items.push_back(std::move(current_item));
-+        } else {
++          if (!on_item(std::move(current_item))) {
++            return;  // Stop without reading the rest of the feed
++          }
++        } else if (!current_platform_only) {
 +          LOG(WARNING) << "analos: Skipping invalid appcast item (no valid "
 +                       << "version or enclosures)";
 +        }
@@ -200,9 +255,6 @@ index 0000000000000..dd30f75d414ec
 +      }
 +    }
 +  }
-+
-+  VLOG(1) << "analos: Parsed " << items.size() << " appcast items";
-+  return items;
 +}
 +
 +}  // namespace analos_server
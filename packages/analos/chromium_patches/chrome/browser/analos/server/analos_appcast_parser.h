@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/server/analos_appcast_parser.h b/chrome/browser/analos/server/analos_appcast_parser.h
 new file mode 100644
-index 0000000000000..bd996e8cb06d2
+index 0000000000000..ebfaef64aee9f
 --- /dev/null
 +++ b/chrome/browser/analos/server/analos_appcast_parser.h
-@@ -0,0 +1,88 @@
+@@ -0,0 +1,129 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -15,6 +15,7 @@ index 0000000000000..bd996e8cb06d2
 +#include <string>
 +#include <vector>
 +
++#include "base/functional/function_ref.h"
 +#include "base/time/time.h"
 +#include "base/version.h"
 +
@@ -34,7 +35,12 @@ index 0000000000000..bd996e8cb06d2
 +  std::string os;         // "macos", "linux", "windows"
 +  std::string arch;       // "arm64", "x86_64"
 +  std::string signature;  // Ed25519 signature (base64)
++  // Ed25519 signature of the package's SHA-512 digest (base64); preferred
++  // over |signature| since it can be checked without loading the package
++  std::string digest_signature;
 +  int64_t length = 0;
++  // Set on delta enclosures: the version the delta applies to
++  base::Version delta_from;
 +
 +  // Returns true if this enclosure matches the current platform and arch.
 +  bool MatchesCurrentPlatform() const;
@@ -52,9 +58,16 @@ index 0000000000000..bd996e8cb06d2
 +  base::Version version;
 +  base::Time pub_date;
 +  std::vector<AppcastEnclosure> enclosures;
++  // Optional delta packages from earlier versions (<sparkle:deltas>)
++  std::vector<AppcastEnclosure> deltas;
 +
 +  // Returns the enclosure matching the current platform, or nullptr if none.
 +  const AppcastEnclosure* GetEnclosureForCurrentPlatform() const;
++
++  // Returns the delta from |from| matching the current platform, or nullptr
++  // if none.
++  const AppcastEnclosure* GetDeltaForCurrentPlatform(
++      const base::Version& from) const;
 +};
 +
 +// Parses Sparkle-style appcast XML to extract version and download information.
@@ -70,23 +83,51 @@ index 0000000000000..bd996e8cb06d2
 +//         sparkle:os="macos"
 +//         sparkle:arch="arm64"
 +//         sparkle:edSignature="base64..."
++//         sparkle:edDigestSignature="base64..."
 +//         length="12345678"
 +//         type="application/zip"/>
++//       <sparkle:deltas>
++//         <enclosure
++//           url="https://..."
++//           sparkle:deltaFrom="0.29.0"
++//           sparkle:os="macos"
++//           sparkle:arch="arm64"
++//           sparkle:edDigestSignature="base64..."
++//           length="123456"
++//           type="application/zip"/>
++//       </sparkle:deltas>
 +//     </item>
 +//   </channel>
 +// </rss>
++//
++// Items are listed newest first. Parsing streams through the document, so
++// the ParseLatest* functions stop reading at the item they return.
 +class AnalOSAppcastParser {
 + public:
 +  // Parses the given XML string and returns the latest (first) item.
 +  // Returns std::nullopt if parsing fails or no valid items are found.
 +  static std::optional<AppcastItem> ParseLatestItem(const std::string& xml);
 +
++  // Returns the latest item with an enclosure for the current platform.
++  // Only current-platform enclosures and deltas are kept in the result, and
++  // older items are neither read nor stored, so the cost doesn't grow with
++  // the feed's history. Returns std::nullopt if no item matches.
++  static std::optional<AppcastItem> ParseLatestItemForCurrentPlatform(
++      const std::string& xml);
++
 +  // Parses all items from the appcast XML.
 +  // Returns empty vector if parsing fails.
 +  static std::vector<AppcastItem> ParseAllItems(const std::string& xml);
 +
 + private:
 +  AnalOSAppcastParser() = delete;
++
++  // Passes each valid item, in document order, to |on_item| until it returns
++  // false. With |current_platform_only|, enclosures and deltas for other
++  // platforms are dropped as they are read.
++  static void ReadItems(const std::string& xml,
++                        bool current_platform_only,
++                        base::FunctionRef<bool(AppcastItem)> on_item);
 +};
 +
 +}  // namespace analos_server
@@ -0,0 +1,37 @@
+diff --git a/chrome/browser/analos/server/analos_appcast_parser_fuzzer.cc b/chrome/browser/analos/server/analos_appcast_parser_fuzzer.cc
+new file mode 100644
+index 0000000000000..308e16a603824
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_appcast_parser_fuzzer.cc
+@@ -0,0 +1,31 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include <stddef.h>
++#include <stdint.h>
++
++#include <string>
++
++#include "base/logging.h"
++#include "chrome/browser/analos/server/analos_appcast_parser.h"
++
++namespace analos_server {
++namespace {
++
++// Parse failures are logged; keep them out of the fuzzer output
++struct Environment {
++  Environment() { logging::SetMinLogLevel(logging::LOGGING_FATAL); }
++};
++
++}  // namespace
++}  // namespace analos_server
++
++extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
++  static analos_server::Environment env;
++  std::string xml(reinterpret_cast<const char*>(data), size);
++
++  analos_server::AnalOSAppcastParser::ParseAllItems(xml);
++  analos_server::AnalOSAppcastParser::ParseLatestItemForCurrentPlatform(xml);
++  return 0;
++}
@@ -0,0 +1,116 @@
+diff --git a/chrome/browser/analos/server/analos_appcast_parser_perftest.cc b/chrome/browser/analos/server/analos_appcast_parser_perftest.cc
+new file mode 100644
+index 0000000000000..bb8d196bba011
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_appcast_parser_perftest.cc
+@@ -0,0 +1,110 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include <optional>
++#include <string>
++
++#include "base/strings/stringprintf.h"
++#include "base/timer/lap_timer.h"
++#include "chrome/browser/analos/server/analos_appcast_parser.h"
++#include "testing/gtest/include/gtest/gtest.h"
++#include "testing/perf/perf_result_reporter.h"
++
++namespace analos_server {
++namespace {
++
++constexpr int kWarmupRuns = 3;
++constexpr base::TimeDelta kTimeLimit = base::Seconds(2);
++constexpr int kTimeCheckInterval = 5;
++
++constexpr char kMetricPrefix[] = "AppcastParser.";
++constexpr char kMetricLatestItem[] = "latest_item_for_platform";
++constexpr char kMetricAllItems[] = "all_items";
++
++constexpr const char* kPlatforms[][2] = {{"macos", "arm64"},
++                                         {"macos", "x86_64"},
++                                         {"linux", "arm64"},
++                                         {"linux", "x86_64"},
++                                         {"windows", "x86_64"}};
++
++// A feed of |item_count| versions, newest first, each with a full package
++// and a delta from the previous version for every platform
++std::string BuildAppcast(int item_count) {
++  std::string xml =
++      "<rss xmlns:sparkle="
++      "\"http://www.andymatuschak.org/xml-namespaces/sparkle\"><channel>";
++  for (int i = item_count; i > 0; --i) {
++    base::StringAppendF(&xml,
++                        "<item><sparkle:version>0.%d.0</sparkle:version>"
++                        "<pubDate>Wed, 13 Nov 2025 17:30:00 -0700</pubDate>",
++                        i);
++    for (const auto& platform : kPlatforms) {
++      base::StringAppendF(
++          &xml,
++          "<enclosure url=\"https://cdn.example.com/analos-server-%s-%s-"
++          "0.%d.0.zip\" sparkle:os=\"%s\" sparkle:arch=\"%s\" "
++          "sparkle:edSignature=\"c2lnbmF0dXJl\" "
++          "sparkle:edDigestSignature=\"ZGlnZXN0\" length=\"52428800\" "
++          "type=\"application/zip\"/>",
++          platform[0], platform[1], i, platform[0], platform[1]);
++    }
++    xml += "<sparkle:deltas>";
++    for (const auto& platform : kPlatforms) {
++      base::StringAppendF(
++          &xml,
++          "<enclosure url=\"https://cdn.example.com/analos-server-%s-%s-"
++          "0.%d.0-delta.zip\" sparkle:deltaFrom=\"0.%d.0\" sparkle:os=\"%s\" "
++          "sparkle:arch=\"%s\" sparkle:edDigestSignature=\"ZGlnZXN0\" "
++          "length=\"1048576\" type=\"application/zip\"/>",
++          platform[0], platform[1], i, i - 1, platform[0], platform[1]);
++    }
++    xml += "</sparkle:deltas></item>";
++  }
++  xml += "</channel></rss>";
++  return xml;
++}
++
++perf_test::PerfResultReporter SetUpReporter(const std::string& story) {
++  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
++  reporter.RegisterImportantMetric(kMetricLatestItem, "us");
++  reporter.RegisterImportantMetric(kMetricAllItems, "us");
++  return reporter;
++}
++
++class AnalOSAppcastParserPerfTest : public testing::TestWithParam<int> {};
++
++// Parsing for the current platform stops at the newest item, so its time
++// should stay flat as the feed grows; ParseAllItems is the baseline.
++TEST_P(AnalOSAppcastParserPerfTest, ParseLargeFeed) {
++  const int item_count = GetParam();
++  const std::string xml = BuildAppcast(item_count);
++  perf_test::PerfResultReporter reporter =
++      SetUpReporter(base::StringPrintf("%d_items", item_count));
++
++  base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
++  do {
++    std::optional<AppcastItem> item =
++        AnalOSAppcastParser::ParseLatestItemForCurrentPlatform(xml);
++    ASSERT_TRUE(item);
++    EXPECT_EQ(item->version,
++              base::Version(base::StringPrintf("0.%d.0", item_count)));
++    timer.NextLap();
++  } while (!timer.HasTimeLimitExpired());
++  reporter.AddResult(kMetricLatestItem, timer.TimePerLap());
++
++  timer.Reset();
++  do {
++    EXPECT_EQ(static_cast<int>(AnalOSAppcastParser::ParseAllItems(xml).size()),
++              item_count);
++    timer.NextLap();
++  } while (!timer.HasTimeLimitExpired());
++  reporter.AddResult(kMetricAllItems, timer.TimePerLap());
++}
++
++INSTANTIATE_TEST_SUITE_P(All,
++                         AnalOSAppcastParserPerfTest,
++                         testing::Values(10, 100, 1000, 10000));
++
++}  // namespace
++}  // namespace analos_server
@@ -0,0 +1,154 @@
+diff --git a/chrome/browser/analos/server/analos_delta_update.cc b/chrome/browser/analos/server/analos_delta_update.cc
+new file mode 100644
+index 0000000000000..cccef389bc18b
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_delta_update.cc
+@@ -0,0 +1,148 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/analos/server/analos_delta_update.h"
++
++#include <optional>
++
++#include "base/files/file_util.h"
++#include "base/json/json_reader.h"
++#include "base/logging.h"
++#include "base/strings/string_number_conversions.h"
++#include "base/strings/string_util.h"
++#include "base/values.h"
++#include "build/build_config.h"
++#include "chrome/browser/analos/server/analos_package_downloader.h"
++#include "components/zucchini/zucchini.h"
++#include "components/zucchini/zucchini_integration.h"
++
++namespace analos_server {
++
++namespace {
++
++constexpr char kManifestFileName[] = "manifest.json";
++constexpr char kPatchDirectoryName[] = "patch";
++constexpr char kAddDirectoryName[] = "add";
++
++// Guards against a manifest that would be slow to parse
++constexpr size_t kMaxManifestSize = 1024 * 1024;
++
++// Rebuilds one manifest entry into |output_dir|.
++// Returns empty string on success, error message on failure.
++std::string ApplyEntry(const base::Value::Dict& entry,
++                       const base::FilePath& delta_dir,
++                       const base::FilePath& base_dir,
++                       const base::FilePath& output_dir) {
++  const std::string* path = entry.FindString("path");
++  const std::string* op = entry.FindString("op");
++  const std::string* sha512 = entry.FindString("sha512");
++  if (!path || !op || !sha512) {
++    return "Delta manifest entry is missing path, op or sha512";
++  }
++
++  // Keep every file inside the directories it belongs to
++  base::FilePath relative_path = base::FilePath::FromUTF8Unsafe(*path);
++  if (relative_path.empty() || relative_path.IsAbsolute() ||
++      relative_path.ReferencesParent()) {
++    return "Invalid path in delta manifest: " + *path;
++  }
++
++  base::FilePath output_path = output_dir.Append(relative_path);
++  if (!base::CreateDirectory(output_path.DirName())) {
++    return "Failed to create directory for " + *path;
++  }
++
++  if (*op == "copy") {
++    if (!base::CopyFile(base_dir.Append(relative_path), output_path)) {
++      return "Failed to copy " + *path + " from installed version";
++    }
++  } else if (*op == "add") {
++    base::FilePath source =
++        delta_dir.AppendASCII(kAddDirectoryName).Append(relative_path);
++    if (!base::Move(source, output_path)) {
++      return "Failed to add " + *path;
++    }
++  } else if (*op == "patch") {
++    base::FilePath patch =
++        delta_dir.AppendASCII(kPatchDirectoryName).Append(relative_path);
++    zucchini::status::Code status = zucchini::Apply(
++        base_dir.Append(relative_path), patch, output_path);
++    if (status != zucchini::status::kStatusSuccess) {
++      return "Failed to patch " + *path + " (zucchini status " +
++             base::NumberToString(static_cast<int>(status)) + ")";
++    }
++  } else {
++    return "Unknown delta operation: " + *op;
++  }
++
++  std::optional<PackageDigest> digest = ComputeFileSha512(output_path);
++  if (!digest ||
++      !base::EqualsCaseInsensitiveASCII(base::HexEncode(*digest), *sha512)) {
++    return "Checksum mismatch for " + *path;
++  }
++
++#if BUILDFLAG(IS_POSIX)
++  if (entry.FindBool("executable").value_or(false) &&
++      !base::SetPosixFilePermissions(output_path, 0755)) {
++    return "Failed to make " + *path + " executable";
++  }
++#endif
++
++  return "";  // Success
++}
++
++}  // namespace
++
++std::string ApplyDeltaPackage(const base::FilePath& delta_dir,
++                              const base::Version& base_version,
++                              const base::FilePath& base_dir,
++                              const base::FilePath& output_dir) {
++  std::string manifest_json;
++  if (!base::ReadFileToStringWithMaxSize(
++          delta_dir.AppendASCII(kManifestFileName), &manifest_json,
++          kMaxManifestSize)) {
++    return "Failed to read delta manifest";
++  }
++
++  std::optional<base::Value::Dict> manifest =
++      base::JSONReader::ReadDict(manifest_json);
++  if (!manifest) {
++    return "Invalid delta manifest";
++  }
++
++  // The appcast says which version a delta is from, but only the signed
++  // manifest is authoritative
++  const std::string* from = manifest->FindString("from");
++  base::Version from_version(from ? *from : std::string());
++  if (!from_version.IsValid() || from_version != base_version) {
++    return "Delta does not apply to installed version " +
++           base_version.GetString();
++  }
++
++  const base::Value::List* files = manifest->FindList("files");
++  if (!files || files->empty()) {
++    return "Delta manifest lists no files";
++  }
++
++  if (!base::CreateDirectory(output_dir)) {
++    return "Failed to create directory: " + output_dir.AsUTF8Unsafe();
++  }
++
++  for (const base::Value& file : *files) {
++    if (!file.is_dict()) {
++      return "Invalid delta manifest entry";
++    }
++    std::string error =
++        ApplyEntry(file.GetDict(), delta_dir, base_dir, output_dir);
++    if (!error.empty()) {
++      return error;
++    }
++  }
++
++  LOG(INFO) << "analos: Applied delta from " << base_version.GetString()
++            << " (" << files->size() << " files)";
++  return "";  // Success
++}
++
++}  // namespace analos_server
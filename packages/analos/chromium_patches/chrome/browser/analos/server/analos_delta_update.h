@@ -0,0 +1,44 @@
+diff --git a/chrome/browser/analos/server/analos_delta_update.h b/chrome/browser/analos/server/analos_delta_update.h
+new file mode 100644
+index 0000000000000..7f218d6eca89f
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_delta_update.h
+@@ -0,0 +1,38 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_ANALOS_SERVER_ANALOS_DELTA_UPDATE_H_
++#define CHROME_BROWSER_ANALOS_SERVER_ANALOS_DELTA_UPDATE_H_
++
++#include <string>
++
++#include "base/files/file_path.h"
++#include "base/version.h"
++
++namespace analos_server {
++
++// Rebuilds the resources directory of a new server version from an extracted
++// delta package and the resources of the installed (base) version.
++//
++// A delta package is a ZIP signed like a full package, containing:
++//   manifest.json  {"from": "0.29.0", "files": [
++//                    {"path": "bin/analos_server", "op": "patch",
++//                     "sha512": "<hex>", "executable": true}, ...]}
++//   patch/<path>   Zucchini patch against <path> of the base version
++//   add/<path>     Full contents of a new or rewritten file
++// Paths are relative to the resources directory. "copy" entries are taken
++// unchanged from the base version, and base files missing from the manifest
++// are dropped. Every rebuilt file must match its SHA-512 in the (signed)
++// manifest.
++//
++// Blocking; must run on a background thread. Returns empty string on
++// success, error message on failure (|output_dir| may then be partial).
++std::string ApplyDeltaPackage(const base::FilePath& delta_dir,
++                              const base::Version& base_version,
++                              const base::FilePath& base_dir,
++                              const base::FilePath& output_dir);
++
++}  // namespace analos_server
++
++#endif  // CHROME_BROWSER_ANALOS_SERVER_ANALOS_DELTA_UPDATE_H_
@@ -0,0 +1,417 @@
+diff --git a/chrome/browser/analos/server/analos_package_downloader.cc b/chrome/browser/analos/server/analos_package_downloader.cc
+new file mode 100644
+index 0000000000000..40b44feeb58d8
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_package_downloader.cc
+@@ -0,0 +1,411 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/analos/server/analos_package_downloader.h"
++
++#include <algorithm>
++#include <utility>
++#include <vector>
++
++#include "base/containers/span.h"
++#include "base/files/file.h"
++#include "base/functional/bind.h"
++#include "base/logging.h"
++#include "base/notreached.h"
++#include "base/strings/string_number_conversions.h"
++#include "base/strings/string_util.h"
++#include "base/task/sequenced_task_runner.h"
++#include "base/task/thread_pool.h"
++#include "chrome/browser/analos/server/analos_server_constants.h"
++#include "net/base/net_errors.h"
++#include "net/http/http_request_headers.h"
++#include "net/http/http_response_headers.h"
++#include "net/http/http_status_code.h"
++#include "services/network/public/cpp/resource_request.h"
++#include "services/network/public/cpp/shared_url_loader_factory.h"
++#include "services/network/public/cpp/simple_url_loader.h"
++#include "services/network/public/mojom/url_response_head.mojom.h"
++#include "third_party/boringssl/src/include/openssl/sha.h"
++#include "url/gurl.h"
++
++namespace analos_server {
++
++static_assert(std::tuple_size_v<PackageDigest> == SHA512_DIGEST_LENGTH);
++
++namespace {
++
++// Read size when hashing a file already on disk
++constexpr size_t kHashReadChunkSize = 1024 * 1024;
++
++// Feeds the rest of |file|, from its current position, into |context|.
++bool HashRemainingContents(base::File& file, SHA512_CTX* context) {
++  std::vector<uint8_t> buffer(kHashReadChunkSize);
++  while (true) {
++    std::optional<size_t> bytes_read = file.ReadAtCurrentPos(buffer);
++    if (!bytes_read) {
++      return false;
++    }
++    if (*bytes_read == 0) {
++      return true;
++    }
++    SHA512_Update(context, buffer.data(), *bytes_read);
++  }
++}
++
++// Returns the strong ETag, else the Last-Modified date, of a response.
++// Weak ETags can't be used with If-Range.
++std::string GetValidator(const net::HttpResponseHeaders& headers) {
++  std::optional<std::string> etag = headers.GetNormalizedHeader("ETag");
++  if (etag && !etag->empty() && !base::StartsWith(*etag, "W/")) {
++    return *etag;
++  }
++  return headers.GetNormalizedHeader("Last-Modified").value_or(std::string());
++}
++
++}  // namespace
++
++std::optional<PackageDigest> ComputeFileSha512(const base::FilePath& path) {
++  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
++  if (!file.IsValid()) {
++    return std::nullopt;
++  }
++
++  SHA512_CTX context;
++  SHA512_Init(&context);
++  if (!HashRemainingContents(file, &context)) {
++    return std::nullopt;
++  }
++  PackageDigest digest;
++  SHA512_Final(digest.data(), &context);
++  return digest;
++}
++
++class PackageDownloader::Writer {
++ public:
++  explicit Writer(const base::FilePath& path) : path_(path) {}
++
++  Writer(const Writer&) = delete;
++  Writer& operator=(const Writer&) = delete;
++
++  // Opens the file for appending, hashing what is already there if
++  // |resume|, or creates it empty. Returns the size kept, or -1 on failure.
++  int64_t Open(bool resume) {
++    file_.Close();
++    SHA512_Init(&context_);
++
++    if (resume) {
++      file_.Initialize(path_, base::File::FLAG_OPEN | base::File::FLAG_READ |
++                                  base::File::FLAG_WRITE);
++      if (file_.IsValid() && HashRemainingContents(file_, &context_)) {
++        return file_.GetLength();
++      }
++      // Nothing usable to resume
++      file_.Close();
++      SHA512_Init(&context_);
++    }
++
++    file_.Initialize(path_,
++                     base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
++    if (!file_.IsValid()) {
++      LOG(ERROR) << "analos: Failed to create " << path_ << ": "
++                 << base::File::ErrorToString(file_.error_details());
++      return -1;
++    }
++    return 0;
++  }
++
++  // Discards the contents, for a response that starts from the first byte
++  bool Truncate() {
++    if (!file_.IsValid() || !file_.SetLength(0) ||
++        file_.Seek(base::File::FROM_BEGIN, 0) != 0) {
++      return false;
++    }
++    SHA512_Init(&context_);
++    return true;
++  }
++
++  bool Write(const std::string& data) {
++    if (!file_.WriteAtCurrentPosAndCheck(base::as_byte_span(data))) {
++      LOG(ERROR) << "analos: Failed to write " << path_;
++      return false;
++    }
++    SHA512_Update(&context_, data.data(), data.size());
++    return true;
++  }
++
++  // Closes the file and returns the digest of everything written
++  std::optional<PackageDigest> Close() {
++    if (!file_.IsValid()) {
++      return std::nullopt;
++    }
++    file_.Close();
++    PackageDigest digest;
++    SHA512_Final(digest.data(), &context_);
++    return digest;
++  }
++
++ private:
++  const base::FilePath path_;
++  base::File file_;
++  SHA512_CTX context_;
++};
++
++PackageDownloader::Options::Options() = default;
++PackageDownloader::Options::~Options() = default;
++PackageDownloader::Options::Options(Options&&) = default;
++PackageDownloader::Options& PackageDownloader::Options::operator=(Options&&) =
++    default;
++
++PackageDownloader::PackageDownloader() = default;
++
++PackageDownloader::~PackageDownloader() = default;
++
++void PackageDownloader::Start(
++    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
++    const GURL& url,
++    const base::FilePath& path,
++    const net::NetworkTrafficAnnotationTag& traffic_annotation,
++    Options options,
++    DownloadCompleteCallback callback) {
++  options_ = std::move(options);
++  callback_ = std::move(callback);
++  resume_offset_ = 0;
++  bytes_received_ = 0;
++  validator_.clear();
++
++  writer_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
++      {base::MayBlock(), base::TaskPriority::USER_VISIBLE});
++  writer_ = std::unique_ptr<Writer, base::OnTaskRunnerDeleter>(
++      new Writer(path), base::OnTaskRunnerDeleter(writer_task_runner_));
++
++  // Deletion is posted to the same sequence, after this
++  writer_task_runner_->PostTaskAndReplyWithResult(
++      FROM_HERE,
++      base::BindOnce(&Writer::Open, base::Unretained(writer_.get()),
++                     !options_.resume_validator.empty()),
++      base::BindOnce(&PackageDownloader::OnFileOpened,
++                     weak_factory_.GetWeakPtr(), std::move(url_loader_factory),
++                     url, traffic_annotation));
++}
++
++void PackageDownloader::OnFileOpened(
++    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
++    const GURL& url,
++    const net::NetworkTrafficAnnotationTag& traffic_annotation,
++    int64_t existing_size) {
++  if (existing_size < 0) {
++    Finish(net::ERR_FAILED, std::nullopt);
++    return;
++  }
++  resume_offset_ = existing_size;
++
++  auto request = std::make_unique<network::ResourceRequest>();
++  request->url = url;
++  request->method = "GET";
++  request->credentials_mode = network::mojom::CredentialsMode::kOmit;
++  if (resume_offset_ > 0) {
++    LOG(INFO) << "analos: Resuming download at " << resume_offset_
++              << " bytes";
++    request->headers.SetHeader(
++        net::HttpRequestHeaders::kRange,
++        "bytes=" + base::NumberToString(resume_offset_) + "-");
++    // Answered with the whole body if the package changed since
++    request->headers.SetHeader(net::HttpRequestHeaders::kIfRange,
++                               options_.resume_validator);
++  }
++
++  loader_ =
++      network::SimpleURLLoader::Create(std::move(request), traffic_annotation);
++  loader_->SetTimeoutDuration(GetTimeout());
++  loader_->SetOnResponseStartedCallback(base::BindOnce(
++      &PackageDownloader::OnResponseStarted, weak_factory_.GetWeakPtr()));
++
++  // Add progress logging (visible with --vmodule=*analos*=1)
++  loader_->SetOnDownloadProgressCallback(base::BindRepeating(
++      [](int64_t offset, uint64_t current) {
++        VLOG(1) << "analos: Download progress: "
++                << ((offset + current) / 1024 / 1024) << " MB";
++      },
++      resume_offset_));
++
++  loader_->DownloadAsStream(url_loader_factory.get(), this);
++  stall_timer_.Start(FROM_HERE, kDownloadStallTimeout, this,
++                     &PackageDownloader::OnStalled);
++}
++
++base::TimeDelta PackageDownloader::GetTimeout() const {
++  if (options_.max_bytes_per_second <= 0) {
++    return kDownloadTimeout;
++  }
++  // The cap alone can stretch the transfer past the fixed timeout, so allow
++  // for the rest of the package at the capped rate
++  int64_t size = static_cast<int64_t>(kMaxUpdatePackageSize);
++  if (options_.expected_size > 0) {
++    size = std::min(size, options_.expected_size);
++  }
++  int64_t remaining = std::max<int64_t>(0, size - resume_offset_);
++  return kDownloadTimeout +
++         base::Seconds(static_cast<double>(remaining) /
++                       options_.max_bytes_per_second);
++}
++
++void PackageDownloader::OnResponseStarted(
++    const GURL& final_url,
++    const network::mojom::URLResponseHead& response_head) {
++  transfer_start_time_ = base::TimeTicks::Now();
++  stall_timer_.Reset();
++  if (!response_head.headers) {
++    return;
++  }
++  const net::HttpResponseHeaders& headers = *response_head.headers;
++
++  if (resume_offset_ > 0) {
++    int64_t first_byte = -1;
++    int64_t last_byte = -1;
++    int64_t length = -1;
++    if (headers.response_code() != net::HTTP_OK &&
++        headers.response_code() != net::HTTP_PARTIAL_CONTENT) {
++      // An error status fails the request; the partial file stays for the
++      // next attempt
++      return;
++    }
++    if (headers.response_code() == net::HTTP_OK) {
++      // The server sent the whole package. Writes are sequenced, so the
++      // file is emptied before the first chunk lands.
++      LOG(INFO) << "analos: Server did not resume the download, restarting";
++      resume_offset_ = 0;
++      writer_task_runner_->PostTask(
++          FROM_HERE, base::BindOnce(base::IgnoreResult(&Writer::Truncate),
++                                    base::Unretained(writer_.get())));
++    } else if (!headers.GetContentRangeFor206(&first_byte, &last_byte,
++                                              &length) ||
++               first_byte != resume_offset_) {
++      LOG(WARNING) << "analos: Unexpected Content-Range, discarding partial "
++                   << "download";
++      writer_task_runner_->PostTask(
++          FROM_HERE, base::BindOnce(base::IgnoreResult(&Writer::Truncate),
++                                    base::Unretained(writer_.get())));
++      Finish(net::ERR_INVALID_RESPONSE, std::nullopt);
++      return;
++    }
++  }
++
++  validator_ = GetValidator(headers);
++  if (options_.validator_callback) {
++    std::move(options_.validator_callback).Run(validator_);
++  }
++}
++
++void PackageDownloader::OnDataReceived(std::string_view string_piece,
++                                       base::OnceClosure resume) {
++  // The body waits on us until the chunk is written
++  stall_timer_.Stop();
++  bytes_received_ += string_piece.size();
++  if (resume_offset_ + bytes_received_ >
++      static_cast<int64_t>(kMaxUpdatePackageSize)) {
++    LOG(ERROR) << "analos: Update package exceeds " << kMaxUpdatePackageSize
++               << " bytes";
++    Finish(net::ERR_FILE_TOO_BIG, std::nullopt);
++    return;
++  }
++
++  writer_task_runner_->PostTaskAndReplyWithResult(
++      FROM_HERE,
++      base::BindOnce(&Writer::Write, base::Unretained(writer_.get()),
++                     std::string(string_piece)),
++      base::BindOnce(&PackageDownloader::OnChunkWritten,
++                     weak_factory_.GetWeakPtr(), std::move(resume)));
++}
++
++void PackageDownloader::OnChunkWritten(base::OnceClosure resume,
++                                       bool success) {
++  if (!success) {
++    Finish(net::ERR_FAILED, std::nullopt);
++    return;
++  }
++
++  // Hold the body back until the average rate is under the cap. The paused
++  // pipe makes the network service stop reading, which throttles the sender.
++  if (options_.max_bytes_per_second > 0) {
++    base::TimeDelta due =
++        base::Seconds(static_cast<double>(bytes_received_) /
++                      options_.max_bytes_per_second) -
++        (base::TimeTicks::Now() - transfer_start_time_);
++    if (due.is_positive()) {
++      base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
++          FROM_HERE,
++          base::BindOnce(&PackageDownloader::ResumeBody,
++                         weak_factory_.GetWeakPtr(), std::move(resume)),
++          due);
++      return;
++    }
++  }
++  ResumeBody(std::move(resume));
++}
++
++void PackageDownloader::ResumeBody(base::OnceClosure resume) {
++  stall_timer_.Start(FROM_HERE, kDownloadStallTimeout, this,
++                     &PackageDownloader::OnStalled);
++  std::move(resume).Run();
++}
++
++void PackageDownloader::OnStalled() {
++  LOG(WARNING) << "analos: No download data for " << kDownloadStallTimeout
++               << ", giving up";
++  Finish(net::ERR_TIMED_OUT, std::nullopt);
++}
++
++void PackageDownloader::OnComplete(bool success) {
++  stall_timer_.Stop();
++  if (!success) {
++    // A range the server can't satisfy won't work next time either
++    const network::mojom::URLResponseHead* response_info =
++        loader_->ResponseInfo();
++    if (response_info && response_info->headers &&
++        response_info->headers->response_code() ==
++            net::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE) {
++      writer_task_runner_->PostTask(
++          FROM_HERE, base::BindOnce(base::IgnoreResult(&Writer::Truncate),
++                                    base::Unretained(writer_.get())));
++    }
++    Finish(loader_->NetError(), std::nullopt);
++    return;
++  }
++
++  // Writes are sequenced, so this runs after the last chunk
++  writer_task_runner_->PostTaskAndReplyWithResult(
++      FROM_HERE,
++      base::BindOnce(&Writer::Close, base::Unretained(writer_.get())),
++      base::BindOnce(&PackageDownloader::OnFileClosed,
++                     weak_factory_.GetWeakPtr()));
++}
++
++void PackageDownloader::OnRetry(base::OnceClosure start_retry) {
++  NOTREACHED() << "Retries are not enabled; failed downloads are resumed";
++}
++
++void PackageDownloader::OnFileClosed(std::optional<PackageDigest> digest) {
++  Finish(digest ? net::OK : net::ERR_FAILED, std::move(digest));
++}
++
++void PackageDownloader::Finish(int net_error,
++                               std::optional<PackageDigest> digest) {
++  stall_timer_.Stop();
++  loader_.reset();
++  writer_.reset();
++  if (!callback_) {
++    return;
++  }
++
++  Result result;
++  result.net_error = net_error;
++  result.size = resume_offset_ + bytes_received_;
++  result.resumed_bytes = resume_offset_;
++  if (digest) {
++    result.sha512 = *digest;
++  }
++  std::move(callback_).Run(result);
++}
++
++}  // namespace analos_server
@@ -0,0 +1,157 @@
+diff --git a/chrome/browser/analos/server/analos_package_downloader.h b/chrome/browser/analos/server/analos_package_downloader.h
+new file mode 100644
+index 0000000000000..772d43a2d89c6
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_package_downloader.h
+@@ -0,0 +1,151 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_ANALOS_SERVER_ANALOS_PACKAGE_DOWNLOADER_H_
++#define CHROME_BROWSER_ANALOS_SERVER_ANALOS_PACKAGE_DOWNLOADER_H_
++
++#include <array>
++#include <cstdint>
++#include <memory>
++#include <optional>
++#include <string>
++#include <string_view>
++
++#include "base/files/file_path.h"
++#include "base/functional/callback.h"
++#include "base/memory/scoped_refptr.h"
++#include "base/memory/weak_ptr.h"
++#include "base/task/sequenced_task_runner.h"
++#include "base/time/time.h"
++#include "base/timer/timer.h"
++#include "net/traffic_annotation/network_traffic_annotation.h"
++#include "services/network/public/cpp/simple_url_loader_stream_consumer.h"
++
++class GURL;
++
++namespace network {
++class SharedURLLoaderFactory;
++class SimpleURLLoader;
++namespace mojom {
++class URLResponseHead;
++}  // namespace mojom
++}  // namespace network
++
++namespace analos_server {
++
++// SHA-512 digest of an update package
++using PackageDigest = std::array<uint8_t, 64>;
++
++// Computes the SHA-512 of a file in fixed-size chunks, so memory use does not
++// depend on the file size. Blocking. Returns std::nullopt if it can't be read.
++std::optional<PackageDigest> ComputeFileSha512(const base::FilePath& path);
++
++// Streams an update package to disk and hashes it (SHA-512) as the bytes
++// arrive, so verifying it needs no further pass over the file.
++//
++// Writing and hashing happen on a pool sequence. The response body is paused
++// until each chunk is written, so at most one chunk is held in memory; the
++// same pause enforces the optional bandwidth cap.
++//
++// A partial file left by an earlier attempt is resumed with an HTTP Range
++// request when the caller still has the response's validator. If the server
++// answers with the whole body instead, the file is rewritten from the start.
++class PackageDownloader : public network::SimpleURLLoaderStreamConsumer {
++ public:
++  struct Options {
++    Options();
++    ~Options();
++    Options(Options&&);
++    Options& operator=(Options&&);
++
++    // ETag or Last-Modified of the response that produced the existing
++    // file; resuming is only attempted when set (sent as If-Range)
++    std::string resume_validator;
++    // Caps the average transfer rate; 0 for no cap
++    int64_t max_bytes_per_second = 0;
++    // Advertised size of the whole package (the enclosure's length); 0 if
++    // unknown
++    int64_t expected_size = 0;
++    // Called with the response's validator once headers arrive (empty if it
++    // has none), so progress can be persisted before the body completes
++    base::OnceCallback<void(const std::string&)> validator_callback;
++  };
++
++  struct Result {
++    int net_error = 0;  // net::OK on success
++    int64_t size = 0;   // Of the whole file, including resumed bytes
++    PackageDigest sha512 = {};
++    // Bytes that were already on disk and not downloaded again
++    int64_t resumed_bytes = 0;
++  };
++  using DownloadCompleteCallback = base::OnceCallback<void(Result)>;
++
++  PackageDownloader();
++  ~PackageDownloader() override;
++
++  PackageDownloader(const PackageDownloader&) = delete;
++  PackageDownloader& operator=(const PackageDownloader&) = delete;
++
++  // Downloads |url| to |path|, resuming the existing file if
++  // |options.resume_validator| is set and replacing it otherwise. Fails with
++  // net::ERR_FILE_TOO_BIG past kMaxUpdatePackageSize. A failed download
++  // leaves the partial file for the next attempt. |callback| is not run if
++  // the downloader is destroyed first.
++  void Start(
++      scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
++      const GURL& url,
++      const base::FilePath& path,
++      const net::NetworkTrafficAnnotationTag& traffic_annotation,
++      Options options,
++      DownloadCompleteCallback callback);
++
++  // network::SimpleURLLoaderStreamConsumer:
++  void OnDataReceived(std::string_view string_piece,
++                      base::OnceClosure resume) override;
++  void OnComplete(bool success) override;
++  void OnRetry(base::OnceClosure start_retry) override;
++
++ private:
++  // Owns the file and hash state; lives on |writer_|'s pool sequence
++  class Writer;
++
++  void OnFileOpened(
++      scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
++      const GURL& url,
++      const net::NetworkTrafficAnnotationTag& traffic_annotation,
++      int64_t existing_size);
++  // Request timeout: kDownloadTimeout, plus the time the bandwidth cap
++  // needs for the rest of the package (of the largest allowed size if its
++  // size is unknown)
++  base::TimeDelta GetTimeout() const;
++  // Restarts the stall timeout and lets the body flow again
++  void ResumeBody(base::OnceClosure resume);
++  void OnStalled();
++  void OnResponseStarted(const GURL& final_url,
++                         const network::mojom::URLResponseHead& response_head);
++  void OnChunkWritten(base::OnceClosure resume, bool success);
++  void OnFileClosed(std::optional<PackageDigest> digest);
++  void Finish(int net_error, std::optional<PackageDigest> digest);
++
++  std::unique_ptr<network::SimpleURLLoader> loader_;
++  std::unique_ptr<Writer, base::OnTaskRunnerDeleter> writer_{
++      nullptr, base::OnTaskRunnerDeleter(nullptr)};
++  scoped_refptr<base::SequencedTaskRunner> writer_task_runner_;
++  Options options_;
++  // Bytes kept from an earlier attempt, and downloaded by this one
++  int64_t resume_offset_ = 0;
++  int64_t bytes_received_ = 0;
++  base::TimeTicks transfer_start_time_;
++  // Fails the download after kDownloadStallTimeout without data. Stopped
++  // while the body is paused on our side.
++  base::OneShotTimer stall_timer_;
++  std::string validator_;
++  DownloadCompleteCallback callback_;
++
++  base::WeakPtrFactory<PackageDownloader> weak_factory_{this};
++};
++
++}  // namespace analos_server
++
++#endif  // CHROME_BROWSER_ANALOS_SERVER_ANALOS_PACKAGE_DOWNLOADER_H_
@@ -0,0 +1,243 @@
+diff --git a/chrome/browser/analos/server/analos_port_allocator.cc b/chrome/browser/analos/server/analos_port_allocator.cc
+new file mode 100644
+index 0000000000000..c7b8262969330
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_port_allocator.cc
+@@ -0,0 +1,237 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/analos/server/analos_port_allocator.h"
++
++#include <utility>
++
++#include "base/barrier_callback.h"
++#include "base/functional/bind.h"
++#include "base/logging.h"
++#include "base/task/thread_pool.h"
++#include "net/base/address_family.h"
++#include "net/base/ip_address.h"
++#include "net/base/ip_endpoint.h"
++#include "net/base/port_util.h"
++#include "net/base/sockaddr_storage.h"
++#include "net/socket/socket_options.h"
++
++#if BUILDFLAG(IS_WIN)
++#include <winsock2.h>
++#else
++#include <netinet/in.h>
++#include <sys/socket.h>
++#endif
++
++namespace analos_server {
++
++namespace {
++
++constexpr int kMaxPortAttempts = 100;
++constexpr int kMaxPort = 65535;
++
++using IndexedReservation = std::pair<size_t, PortReservation>;
++
++bool IsPortUsable(int port) {
++  // Check port is in valid range
++  if (!net::IsPortValid(port) || port == 0) {
++    return false;
++  }
++
++  // Avoid well-known ports (0-1023, require elevated privileges)
++  if (net::IsWellKnownPort(port)) {
++    return false;
++  }
++
++  // Avoid restricted ports (could interfere with system services)
++  return net::IsPortAllowedForScheme(port, "http");
++}
++
++// Returns a socket bound to |address|:|port|, or an invalid one if the port
++// is in use. The platform socket is used directly: net's server sockets set
++// SO_REUSEADDR, and its descriptor could not be handed to the server.
++ScopedSocketDescriptor BindAddress(const net::IPAddress& address, int port) {
++  net::IPEndPoint endpoint(address, port);
++  ScopedSocketDescriptor socket(net::CreatePlatformSocket(
++      net::ConvertAddressFamily(endpoint.GetFamily()), SOCK_STREAM,
++      IPPROTO_TCP));
++  if (!socket.is_valid()) {
++    return ScopedSocketDescriptor();
++  }
++  // A dual-stack wildcard socket would collide with the IPv4 one
++  if (address.IsIPv6() && net::SetIPv6Only(socket.get(), true) != net::OK) {
++    return ScopedSocketDescriptor();
++  }
++  net::SockaddrStorage storage;
++  if (!endpoint.ToSockAddr(storage.addr, &storage.addr_len) ||
++      bind(socket.get(), storage.addr, storage.addr_len) != 0) {
++    return ScopedSocketDescriptor();
++  }
++  return socket;
++}
++
++IndexedReservation FindAndReservePort(size_t index,
++                                      int starting_port,
++                                      const std::set<int>& excluded_ports,
++                                      bool any_address) {
++  const net::IPAddress ipv4_address = any_address
++                                          ? net::IPAddress::IPv4AllZeros()
++                                          : net::IPAddress::IPv4Localhost();
++  const net::IPAddress ipv6_address = any_address
++                                          ? net::IPAddress::IPv6AllZeros()
++                                          : net::IPAddress::IPv6Localhost();
++  for (int i = 0; i < kMaxPortAttempts; i++) {
++    int port = starting_port + i;
++    if (port > kMaxPort) {
++      break;
++    }
++
++    // Skip ports already assigned to other AnalOS services
++    if (excluded_ports.contains(port) || !IsPortUsable(port)) {
++      continue;
++    }
++
++    ScopedSocketDescriptor ipv4_socket = BindAddress(ipv4_address, port);
++    if (!ipv4_socket.is_valid()) {
++      continue;  // IPv4 port is in use
++    }
++    ScopedSocketDescriptor ipv6_socket = BindAddress(ipv6_address, port);
++    if (!ipv6_socket.is_valid()) {
++      continue;  // IPv6 port is in use
++    }
++
++    if (port != starting_port) {
++      LOG(INFO) << "analos: Port " << starting_port
++                << " was in use or excluded, using " << port << " instead";
++    }
++    return {index, PortReservation(port, std::move(ipv4_socket),
++                                   std::move(ipv6_socket))};
++  }
++
++  LOG(WARNING) << "analos: Could not find available port after "
++               << kMaxPortAttempts << " attempts, using " << starting_port
++               << " anyway";
++  return {index, PortReservation(starting_port)};
++}
++
++void OnAllPortsReserved(PortsReservedCallback callback,
++                        std::vector<IndexedReservation> results) {
++  // Searches finish in any order
++  std::vector<PortReservation> reservations(results.size());
++  for (auto& [index, reservation] : results) {
++    reservations[index] = std::move(reservation);
++  }
++  std::move(callback).Run(std::move(reservations));
++}
++
++}  // namespace
++
++#if !BUILDFLAG(IS_POSIX)
++// static
++void SocketDescriptorTraits::Free(net::SocketDescriptor socket) {
++  closesocket(socket);
++}
++#endif
++
++PortReservation::PortReservation() = default;
++
++PortReservation::PortReservation(int port) : port_(port) {}
++
++PortReservation::PortReservation(int port,
++                                 ScopedSocketDescriptor ipv4_socket,
++                                 ScopedSocketDescriptor ipv6_socket)
++    : port_(port),
++      ipv4_socket_(std::move(ipv4_socket)),
++      ipv6_socket_(std::move(ipv6_socket)) {}
++
++#if BUILDFLAG(IS_POSIX)
++PortReservation::PortReservation(
++    int port,
++    std::vector<base::ScopedFD> listening_descriptors)
++    : port_(port), listening_descriptors_(std::move(listening_descriptors)) {}
++#endif
++
++PortReservation::PortReservation(PortReservation&&) = default;
++PortReservation& PortReservation::operator=(PortReservation&&) = default;
++PortReservation::~PortReservation() = default;
++
++bool PortReservation::is_reserved() const {
++#if BUILDFLAG(IS_POSIX)
++  if (!listening_descriptors_.empty()) {
++    return true;
++  }
++#endif
++  return ipv4_socket_.is_valid();
++}
++
++void PortReservation::Release() {
++  ipv4_socket_.reset();
++  ipv6_socket_.reset();
++#if BUILDFLAG(IS_POSIX)
++  listening_descriptors_.clear();
++#endif
++}
++
++#if BUILDFLAG(IS_POSIX)
++bool PortReservation::Listen(int backlog) {
++  if (!listening_descriptors_.empty()) {
++    return true;
++  }
++  if (!ipv4_socket_.is_valid() || !ipv6_socket_.is_valid()) {
++    return false;
++  }
++  if (listen(ipv4_socket_.get(), backlog) != 0 ||
++      listen(ipv6_socket_.get(), backlog) != 0) {
++    PLOG(WARNING) << "analos: Failed to listen on reserved port " << port_;
++    return false;
++  }
++
++  listening_descriptors_.push_back(std::move(ipv4_socket_));
++  listening_descriptors_.push_back(std::move(ipv6_socket_));
++  return true;
++}
++
++std::vector<base::ScopedFD> PortReservation::TakeListeningDescriptors(
++    int backlog) {
++  if (!Listen(backlog)) {
++    return {};
++  }
++  std::vector<base::ScopedFD> descriptors;
++  descriptors.swap(listening_descriptors_);
++  return descriptors;
++}
++#endif
++
++void ReservePorts(std::vector<int> preferred_ports,
++                  std::set<int> excluded_ports,
++                  std::set<size_t> any_address_entries,
++                  PortsReservedCallback callback) {
++  if (preferred_ports.empty()) {
++    std::move(callback).Run({});
++    return;
++  }
++
++  auto barrier = base::BarrierCallback<IndexedReservation>(
++      preferred_ports.size(),
++      base::BindOnce(&OnAllPortsReserved, std::move(callback)));
++
++  for (size_t i = 0; i < preferred_ports.size(); ++i) {
++    // Keep a search that walks past its own preference off the preferences
++    // of the others, so a free saved port stays with its service
++    std::set<int> search_excluded = excluded_ports;
++    for (size_t j = 0; j < preferred_ports.size(); ++j) {
++      if (j != i) {
++        search_excluded.insert(preferred_ports[j]);
++      }
++    }
++    base::ThreadPool::PostTaskAndReplyWithResult(
++        FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
++        base::BindOnce(&FindAndReservePort, i, preferred_ports[i],
++                       std::move(search_excluded),
++                       any_address_entries.contains(i)),
++        barrier);
++  }
++}
++
++}  // namespace analos_server
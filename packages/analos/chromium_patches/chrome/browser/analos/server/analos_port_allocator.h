@@ -0,0 +1,115 @@
+diff --git a/chrome/browser/analos/server/analos_port_allocator.h b/chrome/browser/analos/server/analos_port_allocator.h
+new file mode 100644
+index 0000000000000..61fed35faec2f
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_port_allocator.h
+@@ -0,0 +1,109 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_ANALOS_SERVER_ANALOS_PORT_ALLOCATOR_H_
++#define CHROME_BROWSER_ANALOS_SERVER_ANALOS_PORT_ALLOCATOR_H_
++
++#include <set>
++#include <vector>
++
++#include "base/functional/callback.h"
++#include "build/build_config.h"
++#include "net/socket/socket_descriptor.h"
++
++#if BUILDFLAG(IS_POSIX)
++#include "base/files/scoped_file.h"
++#else
++#include "base/scoped_generic.h"
++#endif
++
++namespace analos_server {
++
++#if BUILDFLAG(IS_POSIX)
++using ScopedSocketDescriptor = base::ScopedFD;
++#else
++struct SocketDescriptorTraits {
++  static net::SocketDescriptor InvalidValue() { return net::kInvalidSocket; }
++  static void Free(net::SocketDescriptor socket);
++};
++using ScopedSocketDescriptor =
++    base::ScopedGeneric<net::SocketDescriptor, SocketDescriptorTraits>;
++#endif
++
++// A local port held by bound (not listening) IPv4 and IPv6 sockets, so no
++// other process or allocation can take it until it is released. The sockets
++// are bound to the loopback addresses, or to all interfaces for a port that
++// must be reachable from other machines.
++//
++// Binding happens without SO_REUSEADDR, which would let the bind succeed
++// while another socket holds the port on 0.0.0.0 (especially on macOS).
++class PortReservation {
++ public:
++  PortReservation();
++  // Unreserved placeholder for |port|, used when no free port was found
++  explicit PortReservation(int port);
++  PortReservation(int port,
++                  ScopedSocketDescriptor ipv4_socket,
++                  ScopedSocketDescriptor ipv6_socket);
++#if BUILDFLAG(IS_POSIX)
++  // Wraps sockets that already listen on |port| (IPv4 first)
++  PortReservation(int port, std::vector<base::ScopedFD> listening_descriptors);
++#endif
++  PortReservation(PortReservation&&);
++  PortReservation& operator=(PortReservation&&);
++  ~PortReservation();
++
++  int port() const { return port_; }
++  bool is_reserved() const;
++
++  // Closes the sockets so the port can be bound by its real owner
++  void Release();
++
++#if BUILDFLAG(IS_POSIX)
++  // Puts both sockets into listening state, so connections queue until the
++  // serving process accepts them. Does nothing if already listening. Returns
++  // false, leaving the reservation intact, if the port is not reserved or
++  // listening fails.
++  bool Listen(int backlog);
++
++  // Descriptors of the listening sockets (IPv4 first); empty before Listen()
++  const std::vector<base::ScopedFD>& listening_descriptors() const {
++    return listening_descriptors_;
++  }
++
++  // Listen()s and gives up the descriptors (IPv4 first), for passing to the
++  // process that serves the port. Returns an empty vector if Listen() fails.
++  std::vector<base::ScopedFD> TakeListeningDescriptors(int backlog);
++#endif
++
++ private:
++  int port_ = 0;
++  // Bound sockets, owned directly so they can be handed to another process
++  ScopedSocketDescriptor ipv4_socket_;
++  ScopedSocketDescriptor ipv6_socket_;
++#if BUILDFLAG(IS_POSIX)
++  // Replaces the sockets once listening
++  std::vector<base::ScopedFD> listening_descriptors_;
++#endif
++};
++
++using PortsReservedCallback =
++    base::OnceCallback<void(std::vector<PortReservation>)>;
++
++// Reserves one port per entry of |preferred_ports|: the first usable port at
++// or above the preference that is not in |excluded_ports| or another entry's
++// preference. The searches run concurrently on the thread pool and cannot
++// hand out the same port twice, since each holds its bind while the others
++// probe. Entries whose index is in |any_address_entries| are bound to all
++// interfaces instead of loopback. Reservations are
++// returned in the order of |preferred_ports|; an entry whose search found
++// nothing is an unreserved placeholder for the preferred port.
++void ReservePorts(std::vector<int> preferred_ports,
++                  std::set<int> excluded_ports,
++                  std::set<size_t> any_address_entries,
++                  PortsReservedCallback callback);
++
++}  // namespace analos_server
++
++#endif  // CHROME_BROWSER_ANALOS_SERVER_ANALOS_PORT_ALLOCATOR_H_
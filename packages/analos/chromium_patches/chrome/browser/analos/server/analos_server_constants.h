@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/server/analos_server_constants.h b/chrome/browser/analos/server/analos_server_constants.h
 new file mode 100644
-index 0000000000000..d2c8229f8c805
+index 0000000000000..75b5cfa8da27c
 --- /dev/null
 +++ b/chrome/browser/analos/server/analos_server_constants.h
-@@ -0,0 +1,52 @@
+@@ -0,0 +1,72 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -24,6 +24,10 @@ index 0000000000000..d2c8229f8c805
 +// Interval between update checks
 +inline constexpr base::TimeDelta kUpdateCheckInterval = base::Minutes(15);
 +
++// Fraction by which each update check interval is randomly lengthened or
++// shortened, so that browsers started together don't check together
++inline constexpr double kUpdateCheckJitter = 0.2;
++
 +// Ed25519 public key for signature verification (base64-encoded)
 +// This key verifies the authenticity of downloaded server binaries.
 +inline constexpr char kServerUpdatePublicKey[] =
@@ -32,9 +36,18 @@ index 0000000000000..d2c8229f8c805
 +// Maximum number of old versions to keep in the versions directory
 +inline constexpr int kMaxVersionsToKeep = 2;
 +
-+// Timeout for downloading update packages
++// Timeout for downloading update packages, extended by the time a bandwidth
++// cap needs for the package
 +inline constexpr base::TimeDelta kDownloadTimeout = base::Minutes(10);
 +
++// A download that receives no data for this long fails, whatever the
++// overall timeout
++inline constexpr base::TimeDelta kDownloadStallTimeout = base::Seconds(60);
++
++// Download attempts per update check; each failed one is retried with
++// exponential backoff, resuming the partial file
++inline constexpr int kMaxDownloadAttempts = 5;
++
 +// Timeout for fetching appcast XML
 +inline constexpr base::TimeDelta kAppcastFetchTimeout = base::Seconds(30);
 +
@@ -52,6 +65,13 @@ index 0000000000000..d2c8229f8c805
 +inline constexpr char kCurrentVersionFileName[] = "current_version";
 +inline constexpr char kPendingUpdateDirectoryName[] = "pending_update";
 +inline constexpr char kDownloadFileName[] = "download.zip";
++// Under the pending update directory; renamed to versions/{version}
++inline constexpr char kExtractStagingDirectoryName[] = "staging";
++// Under the pending update directory; the extracted delta package
++inline constexpr char kDeltaDirectoryName[] = "delta";
++// Signed version manifest in a resources directory, and its signature
++inline constexpr char kVersionManifestFileName[] = "version.json";
++inline constexpr char kVersionManifestSignatureFileName[] = "version.json.sig";
 +
 +}  // namespace analos_server
 +
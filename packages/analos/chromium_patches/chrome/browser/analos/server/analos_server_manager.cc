@@ -1,29 +1,40 @@
 diff --git a/chrome/browser/analos/server/analos_server_manager.cc b/chrome/browser/analos/server/analos_server_manager.cc
 new file mode 100644
-index 0000000000000..dab79743c4753
+index 0000000000000..da75e3c8199c7
 --- /dev/null
 +++ b/chrome/browser/analos/server/analos_server_manager.cc
-@@ -0,0 +1,1190 @@
+@@ -0,0 +1,1898 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
 +
 +#include "chrome/browser/analos/server/analos_server_manager.h"
 +
++#include <algorithm>
++#include <iterator>
 +#include <optional>
-+#include <set>
++#include <string>
 +
++#include "base/check_op.h"
 +#include "base/command_line.h"
 +#include "base/files/file_path.h"
 +#include "base/files/file_util.h"
++#include "base/files/scoped_file.h"
++#include "base/functional/bind.h"
++#include "base/functional/callback_helpers.h"
++#include "base/json/json_reader.h"
 +#include "base/json/json_writer.h"
 +#include "base/logging.h"
++#include "base/metrics/histogram_macros_local.h"
 +#include "base/path_service.h"
 +#include "base/process/kill.h"
 +#include "base/process/launch.h"
++#include "base/process/process_metrics.h"
 +#include "base/rand_util.h"
 +#include "base/strings/string_number_conversions.h"
++#include "base/strings/string_util.h"
 +#include "base/system/sys_info.h"
++#include "base/task/sequenced_task_runner.h"
 +#include "base/task/thread_pool.h"
 +#include "base/threading/thread_restrictions.h"
 +#include "build/build_config.h"
@@ -31,6 +42,11 @@ index 0000000000000..dab79743c4753
 +
 +#if BUILDFLAG(IS_POSIX)
 +#include <signal.h>
++#include <sys/socket.h>
++#include <unistd.h>
++
++#include "base/files/file_descriptor_watcher_posix.h"
++#include "base/posix/eintr_wrapper.h"
 +#endif
 +
 +#include "chrome/browser/analos/core/analos_switches.h"
@@ -48,37 +64,69 @@ index 0000000000000..dab79743c4753
 +#include "content/public/browser/devtools_agent_host.h"
 +#include "content/public/browser/devtools_socket_factory.h"
 +#include "content/public/browser/storage_partition.h"
-+#include "net/base/address_family.h"
-+#include "net/base/ip_address.h"
 +#include "net/base/ip_endpoint.h"
 +#include "net/base/net_errors.h"
 +#include "net/base/port_util.h"
++#include "net/base/sockaddr_storage.h"
++#include "net/http/http_response_headers.h"
 +#include "net/log/net_log_source.h"
 +#include "net/socket/tcp_server_socket.h"
-+#include "net/socket/tcp_socket.h"
 +#include "net/traffic_annotation/network_traffic_annotation.h"
 +#include "services/network/public/cpp/resource_request.h"
 +#include "services/network/public/cpp/simple_url_loader.h"
 +#include "services/network/public/mojom/url_loader_factory.mojom.h"
++#include "services/network/public/mojom/url_response_head.mojom.h"
 +#include "url/gurl.h"
 +
 +namespace {
 +
 +constexpr int kBackLog = 10;
-+constexpr base::FilePath::CharType kConfigFileName[] =
-+    FILE_PATH_LITERAL("server_config.json");
 +
-+constexpr base::TimeDelta kHealthCheckInterval = base::Seconds(30);
-+constexpr base::TimeDelta kHealthCheckTimeout = base::Seconds(15);
-+constexpr base::TimeDelta kProcessCheckInterval = base::Seconds(10);
++#if BUILDFLAG(IS_POSIX)
++// Socket activation: inherited listeners start at this descriptor and are
++// named for LISTEN_FDNAMES, two per reservation (IPv4 then IPv6) in this
++// order. A standby gets a fourth, private port on which only it answers
++// /health.
++constexpr int kListenFdsStart = 3;
++constexpr const char* kListenFdServiceNames[] = {"mcp", "agent", "extension",
++                                                 "health"};
++#endif
++// Config files of the current process and of a standby, which swap roles on
++// every blue/green switch
++constexpr const base::FilePath::CharType* kConfigFileNames[] = {
++    FILE_PATH_LITERAL("server_config.json"),
++    FILE_PATH_LITERAL("server_config.alt.json")};
++
++// Exits are reported by the process watchers, so health checks only have to
++// catch hangs. A hung server is restarted after kMaxHealthCheckFailures
++// consecutive failures, i.e. within about 15 s.
++constexpr base::TimeDelta kHealthCheckInterval = base::Seconds(5);
++constexpr base::TimeDelta kHealthCheckTimeout = base::Seconds(2);
++constexpr int kMaxHealthCheckFailures = 2;
++
++// Telemetry: how often the server's resource usage is sampled, and how many
++// recent health-check round trips the latency percentiles cover
++constexpr base::TimeDelta kProcessSampleInterval = base::Seconds(30);
++constexpr size_t kMaxHealthLatencySamples = 120;
++
++// /health answers are small JSON objects. For on-demand mode the server
++// reports its open connections and in-flight requests in them, excluding
++// the health check itself.
++constexpr size_t kMaxHealthResponseSize = 16 * 1024;
++constexpr char kHealthOpenConnectionsKey[] = "openConnections";
++constexpr char kHealthInFlightRequestsKey[] = "inFlightRequests";
++
++// Blue/green restarts: how long the standby process may take to answer
++// /health on its private port, how often it is polled, and how long the old
++// process keeps serving in-flight requests after the switch
++constexpr base::TimeDelta kStandbyReadyTimeout = base::Seconds(30);
++constexpr base::TimeDelta kStandbyPollInterval = base::Milliseconds(250);
++constexpr base::TimeDelta kDrainPeriod = base::Seconds(5);
 +
 +// Crash tracking: if server crashes within grace period, count as startup failure
 +constexpr base::TimeDelta kStartupGracePeriod = base::Seconds(30);
 +constexpr int kMaxStartupFailures = 3;
 +
-+constexpr int kMaxPortAttempts = 100;
-+constexpr int kMaxPort = 65535;
-+
 +// Holds configuration data gathered on UI thread, passed to background thread
 +struct ServerConfig {
 +  std::string install_id;
@@ -90,6 +138,7 @@ index 0000000000000..dab79743c4753
 +// Writes the server configuration to a JSON file.
 +// Returns the path to the config file on success, empty path on failure.
 +base::FilePath WriteConfigJson(const base::FilePath& execution_dir,
++                               size_t config_slot,
 +                               const base::FilePath& resources_dir,
 +                               uint16_t cdp_port,
 +                               uint16_t mcp_port,
@@ -97,7 +146,7 @@ index 0000000000000..dab79743c4753
 +                               uint16_t extension_port,
 +                               const ServerConfig& server_config) {
 +  base::FilePath config_path =
-+      execution_dir.Append(kConfigFileName);
++      execution_dir.Append(kConfigFileNames[config_slot]);
 +
 +  base::Value::Dict config;
 +
@@ -179,21 +228,77 @@ index 0000000000000..dab79743c4753
 +  return port;
 +}
 +
++#if BUILDFLAG(IS_POSIX)
++// Moves the listeners of |reservations| into |options| as inherited
++// descriptors plus the LISTEN_FDS/LISTEN_FDNAMES environment. The returned
++// descriptors must stay open until the process is launched. Returns an empty
++// vector, leaving |options| untouched, unless every port can be handed over.
++std::vector<base::ScopedFD> AddInheritedListeners(
++    std::vector<analos_server::PortReservation>& reservations,
++    base::LaunchOptions& options) {
++  CHECK_LE(reservations.size(), std::size(kListenFdServiceNames));
++  std::vector<base::ScopedFD> descriptors;
++  std::vector<std::string> names;
++  for (size_t i = 0; i < reservations.size(); ++i) {
++    analos_server::PortReservation& reservation = reservations[i];
++    std::vector<base::ScopedFD> taken =
++        reservation.TakeListeningDescriptors(kBackLog);
++    if (taken.empty()) {
++      LOG(WARNING) << "analos: Port " << reservation.port()
++                   << " is not reserved, server will bind its own ports";
++      return {};
++    }
++    for (auto& fd : taken) {
++      descriptors.push_back(std::move(fd));
++      names.push_back(kListenFdServiceNames[i]);
++    }
++  }
++
++  for (size_t i = 0; i < descriptors.size(); ++i) {
++    options.fds_to_remap.emplace_back(descriptors[i].get(),
++                                      kListenFdsStart + static_cast<int>(i));
++  }
++  options.environment["LISTEN_FDS"] = base::NumberToString(descriptors.size());
++  options.environment["LISTEN_FDNAMES"] = base::JoinString(names, ":");
++  LOG(INFO) << "analos: Passing " << descriptors.size()
++            << " listening sockets to server";
++  return descriptors;
++}
++#endif
++
++#if BUILDFLAG(IS_POSIX)
++// Whether the listening socket |fd| is bound to a loopback address
++bool IsLoopbackListener(int fd) {
++  net::SockaddrStorage storage;
++  net::IPEndPoint endpoint;
++  if (getsockname(fd, storage.addr, &storage.addr_len) != 0 ||
++      !endpoint.FromSockAddr(storage.addr, storage.addr_len)) {
++    return true;
++  }
++  return endpoint.address().IsLoopback();
++}
++#endif
++
 +// Launches the AnalOS server process on a background thread.
 +// This function performs blocking I/O operations (PathExists, WriteConfigToml,
 +// LaunchProcess).
 +// If the primary exe_path doesn't exist, falls back to fallback_exe_path.
++// With |socket_activation|, the reserved ports are passed to the server as
++// listening sockets rather than released for it to bind.
 +analos::AnalOSServerManager::LaunchResult LaunchProcessOnBackgroundThread(
 +    const base::FilePath& exe_path,
 +    const base::FilePath& resources_dir,
 +    const base::FilePath& fallback_exe_path,
 +    const base::FilePath& fallback_resources_dir,
 +    const base::FilePath& execution_dir,
++    size_t config_slot,
 +    uint16_t cdp_port,
 +    uint16_t mcp_port,
 +    uint16_t agent_port,
 +    uint16_t extension_port,
-+    const ServerConfig& server_config) {
++    const ServerConfig& server_config,
++    std::vector<analos_server::PortReservation> reservations,
++    bool socket_activation) {
 +  analos::AnalOSServerManager::LaunchResult result;
 +  base::FilePath actual_exe_path = exe_path;
 +  base::FilePath actual_resources_dir = resources_dir;
@@ -227,8 +332,8 @@ index 0000000000000..dab79743c4753
 +
 +  // Write configuration to JSON file
 +  base::FilePath config_path = WriteConfigJson(
-+      execution_dir, actual_resources_dir, cdp_port, mcp_port, agent_port,
-+      extension_port, server_config);
++      execution_dir, config_slot, actual_resources_dir, cdp_port, mcp_port,
++      agent_port, extension_port, server_config);
 +  if (config_path.empty()) {
 +    LOG(ERROR) << "analos: Failed to write config file, aborting launch";
 +    return result;
@@ -250,11 +355,91 @@ index 0000000000000..dab79743c4753
 +  options.start_hidden = true;
 +#endif
 +
++#if BUILDFLAG(IS_POSIX)
++  // Kept open in this process while the server runs, for a standby
++  std::vector<base::ScopedFD> inherited_listeners;
++  if (socket_activation) {
++    inherited_listeners = AddInheritedListeners(reservations, options);
++  }
++#endif
++
++  // Hold the ports until the last moment so nothing else binds them between
++  // discovery and the server starting up
++  for (auto& reservation : reservations) {
++    reservation.Release();
++  }
++
 +  // Launch the process (blocking I/O)
 +  result.process = base::LaunchProcess(cmd, options);
++#if BUILDFLAG(IS_POSIX)
++  if (result.process.IsValid()) {
++    result.listeners = std::move(inherited_listeners);
++  }
++#endif
 +  return result;
 +}
 +
++// Reads the resource usage of |process|. Runs on a worker.
++analos::AnalOSServerManager::ProcessSample SampleProcessOnBackgroundThread(
++    base::Process process) {
++  analos::AnalOSServerManager::ProcessSample sample;
++#if BUILDFLAG(IS_MAC)
++  // Without a port provider, memory is unavailable for another process
++  auto metrics =
++      base::ProcessMetrics::CreateProcessMetrics(process.Handle(), nullptr);
++#else
++  auto metrics = base::ProcessMetrics::CreateProcessMetrics(process.Handle());
++#endif
++
++  if (auto memory = metrics->GetMemoryInfo(); memory.has_value()) {
++    sample.resident_set_bytes = memory->resident_set_bytes;
++  }
++  if (auto cpu_time = metrics->GetCumulativeCPUUsage(); cpu_time.has_value()) {
++    sample.cpu_time = cpu_time.value();
++  }
++#if BUILDFLAG(IS_POSIX)
++  int open_fds = metrics->GetOpenFdCount();
++  if (open_fds >= 0) {
++    sample.open_fd_count = open_fds;
++  }
++#endif
++  return sample;
++}
++
++// Sum of the activity counts in a /health response body, or nullopt if the
++// server does not report them
++std::optional<int> ParseHealthActivity(const std::string& body) {
++  std::optional<base::Value::Dict> health = base::JSONReader::ReadDict(body);
++  if (!health) {
++    return std::nullopt;
++  }
++  std::optional<int> connections =
++      health->FindInt(kHealthOpenConnectionsKey);
++  std::optional<int> requests = health->FindInt(kHealthInFlightRequestsKey);
++  if (!connections && !requests) {
++    return std::nullopt;
++  }
++  return std::max(0, connections.value_or(0)) +
++         std::max(0, requests.value_or(0));
++}
++
++// Returns the |percentile| (0-100) of sorted |values|
++base::TimeDelta Percentile(const std::vector<base::TimeDelta>& values,
++                           size_t percentile) {
++  return values[(values.size() - 1) * percentile / 100];
++}
++
++// Blocks until |process| exits and reaps it. Runs in a pool task of its
++// own for each process.
++int WaitForProcessExit(base::Process process) {
++  int exit_code = -1;
++  if (!process.WaitForExit(&exit_code)) {
++    LOG(WARNING) << "analos: WaitForExit failed for PID " << process.Pid();
++  }
++  return exit_code;
++}
++
++
 +// Factory for creating TCP server sockets for CDP
 +class CDPServerSocketFactory : public content::DevToolsSocketFactory {
 + public:
@@ -294,12 +479,66 @@ index 0000000000000..dab79743c4753
 +
 +namespace analos {
 +
++#if BUILDFLAG(IS_POSIX)
++// Watches the listeners of a dormant server for the first queued connection
++// and hands the reservations back. The connection is left in the backlog
++// for the server to accept. Runs on a pool sequence, which provides the
++// FileDescriptorWatcher.
++class AnalOSServerManager::ConnectionWaiter {
++ public:
++  using ConnectionCallback = base::OnceCallback<void(
++      std::vector<analos_server::PortReservation> reservations)>;
++
++  // |on_connection| runs on the constructing sequence
++  explicit ConnectionWaiter(ConnectionCallback on_connection)
++      : reply_task_runner_(base::SequencedTaskRunner::GetCurrentDefault()),
++        on_connection_(std::move(on_connection)) {}
++
++  ConnectionWaiter(const ConnectionWaiter&) = delete;
++  ConnectionWaiter& operator=(const ConnectionWaiter&) = delete;
++
++  void Watch(std::vector<analos_server::PortReservation> reservations) {
++    reservations_ = std::move(reservations);
++    for (const auto& reservation : reservations_) {
++      for (const auto& fd : reservation.listening_descriptors()) {
++        watchers_.push_back(base::FileDescriptorWatcher::WatchReadable(
++            fd.get(), base::BindRepeating(&ConnectionWaiter::OnReadable,
++                                          base::Unretained(this))));
++      }
++    }
++  }
++
++ private:
++  void OnReadable() {
++    watchers_.clear();
++    if (on_connection_) {
++      reply_task_runner_->PostTask(
++          FROM_HERE,
++          base::BindOnce(std::move(on_connection_), std::move(reservations_)));
++    }
++  }
++
++  scoped_refptr<base::SequencedTaskRunner> reply_task_runner_;
++  ConnectionCallback on_connection_;
++  // Declared before |watchers_| so the descriptors outlive the watches
++  std::vector<analos_server::PortReservation> reservations_;
++  std::vector<std::unique_ptr<base::FileDescriptorWatcher::Controller>>
++      watchers_;
++};
++#endif
++
 +// static
 +AnalOSServerManager* AnalOSServerManager::GetInstance() {
 +  static base::NoDestructor<AnalOSServerManager> instance;
 +  return instance.get();
 +}
 +
++AnalOSServerManager::LaunchResult::LaunchResult() = default;
++AnalOSServerManager::LaunchResult::LaunchResult(LaunchResult&&) = default;
++AnalOSServerManager::LaunchResult&
++AnalOSServerManager::LaunchResult::operator=(LaunchResult&&) = default;
++AnalOSServerManager::LaunchResult::~LaunchResult() = default;
++
 +AnalOSServerManager::AnalOSServerManager() = default;
 +
 +AnalOSServerManager::~AnalOSServerManager() {
@@ -341,8 +580,7 @@ index 0000000000000..dab79743c4753
 +  return true;
 +}
 +
-+void AnalOSServerManager::InitializePortsAndPrefs() {
-+  base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
++void AnalOSServerManager::ReadPrefs() {
 +  PrefService* prefs = g_browser_process->local_state();
 +
 +  // Read from prefs or use defaults
@@ -352,6 +590,7 @@ index 0000000000000..dab79743c4753
 +    agent_port_ = analos_server::kDefaultAgentPort;
 +    extension_port_ = analos_server::kDefaultExtensionPort;
 +    allow_remote_in_mcp_ = false;
++    idle_timeout_ = base::TimeDelta();
 +  } else {
 +    cdp_port_ = prefs->GetInteger(analos_server::kCDPServerPort);
 +    if (cdp_port_ <= 0) {
@@ -374,6 +613,8 @@ index 0000000000000..dab79743c4753
 +    }
 +
 +    allow_remote_in_mcp_ = prefs->GetBoolean(analos_server::kAllowRemoteInMCP);
++    idle_timeout_ = base::Seconds(
++        std::max(0, prefs->GetInteger(analos_server::kServerIdleTimeout)));
 +
 +    // Set up pref change observers
 +    if (!pref_change_registrar_) {
@@ -391,49 +632,93 @@ index 0000000000000..dab79743c4753
 +              base::Unretained(this)));
 +    }
 +  }
++}
 +
-+  // Find available ports, tracking assigned ports to prevent collisions
-+  std::set<int> assigned_ports;
-+
-+  cdp_port_ = FindAvailablePort(cdp_port_, assigned_ports);
-+  assigned_ports.insert(cdp_port_);
-+
-+  mcp_port_ = FindAvailablePort(mcp_port_, assigned_ports);
-+  assigned_ports.insert(mcp_port_);
-+
-+  agent_port_ = FindAvailablePort(agent_port_, assigned_ports);
-+  assigned_ports.insert(agent_port_);
++void AnalOSServerManager::OnStartupPortsReserved(
++    std::vector<analos_server::PortReservation> reservations) {
++  is_starting_ = false;
++  base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
 +
-+  extension_port_ = FindAvailablePort(extension_port_, assigned_ports);
++  // Reservations are in request order: CDP, MCP, Agent, Extension
++  cdp_port_ = reservations[0].port();
++  mcp_port_ = reservations[1].port();
++  agent_port_ = reservations[2].port();
++  extension_port_ = reservations[3].port();
 +
-+  // Apply command-line overrides (internal testing only)
++  // Apply command-line overrides (internal testing only). Overridden ports
++  // are used as given, without a reservation.
 +  int cdp_override = GetPortOverrideFromCommandLine(
 +      command_line, analos::kCDPPort, "CDP port");
 +  if (cdp_override > 0) {
 +    cdp_port_ = cdp_override;
++    reservations[0] = analos_server::PortReservation(cdp_override);
 +  }
 +
 +  int mcp_override = GetPortOverrideFromCommandLine(
 +      command_line, analos::kMCPPort, "MCP port");
 +  if (mcp_override > 0) {
 +    mcp_port_ = mcp_override;
++    reservations[1] = analos_server::PortReservation(mcp_override);
 +  }
 +
 +  int agent_override = GetPortOverrideFromCommandLine(
 +      command_line, analos::kAgentPort, "Agent port");
 +  if (agent_override > 0) {
 +    agent_port_ = agent_override;
++    reservations[2] = analos_server::PortReservation(agent_override);
 +  }
 +
 +  int extension_override = GetPortOverrideFromCommandLine(
 +      command_line, analos::kExtensionPort, "Extension port");
 +  if (extension_override > 0) {
 +    extension_port_ = extension_override;
++    reservations[3] = analos_server::PortReservation(extension_override);
 +  }
 +
 +  LOG(INFO) << "analos: Final ports - CDP: " << cdp_port_
 +            << ", MCP: " << mcp_port_ << ", Agent: " << agent_port_
 +            << ", Extension: " << extension_port_;
++
++  // Even with analos-server disabled we want to update the prefs from CLI
++  SavePortsToPrefs();
++
++  if (command_line->HasSwitch(analos::kDisableServer)) {
++    LOG(INFO) << "analos: AnalOS server disabled via command line";
++    return;
++  }
++
++#if BUILDFLAG(IS_POSIX)
++  socket_activation_ = command_line->HasSwitch(analos::kServerSocketActivation);
++  // The first connection is queued on our listeners, so only a server that
++  // inherits them can pick it up
++  on_demand_ = socket_activation_ && idle_timeout_.is_positive();
++#endif
++  if (idle_timeout_.is_positive() && !on_demand_) {
++    LOG(WARNING) << "analos: On-demand start needs socket activation, "
++                 << "launching server now";
++  }
++
++  // Try to acquire system-wide lock
++  if (!AcquireLock()) {
++    return;  // Another Chrome process already owns the server
++  }
++
++  LOG(INFO) << "analos: Starting AnalOS server";
++
++  // Chrome's DevTools server binds the CDP port itself
++  reservations[0].Release();
++  reservations.erase(reservations.begin());
++
++  // Start servers and process
++  // Note: monitoring timers are started in OnProcessLaunched() after successful launch
++  StartCDPServer();
++#if BUILDFLAG(IS_POSIX)
++  if (on_demand_) {
++    EnterDormant(std::move(reservations));
++    return;
++  }
++#endif
++  LaunchAnalOSProcess(std::move(reservations));
 +}
 +
 +void AnalOSServerManager::SavePortsToPrefs() {
@@ -454,52 +739,59 @@ index 0000000000000..dab79743c4753
 +}
 +
 +void AnalOSServerManager::Start() {
-+  if (is_running_) {
++  if (is_running_ || is_starting_ || is_dormant_ || launch_pending_) {
 +    LOG(INFO) << "analos: AnalOS server already running";
 +    return;
 +  }
++  is_starting_ = true;
 +
-+  base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
-+  // Initialize and finalize ports, even with analos-server disabled
-+  // we want to update the prefs from CLI
-+  InitializePortsAndPrefs();
-+  SavePortsToPrefs();
-+
-+  if (command_line->HasSwitch(analos::kDisableServer)) {
-+    LOG(INFO) << "analos: AnalOS server disabled via command line";
-+    return;
-+  }
++  ReadPrefs();
 +
-+  // Try to acquire system-wide lock
-+  if (!AcquireLock()) {
-+    return;  // Another Chrome process already owns the server
-+  }
-+
-+  LOG(INFO) << "analos: Starting AnalOS server";
-+
-+  // Start servers and process
-+  // Note: monitoring timers are started in OnProcessLaunched() after successful launch
-+  StartCDPServer();
-+  LaunchAnalOSProcess();
++  // All four ports are probed at once and stay bound until they are handed
++  // to their servers
++  analos_server::ReservePorts(
++      {cdp_port_, mcp_port_, agent_port_, extension_port_}, {},
++      McpAnyAddressEntry(1),
++      base::BindOnce(&AnalOSServerManager::OnStartupPortsReserved,
++                     startup_weak_factory_.GetWeakPtr()));
 +}
 +
 +void AnalOSServerManager::Stop() {
-+  if (!is_running_) {
++  if (!is_running_ && !is_dormant_ && !is_starting_ && !is_restarting_ &&
++      !launch_pending_) {
 +    return;
 +  }
 +
++  // A port search still running for Start() is dropped, releasing its
++  // reservations, and a launch in flight is killed once it reports back
++  startup_weak_factory_.InvalidateWeakPtrs();
++  is_starting_ = false;
++  launch_pending_ = false;
++
 +  LOG(INFO) << "analos: Stopping AnalOS server";
 +  health_check_timer_.Stop();
-+  process_check_timer_.Stop();
++  process_sample_timer_.Stop();
++  AbandonStandby();
++  RetireOldProcess();
++#if BUILDFLAG(IS_POSIX)
++  connection_waiter_.reset();
++  listeners_.clear();
++#endif
++  is_dormant_ = false;
 +
 +  // Stop the updater
 +  if (updater_) {
 +    updater_->Stop();
 +    updater_.reset();
 +  }
++  is_restarting_ = false;
++  is_updating_ = false;
++  update_complete_callback_.Reset();
++  after_exit_.Reset();
 +
-+  // Use wait=false for shutdown - just send kill signal, don't block UI thread
-+  TerminateAnalOSProcess(/*wait=*/false);
++  // Only signals; the watcher reaps the process without blocking the UI
++  // thread
++  TerminateAnalOSProcess();
 +
 +  // Release lock
 +  if (lock_file_.IsValid()) {
@@ -544,7 +836,20 @@ index 0000000000000..dab79743c4753
 +  cdp_port_ = 0;
 +}
 +
-+void AnalOSServerManager::LaunchAnalOSProcess() {
++void AnalOSServerManager::LaunchAnalOSProcess(
++    std::vector<analos_server::PortReservation> reservations) {
++  launch_pending_ = true;
++  LaunchServerProcess({mcp_port_, agent_port_, extension_port_}, config_slot_,
++                      std::move(reservations),
++                      base::BindOnce(&AnalOSServerManager::OnProcessLaunched,
++                                     weak_factory_.GetWeakPtr()));
++}
++
++void AnalOSServerManager::LaunchServerProcess(
++    const RevalidatedPorts& ports,
++    size_t config_slot,
++    std::vector<analos_server::PortReservation> reservations,
++    base::OnceCallback<void(LaunchResult)> callback) {
 +  // Bundled paths (always available as fallback)
 +  base::FilePath fallback_exe_path = GetAnalOSServerExecutablePath();
 +  base::FilePath fallback_resources_dir = GetAnalOSServerResourcesPath();
@@ -563,6 +868,7 @@ index 0000000000000..dab79743c4753
 +  base::FilePath execution_dir = GetAnalOSExecutionDir();
 +  if (execution_dir.empty()) {
 +    LOG(ERROR) << "analos: Failed to resolve execution directory";
++    std::move(callback).Run(LaunchResult());
 +    return;
 +  }
 +
@@ -572,9 +878,9 @@ index 0000000000000..dab79743c4753
 +
 +  // Capture values to pass to background thread
 +  uint16_t cdp_port = cdp_port_;
-+  uint16_t mcp_port = mcp_port_;
-+  uint16_t agent_port = agent_port_;
-+  uint16_t extension_port = extension_port_;
++  uint16_t mcp_port = ports.mcp_port;
++  uint16_t agent_port = ports.agent_port;
++  uint16_t extension_port = ports.extension_port;
 +
 +  // Gather server config on UI thread
 +  ServerConfig server_config;
@@ -603,14 +909,22 @@ index 0000000000000..dab79743c4753
 +      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
 +      base::BindOnce(&LaunchProcessOnBackgroundThread, exe_path, resources_dir,
 +                     fallback_exe_path, fallback_resources_dir, execution_dir,
-+                     cdp_port, mcp_port, agent_port, extension_port,
-+                     server_config),
-+      base::BindOnce(&AnalOSServerManager::OnProcessLaunched,
-+                     weak_factory_.GetWeakPtr()));
++                     config_slot, cdp_port, mcp_port, agent_port,
++                     extension_port, server_config, std::move(reservations),
++                     socket_activation_),
++      std::move(callback));
 +}
 +
 +void AnalOSServerManager::OnProcessLaunched(LaunchResult result) {
-+  bool was_updating = is_updating_;
++  if (!launch_pending_) {
++    // Stopped meanwhile; the watcher reaps the killed process
++    if (result.process.IsValid()) {
++      WatchProcess(result.process, ++next_launch_id_);
++      result.process.Terminate(0, /*wait=*/false);
++    }
++    return;
++  }
++  launch_pending_ = false;
 +
 +  // If we fell back to bundled binary, invalidate downloaded version
 +  if (result.used_fallback && updater_) {
@@ -622,21 +936,21 @@ index 0000000000000..dab79743c4753
 +    // Don't stop CDP server - it's independent and may be used by other things
 +    // Leave system in degraded state (CDP up, no analos_server) rather than
 +    // completely broken state (no CDP, no server)
-+    is_restarting_ = false;
-+
-+    // Notify updater of failure if this was an update restart
-+    if (was_updating) {
-+      is_updating_ = false;
-+      if (update_complete_callback_) {
-+        std::move(update_complete_callback_).Run(false);
-+      }
-+    }
++    CompleteRestart(/*success=*/false);
 +    return;
 +  }
 +
 +  process_ = std::move(result.process);
++#if BUILDFLAG(IS_POSIX)
++  listeners_ = std::move(result.listeners);
++#endif
 +  is_running_ = true;
 +  last_launch_time_ = base::TimeTicks::Now();
++  launch_id_ = ++next_launch_id_;
++  ++launch_count_;
++  last_process_sample_ = {};
++  last_active_time_ = last_launch_time_;
++  WatchProcess(process_, launch_id_);
 +
 +  LOG(INFO) << "analos: AnalOS server started with PID: " << process_.Pid();
 +  LOG(INFO) << "analos: CDP port: " << cdp_port_;
@@ -644,29 +958,16 @@ index 0000000000000..dab79743c4753
 +  LOG(INFO) << "analos: Agent port: " << agent_port_;
 +  LOG(INFO) << "analos: Extension port: " << extension_port_;
 +
-+  // Start/restart monitoring timers
++  // Start/restart health checks
++  consecutive_health_failures_ = 0;
 +  health_check_timer_.Start(FROM_HERE, kHealthCheckInterval, this,
 +                            &AnalOSServerManager::CheckServerHealth);
-+  process_check_timer_.Start(FROM_HERE, kProcessCheckInterval, this,
-+                             &AnalOSServerManager::CheckProcessStatus);
-+
-+  // Reset restart flag and pref after successful launch
-+  if (is_restarting_) {
-+    is_restarting_ = false;
-+    PrefService* prefs = g_browser_process->local_state();
-+    if (prefs && prefs->GetBoolean(analos_server::kRestartServerRequested)) {
-+      prefs->SetBoolean(analos_server::kRestartServerRequested, false);
-+      LOG(INFO) << "analos: Restart completed, reset restart_requested pref";
-+    }
++  if (!process_sample_timer_.IsRunning()) {
++    process_sample_timer_.Start(FROM_HERE, kProcessSampleInterval, this,
++                                &AnalOSServerManager::SampleServerProcess);
 +  }
 +
-+  // Notify updater of success if this was an update restart
-+  if (was_updating) {
-+    is_updating_ = false;
-+    if (update_complete_callback_) {
-+      std::move(update_complete_callback_).Run(true);
-+    }
-+  }
++  CompleteRestart(/*success=*/true);
 +
 +  // Start the updater (if not already running and not disabled)
 +  if (!updater_) {
@@ -681,37 +982,42 @@ index 0000000000000..dab79743c4753
 +  }
 +}
 +
-+void AnalOSServerManager::TerminateAnalOSProcess(bool wait) {
++void AnalOSServerManager::CompleteRestart(bool success) {
++  // Reset restart flag, and the pref after a successful restart
++  if (is_restarting_) {
++    is_restarting_ = false;
++    PrefService* prefs = g_browser_process->local_state();
++    if (success && prefs &&
++        prefs->GetBoolean(analos_server::kRestartServerRequested)) {
++      prefs->SetBoolean(analos_server::kRestartServerRequested, false);
++      LOG(INFO) << "analos: Restart completed, reset restart_requested pref";
++    }
++  }
++
++  // Notify updater if this was an update restart
++  if (is_updating_) {
++    is_updating_ = false;
++    if (update_complete_callback_) {
++      std::move(update_complete_callback_).Run(success);
++    }
++  }
++}
++
++void AnalOSServerManager::TerminateAnalOSProcess() {
 +  if (!process_.IsValid()) {
 +    return;
 +  }
 +
 +  LOG(INFO) << "analos: Terminating AnalOS server process (PID: "
-+            << process_.Pid() << ", wait: " << (wait ? "true" : "false") << ")";
++            << process_.Pid() << ")";
 +
 +#if BUILDFLAG(IS_POSIX)
 +  base::ProcessId pid = process_.Pid();
 +  if (kill(pid, SIGKILL) != 0) {
 +    PLOG(ERROR) << "analos: Failed to send SIGKILL to PID " << pid;
-+  } else if (wait) {
-+    // Blocking wait - must be called from background thread
-+    base::ScopedAllowBaseSyncPrimitives allow_sync;
-+    base::ScopedAllowBlocking allow_blocking;
-+    int exit_code = 0;
-+    if (process_.WaitForExit(&exit_code)) {
-+      LOG(INFO) << "analos: Process killed successfully";
-+    } else {
-+      LOG(WARNING) << "analos: WaitForExit failed";
-+    }
-+  } else {
-+    LOG(INFO) << "analos: SIGKILL sent (not waiting for exit)";
 +  }
 +#else
-+  // Windows: Terminate with wait parameter
-+  bool terminated = process_.Terminate(0, wait);
-+  if (terminated) {
-+    LOG(INFO) << "analos: Process terminated successfully";
-+  } else {
++  if (!process_.Terminate(0, /*wait=*/false)) {
 +    LOG(ERROR) << "analos: Failed to terminate process";
 +  }
 +#endif
@@ -719,13 +1025,66 @@ index 0000000000000..dab79743c4753
 +  is_running_ = false;
 +}
 +
++void AnalOSServerManager::KillAndThen(base::OnceClosure after_exit) {
++  // Without a process there is nothing to wait for; otherwise its watcher
++  // reply runs |after_exit|, also if it exited on its own meanwhile
++  if (!process_.IsValid()) {
++    is_running_ = false;
++    std::move(after_exit).Run();
++    return;
++  }
++  after_exit_ = std::move(after_exit);
++  TerminateAnalOSProcess();
++}
++
++void AnalOSServerManager::WatchProcess(const base::Process& process,
++                                       uint64_t launch_id) {
++  // Blocks a worker for the lifetime of the process; the pool makes up for
++  // it with another one
++  base::ThreadPool::PostTaskAndReplyWithResult(
++      FROM_HERE,
++      {base::MayBlock(), base::WithBaseSyncPrimitives(),
++       base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
++      base::BindOnce(&WaitForProcessExit, process.Duplicate()),
++      base::BindOnce(&AnalOSServerManager::OnWatchedProcessExited,
++                     weak_factory_.GetWeakPtr(), launch_id));
++}
++
++void AnalOSServerManager::OnWatchedProcessExited(uint64_t launch_id,
++                                                 int exit_code) {
++  if (launch_id == standby_launch_id_ && standby_process_.IsValid()) {
++    OnStandbyExited(exit_code);
++    return;
++  }
++  if (launch_id == retiring_launch_id_) {
++    retire_timer_.Stop();
++    retiring_process_.Close();
++    retiring_launch_id_ = 0;
++    return;
++  }
++  // Replaced or retired processes only needed reaping
++  if (launch_id != launch_id_) {
++    return;
++  }
++  process_.Close();
++
++  // Restarts and idle stops kill the process themselves and continue here
++  if (after_exit_) {
++    std::move(after_exit_).Run();
++    return;
++  }
++  if (!is_running_ || is_restarting_) {
++    return;
++  }
++  OnProcessExited(exit_code);
++}
++
 +void AnalOSServerManager::OnProcessExited(int exit_code) {
 +  LOG(INFO) << "analos: AnalOS server exited with code: " << exit_code;
 +  is_running_ = false;
 +
-+  // Stop timers during restart to prevent races
++  // Stop health checks during restart to prevent races
 +  health_check_timer_.Stop();
-+  process_check_timer_.Stop();
 +
 +  // Crash tracking: check if this was a startup failure
 +  base::TimeDelta uptime = base::TimeTicks::Now() - last_launch_time_;
@@ -735,6 +1094,16 @@ index 0000000000000..dab79743c4753
 +                 << uptime.InSeconds() << "s, consecutive failures: "
 +                 << consecutive_startup_failures_ << ")";
 +
++    // A server that cannot use the inherited sockets fails to bind its ports
++    if (socket_activation_) {
++      LOG(WARNING) << "analos: Disabling socket activation after startup "
++                   << "failure";
++      socket_activation_ = false;
++      // Connections queued while dormant would not reach a server binding
++      // its own ports, so it has to stay up
++      on_demand_ = false;
++    }
++
 +    if (consecutive_startup_failures_ >= kMaxStartupFailures) {
 +      LOG(ERROR) << "analos: Too many startup failures ("
 +                 << consecutive_startup_failures_
@@ -760,20 +1129,8 @@ index 0000000000000..dab79743c4753
 +  // Don't call Start() - we already hold the lock and CDP server is running
 +  LOG(WARNING) << "analos: AnalOS server exited, restarting process...";
 +
-+  // Capture current ports for background thread
-+  int cdp = cdp_port_;
-+  int mcp = mcp_port_;
-+  int agent = agent_port_;
-+  int extension = extension_port_;
-+
-+  // Revalidate ports on background thread, then launch on UI thread
 +  // Process is already dead, no need to terminate
-+  base::ThreadPool::PostTaskAndReplyWithResult(
-+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
-+      base::BindOnce(&AnalOSServerManager::RevalidatePorts,
-+                     base::Unretained(this), cdp, mcp, agent, extension),
-+      base::BindOnce(&AnalOSServerManager::OnPortsRevalidated,
-+                     weak_factory_.GetWeakPtr()));
++  RevalidatePorts();
 +}
 +
 +void AnalOSServerManager::CheckServerHealth() {
@@ -781,8 +1138,17 @@ index 0000000000000..dab79743c4753
 +    return;
 +  }
 +
++  SendHealthCheck(mcp_port_,
++                  base::BindOnce(&AnalOSServerManager::OnHealthCheckComplete,
++                                 weak_factory_.GetWeakPtr(),
++                                 base::TimeTicks::Now()));
++}
++
++void AnalOSServerManager::SendHealthCheck(
++    int port,
++    base::OnceCallback<void(HealthCheckResult)> callback) {
 +  // Build health check URL
-+  GURL health_url("http://127.0.0.1:" + base::NumberToString(mcp_port_) + "/health");
++  GURL health_url("http://127.0.0.1:" + base::NumberToString(port) + "/health");
 +
 +  // Create network traffic annotation
 +  net::NetworkTrafficAnnotationTag traffic_annotation =
@@ -792,7 +1158,7 @@ index 0000000000000..dab79743c4753
 +          description:
 +            "Checks if the AnalOS MCP server is healthy by querying its "
 +            "/health endpoint."
-+          trigger: "Periodic health check every 60 seconds while server is running."
++          trigger: "Periodic health check every 5 seconds while server is running."
 +          data: "No user data sent, just an HTTP GET request."
 +          destination: LOCAL
 +        }
@@ -822,58 +1188,148 @@ index 0000000000000..dab79743c4753
 +  auto* url_loader_ptr = url_loader.get();
 +
 +  // Download response
-+  url_loader_ptr->DownloadHeadersOnly(
++  url_loader_ptr->DownloadToString(
 +      url_loader_factory,
-+      base::BindOnce(&AnalOSServerManager::OnHealthCheckComplete,
-+                     weak_factory_.GetWeakPtr(), std::move(url_loader)));
++      base::BindOnce(
++          [](base::OnceCallback<void(HealthCheckResult)> callback,
++             std::unique_ptr<network::SimpleURLLoader> url_loader,
++             std::optional<std::string> body) {
++            // Check if we got a valid response
++            const network::mojom::URLResponseHead* response =
++                url_loader->ResponseInfo();
++            int response_code = response && response->headers
++                                    ? response->headers->response_code()
++                                    : 0;
++            if (response_code != 200) {
++              LOG(WARNING) << "analos: Health check failed - HTTP "
++                           << response_code << ", net error: "
++                           << net::ErrorToString(url_loader->NetError());
++            }
++            HealthCheckResult result;
++            result.healthy = response_code == 200;
++            if (result.healthy && body) {
++              result.activity = ParseHealthActivity(*body);
++            }
++            std::move(callback).Run(result);
++          },
++          std::move(callback), std::move(url_loader)),
++      kMaxHealthResponseSize);
 +}
 +
-+void AnalOSServerManager::CheckProcessStatus() {
-+  if (!is_running_ || !process_.IsValid()) {
++void AnalOSServerManager::OnHealthCheckComplete(base::TimeTicks start_time,
++                                                HealthCheckResult result) {
++  if (!is_running_ || is_restarting_) {
 +    return;
 +  }
 +
-+  int exit_code = 0;
-+  bool exited = process_.WaitForExitWithTimeout(base::TimeDelta(), &exit_code);
-+  LOG(INFO) << "analos: CheckProcessStatus PID: " << process_.Pid()
-+            << ", WaitForExitWithTimeout returned: " << exited
-+            << ", exit_code: " << exit_code;
++  if (result.healthy) {
++    base::TimeDelta latency = base::TimeTicks::Now() - start_time;
++    VLOG(1) << "analos: Health check passed in " << latency;
++    LOCAL_HISTOGRAM_TIMES("AnalOS.Server.HealthCheckLatency", latency);
++    health_check_latencies_.push_back(latency);
++    if (health_check_latencies_.size() > kMaxHealthLatencySamples) {
++      health_check_latencies_.pop_front();
++    }
++    consecutive_health_failures_ = 0;
++    if (on_demand_) {
++      UpdateIdleState(result.activity);
++    }
++    return;
++  }
 +
-+  if (exited) {
-+    OnProcessExited(exit_code);
++  // A single slow answer under load is not a hang
++  ++health_check_failures_;
++  ++consecutive_health_failures_;
++  if (consecutive_health_failures_ < kMaxHealthCheckFailures) {
++    return;
 +  }
++
++  LOG(WARNING) << "analos: Server unresponsive after "
++               << consecutive_health_failures_
++               << " health checks, restarting AnalOS server process...";
++  RestartAnalOSProcess();
 +}
 +
-+void AnalOSServerManager::OnHealthCheckComplete(
-+    std::unique_ptr<network::SimpleURLLoader> url_loader,
-+    scoped_refptr<net::HttpResponseHeaders> headers) {
-+  if (!is_running_) {
++void AnalOSServerManager::SampleServerProcess() {
++  if (!is_running_ || !process_.IsValid()) {
++    return;
++  }
++
++  base::ThreadPool::PostTaskAndReplyWithResult(
++      FROM_HERE, {base::MayBlock(), base::TaskPriority::BEST_EFFORT},
++      base::BindOnce(&SampleProcessOnBackgroundThread, process_.Duplicate()),
++      base::BindOnce(&AnalOSServerManager::OnServerProcessSampled,
++                     weak_factory_.GetWeakPtr(), launch_id_));
++}
++
++void AnalOSServerManager::OnServerProcessSampled(uint64_t launch_id,
++                                                 ProcessSample sample) {
++  // The process was replaced while sampling
++  if (launch_id != launch_id_) {
 +    return;
 +  }
 +
-+  // Check if we got a valid response
-+  int response_code = 0;
-+  if (headers) {
-+    response_code = headers->response_code();
++  if (sample.resident_set_bytes) {
++    LOCAL_HISTOGRAM_CUSTOM_COUNTS(
++        "AnalOS.Server.ResidentSetMB",
++        static_cast<int>(*sample.resident_set_bytes / (1024 * 1024)), 1,
++        16 * 1024, 50);
++  }
++  if (sample.open_fd_count) {
++    LOCAL_HISTOGRAM_COUNTS_10000("AnalOS.Server.OpenFdCount",
++                                 *sample.open_fd_count);
 +  }
 +
-+  if (response_code == 200) {
-+    LOG(INFO) << "analos: Health check passed";
++  last_process_sample_ = std::move(sample);
++}
++
++void AnalOSServerManager::UpdateIdleState(std::optional<int> activity) {
++  // A server that does not report its activity is never considered idle
++  base::TimeTicks now = base::TimeTicks::Now();
++  if (!activity || *activity > 0) {
++    last_active_time_ = now;
 +    return;
 +  }
 +
-+  // Health check failed
-+  int net_error = url_loader->NetError();
-+  LOG(WARNING) << "analos: Health check failed - HTTP " << response_code
-+               << ", net error: " << net::ErrorToString(net_error)
-+               << ", restarting AnalOS server process...";
++#if BUILDFLAG(IS_POSIX)
++  if (now - last_active_time_ >= idle_timeout_) {
++    ShutDownIdleServer();
++  }
++#endif
++}
 +
-+  RestartAnalOSProcess();
++AnalOSServerManager::ServerStats AnalOSServerManager::GetServerStats() const {
++  ServerStats stats;
++  stats.running = IsRunning();
++  if (stats.running) {
++    stats.pid = process_.Pid();
++    stats.uptime = base::TimeTicks::Now() - last_launch_time_;
++    stats.process = last_process_sample_;
++  }
++  // Every launch after the first replaced a previous process
++  stats.restart_count = std::max(0, launch_count_ - 1);
++
++  std::vector<base::TimeDelta> latencies(health_check_latencies_.begin(),
++                                         health_check_latencies_.end());
++  std::sort(latencies.begin(), latencies.end());
++  stats.health_check_count = latencies.size();
++  if (!latencies.empty()) {
++    stats.health_check_latency_median = Percentile(latencies, 50);
++    stats.health_check_latency_p95 = Percentile(latencies, 95);
++    stats.health_check_latency_max = latencies.back();
++  }
++  stats.health_check_failures = health_check_failures_;
++  return stats;
 +}
 +
 +void AnalOSServerManager::RestartAnalOSProcess() {
 +  LOG(INFO) << "analos: Restarting AnalOS server process";
 +
++  if (is_dormant_) {
++    LOG(INFO) << "analos: Server not launched yet, changes apply on demand";
++    return;
++  }
++
 +  // Prevent multiple concurrent restarts
 +  if (is_restarting_) {
 +    LOG(INFO) << "analos: Restart already in progress, ignoring";
@@ -883,50 +1339,247 @@ index 0000000000000..dab79743c4753
 +
 +  // Stop all timers during restart to prevent races
 +  health_check_timer_.Stop();
-+  process_check_timer_.Stop();
 +
-+  // Capture current ports for background thread
-+  int cdp = cdp_port_;
-+  int mcp = mcp_port_;
-+  int agent = agent_port_;
-+  int extension = extension_port_;
++  // With a live process, bring up the replacement before stopping it
++  if (is_running_ && process_.IsValid()) {
++    StartStandbyProcess();
++  } else {
++    ColdRestart();
++  }
++}
 +
-+  // Kill process on background thread, revalidate ports, then launch on UI thread
-+  base::ThreadPool::PostTaskAndReplyWithResult(
-+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
-+      base::BindOnce(
-+          [](AnalOSServerManager* manager, int cdp, int mcp, int agent,
-+             int extension) -> RevalidatedPorts {
-+            manager->TerminateAnalOSProcess(/*wait=*/true);
-+            return manager->RevalidatePorts(cdp, mcp, agent, extension);
-+          },
-+          base::Unretained(this), cdp, mcp, agent, extension),
-+      base::BindOnce(&AnalOSServerManager::OnPortsRevalidated,
-+                     weak_factory_.GetWeakPtr()));
++void AnalOSServerManager::ColdRestart() {
++  LOG(INFO) << "analos: Stopping server before relaunch";
++
++  // Revalidate ports and launch once the old process released them
++  KillAndThen(base::BindOnce(&AnalOSServerManager::RevalidatePorts,
++                             weak_factory_.GetWeakPtr()));
 +}
 +
-+AnalOSServerManager::RevalidatedPorts AnalOSServerManager::RevalidatePorts(
-+    int cdp_port,
-+    int current_mcp,
-+    int current_agent,
-+    int current_extension) {
-+  // CDP port is excluded - it's still bound by Chrome's DevTools server
-+  std::set<int> excluded_ports;
-+  excluded_ports.insert(cdp_port);
++void AnalOSServerManager::StartStandbyProcess() {
++#if BUILDFLAG(IS_POSIX)
++  // The standby takes over the advertised ports by inheriting the current
++  // process's listening sockets; a server binding them itself could not
++  std::vector<analos_server::PortReservation> reservations;
++  const int ports[] = {mcp_port_, agent_port_, extension_port_};
++  if (!listeners_.empty() && !ListenersMatchRemoteSetting()) {
++    LOG(INFO) << "analos: MCP remote access changed, restarting server on "
++              << "rebound ports";
++    ColdRestart();
++    return;
++  }
++  if (listeners_.size() == 2 * std::size(ports)) {
++    for (size_t i = 0; i < std::size(ports); ++i) {
++      std::vector<base::ScopedFD> descriptors;
++      for (size_t j = 2 * i; j < 2 * i + 2; ++j) {
++        base::ScopedFD fd(HANDLE_EINTR(dup(listeners_[j].get())));
++        if (!fd.is_valid()) {
++          PLOG(ERROR) << "analos: Failed to duplicate listening socket";
++          ColdRestart();
++          return;
++        }
++        descriptors.push_back(std::move(fd));
++      }
++      reservations.emplace_back(ports[i], std::move(descriptors));
++    }
 +
-+  RevalidatedPorts result;
-+  result.mcp_port = FindAvailablePort(current_mcp, excluded_ports);
-+  excluded_ports.insert(result.mcp_port);
++    // Both processes accept on the shared sockets, so either could answer a
++    // /health there; the standby is probed on a port of its own
++    analos_server::ReservePorts(
++        {extension_port_ + 1},
++        {cdp_port_, mcp_port_, agent_port_, extension_port_}, {},
++        base::BindOnce(&AnalOSServerManager::OnStandbyHealthPortReserved,
++                       weak_factory_.GetWeakPtr(), std::move(reservations)));
++    return;
++  }
++#endif
 +
-+  result.agent_port = FindAvailablePort(current_agent, excluded_ports);
-+  excluded_ports.insert(result.agent_port);
++  LOG(INFO) << "analos: Server does not use inherited sockets, restarting "
++               "it in place";
++  ColdRestart();
++}
 +
-+  result.extension_port = FindAvailablePort(current_extension, excluded_ports);
++#if BUILDFLAG(IS_POSIX)
++void AnalOSServerManager::OnStandbyHealthPortReserved(
++    std::vector<analos_server::PortReservation> reservations,
++    std::vector<analos_server::PortReservation> health_reservations) {
++  if (!is_restarting_) {
++    return;  // Stopped meanwhile
++  }
++  if (!health_reservations[0].is_reserved()) {
++    LOG(WARNING) << "analos: No port to probe a standby server on, "
++                 << "restarting in place";
++    ColdRestart();
++    return;
++  }
++  standby_health_port_ = health_reservations[0].port();
++  reservations.push_back(std::move(health_reservations[0]));
 +
-+  return result;
++  LOG(INFO) << "analos: Starting standby server alongside PID "
++            << process_.Pid() << " (health port: " << standby_health_port_
++            << ")";
++  LaunchServerProcess({mcp_port_, agent_port_, extension_port_},
++                      1 - config_slot_, std::move(reservations),
++                      base::BindOnce(&AnalOSServerManager::OnStandbyLaunched,
++                                     weak_factory_.GetWeakPtr()));
++}
++#endif
++
++void AnalOSServerManager::OnStandbyLaunched(LaunchResult result) {
++  if (result.used_fallback && updater_) {
++    updater_->InvalidateDownloadedVersion();
++  }
++
++  if (!is_restarting_) {
++    // Stopped meanwhile; the watcher reaps the killed standby
++    if (result.process.IsValid()) {
++      WatchProcess(result.process, ++next_launch_id_);
++      result.process.Terminate(0, /*wait=*/false);
++    }
++    return;
++  }
++
++  if (!result.process.IsValid()) {
++    LOG(ERROR) << "analos: Failed to launch standby server, falling back to "
++                  "stop-and-start";
++    ColdRestart();
++    return;
++  }
++
++  standby_process_ = std::move(result.process);
++  standby_launch_id_ = ++next_launch_id_;
++  WatchProcess(standby_process_, standby_launch_id_);
++  standby_deadline_ = base::TimeTicks::Now() + kStandbyReadyTimeout;
++  LOG(INFO) << "analos: Standby server started with PID "
++            << standby_process_.Pid();
++  CheckStandbyHealth();
++}
++
++void AnalOSServerManager::CheckStandbyHealth() {
++  if (!standby_process_.IsValid()) {
++    return;
++  }
++
++  if (base::TimeTicks::Now() >= standby_deadline_) {
++    LOG(ERROR) << "analos: Standby server not healthy after "
++               << kStandbyReadyTimeout.InSeconds() << "s";
++    AbandonStandby();
++    ColdRestart();
++    return;
++  }
++
++  SendHealthCheck(standby_health_port_,
++                  base::BindOnce(&AnalOSServerManager::OnStandbyHealthCheck,
++                                 weak_factory_.GetWeakPtr()));
++}
++
++void AnalOSServerManager::OnStandbyHealthCheck(HealthCheckResult result) {
++  if (!standby_process_.IsValid()) {
++    return;
++  }
++  if (!result.healthy) {
++    standby_check_timer_.Start(FROM_HERE, kStandbyPollInterval, this,
++                               &AnalOSServerManager::CheckStandbyHealth);
++    return;
++  }
++  PromoteStandby();
++}
++
++void AnalOSServerManager::OnStandbyExited(int exit_code) {
++  LOG(ERROR) << "analos: Standby server exited with code " << exit_code
++             << " before becoming healthy";
++  standby_process_.Close();
++  AbandonStandby();
++  ColdRestart();
++}
++
++void AnalOSServerManager::PromoteStandby() {
++  LOG(INFO) << "analos: Switching to standby server (PID "
++            << standby_process_.Pid() << ")";
++
++  // A process still draining from an earlier switch goes first
++  RetireOldProcess();
++
++  // The old process keeps its watcher, which reaps it once retired
++  retiring_process_ = std::move(process_);
++  retiring_launch_id_ = launch_id_;
++  process_ = std::move(standby_process_);
++  launch_id_ = standby_launch_id_;
++  standby_launch_id_ = 0;
++  config_slot_ = 1 - config_slot_;
++
++  is_running_ = true;
++  last_launch_time_ = base::TimeTicks::Now();
++  ++launch_count_;
++  last_process_sample_ = {};
++  last_active_time_ = last_launch_time_;
++
++  consecutive_health_failures_ = 0;
++  health_check_timer_.Start(FROM_HERE, kHealthCheckInterval, this,
++                            &AnalOSServerManager::CheckServerHealth);
++
++  // Let the old process finish the requests it already accepted
++  if (retiring_process_.IsValid()) {
++    retire_timer_.Start(FROM_HERE, kDrainPeriod, this,
++                        &AnalOSServerManager::RetireOldProcess);
++  }
++
++  CompleteRestart(/*success=*/true);
++}
++
++void AnalOSServerManager::AbandonStandby() {
++  standby_check_timer_.Stop();
++  if (standby_process_.IsValid()) {
++    LOG(INFO) << "analos: Killing standby server (PID: "
++              << standby_process_.Pid() << ")";
++    standby_process_.Terminate(0, /*wait=*/false);
++    standby_process_.Close();
++  }
++  standby_launch_id_ = 0;
 +}
 +
-+void AnalOSServerManager::OnPortsRevalidated(RevalidatedPorts ports) {
++void AnalOSServerManager::RetireOldProcess() {
++  retire_timer_.Stop();
++  if (!retiring_process_.IsValid()) {
++    return;
++  }
++  LOG(INFO) << "analos: Retiring previous server process (PID: "
++            << retiring_process_.Pid() << ")";
++  if (!retiring_process_.Terminate(0, /*wait=*/false)) {
++    LOG(WARNING) << "analos: Failed to terminate previous server process";
++  }
++  // Signalled only; the watcher reply reaps it and closes the handle
++}
++
++void AnalOSServerManager::RevalidatePorts() {
++#if BUILDFLAG(IS_POSIX)
++  // The process that inherited them is gone; held open they would keep the
++  // ports from being reserved again
++  listeners_.clear();
++#endif
++  // CDP port is excluded - it's still bound by Chrome's DevTools server
++  analos_server::ReservePorts(
++      {mcp_port_, agent_port_, extension_port_}, {cdp_port_},
++      McpAnyAddressEntry(0),
++      base::BindOnce(&AnalOSServerManager::OnPortsRevalidated,
++                     weak_factory_.GetWeakPtr()));
++}
++
++void AnalOSServerManager::OnPortsRevalidated(
++    std::vector<analos_server::PortReservation> reservations) {
++  if (!is_restarting_) {
++    return;  // Stopped meanwhile
++  }
++  UpdatePorts(reservations);
++
++  // Note: is_restarting_ is cleared in OnProcessLaunched() after launch completes
++  LaunchAnalOSProcess(std::move(reservations));
++}
++
++void AnalOSServerManager::UpdatePorts(
++    const std::vector<analos_server::PortReservation>& reservations) {
++  RevalidatedPorts ports = {reservations[0].port(), reservations[1].port(),
++                            reservations[2].port()};
 +  bool ports_changed = (ports.mcp_port != mcp_port_) ||
 +                       (ports.agent_port != agent_port_) ||
 +                       (ports.extension_port != extension_port_);
@@ -943,9 +1596,145 @@ index 0000000000000..dab79743c4753
 +    extension_port_ = ports.extension_port;
 +    SavePortsToPrefs();
 +  }
++}
 +
-+  // Note: is_restarting_ is cleared in OnProcessLaunched() after launch completes
-+  LaunchAnalOSProcess();
++#if BUILDFLAG(IS_POSIX)
++void AnalOSServerManager::EnterDormant(
++    std::vector<analos_server::PortReservation> reservations) {
++  for (auto& reservation : reservations) {
++    if (!reservation.Listen(kBackLog)) {
++      LOG(WARNING) << "analos: Cannot hold port " << reservation.port()
++                   << " for on-demand start, launching server now";
++      is_dormant_ = false;
++      LaunchAnalOSProcess(std::move(reservations));
++      return;
++    }
++  }
++
++  LOG(INFO) << "analos: Server will launch on first connection (MCP: "
++            << mcp_port_ << ", Agent: " << agent_port_
++            << ", Extension: " << extension_port_ << ")";
++  is_dormant_ = true;
++
++  scoped_refptr<base::SequencedTaskRunner> task_runner =
++      base::ThreadPool::CreateSequencedTaskRunner(
++          {base::MayBlock(), base::TaskPriority::USER_VISIBLE});
++  connection_waiter_ = std::unique_ptr<ConnectionWaiter,
++                                       base::OnTaskRunnerDeleter>(
++      new ConnectionWaiter(
++          base::BindOnce(&AnalOSServerManager::OnDormantConnection,
++                         weak_factory_.GetWeakPtr())),
++      base::OnTaskRunnerDeleter(task_runner));
++  // Deletion is posted to the same sequence, after this
++  task_runner->PostTask(
++      FROM_HERE,
++      base::BindOnce(&ConnectionWaiter::Watch,
++                     base::Unretained(connection_waiter_.get()),
++                     std::move(reservations)));
++}
++
++void AnalOSServerManager::OnDormantConnection(
++    std::vector<analos_server::PortReservation> reservations) {
++  connection_waiter_.reset();
++  if (!is_dormant_ || is_restarting_) {
++    return;  // Stopped or rebinding meanwhile
++  }
++  is_dormant_ = false;
++
++  LOG(INFO) << "analos: Connection waiting, launching server on demand";
++  LaunchAnalOSProcess(std::move(reservations));
++}
++
++void AnalOSServerManager::ShutDownIdleServer() {
++  LOG(INFO) << "analos: Server idle for " << idle_timeout_
++            << ", stopping until the next connection";
++
++  // The exit is expected: keep the watcher and health checks from acting
++  is_running_ = false;
++  is_dormant_ = true;
++  is_restarting_ = true;
++  health_check_timer_.Stop();
++
++  KillAndThen(base::BindOnce(&AnalOSServerManager::OnIdleServerStopped,
++                             weak_factory_.GetWeakPtr()));
++}
++
++void AnalOSServerManager::OnIdleServerStopped() {
++  if (!is_dormant_) {
++    return;  // Stopped meanwhile
++  }
++
++  // Keep holding the sockets the server listened on, so the ports stay
++  // taken and connections keep queueing until the next launch
++  const int ports[] = {mcp_port_, agent_port_, extension_port_};
++  if (listeners_.size() == 2 * std::size(ports) &&
++      ListenersMatchRemoteSetting()) {
++    std::vector<analos_server::PortReservation> reservations;
++    for (size_t i = 0; i < std::size(ports); ++i) {
++      std::vector<base::ScopedFD> descriptors;
++      descriptors.push_back(std::move(listeners_[2 * i]));
++      descriptors.push_back(std::move(listeners_[2 * i + 1]));
++      reservations.emplace_back(ports[i], std::move(descriptors));
++    }
++    listeners_.clear();
++    is_restarting_ = false;
++    EnterDormant(std::move(reservations));
++    return;
++  }
++
++  listeners_.clear();
++  ReserveDormantPorts();
++}
++
++void AnalOSServerManager::ReserveDormantPorts() {
++  // CDP port is excluded - it's still bound by Chrome's DevTools server
++  analos_server::ReservePorts(
++      {mcp_port_, agent_port_, extension_port_}, {cdp_port_},
++      McpAnyAddressEntry(0),
++      base::BindOnce(&AnalOSServerManager::OnIdlePortsReserved,
++                     weak_factory_.GetWeakPtr()));
++}
++
++void AnalOSServerManager::RebindDormantPorts() {
++  // An idle stop in progress reserves the ports itself
++  if (!connection_waiter_) {
++    return;
++  }
++  is_restarting_ = true;
++
++  // The held sockets are closed on the waiter's sequence, so the ports are
++  // reserved again after that
++  scoped_refptr<base::SequencedTaskRunner> task_runner =
++      connection_waiter_.get_deleter().task_runner_;
++  connection_waiter_.reset();
++  task_runner->PostTaskAndReply(
++      FROM_HERE, base::DoNothing(),
++      base::BindOnce(&AnalOSServerManager::ReserveDormantPorts,
++                     weak_factory_.GetWeakPtr()));
++}
++
++bool AnalOSServerManager::ListenersMatchRemoteSetting() const {
++  return !listeners_.empty() &&
++         IsLoopbackListener(listeners_[0].get()) != allow_remote_in_mcp_;
++}
++
++void AnalOSServerManager::OnIdlePortsReserved(
++    std::vector<analos_server::PortReservation> reservations) {
++  if (!is_dormant_) {
++    return;  // Stopped meanwhile
++  }
++  is_restarting_ = false;
++  UpdatePorts(reservations);
++  EnterDormant(std::move(reservations));
++}
++#endif
++
++std::set<size_t> AnalOSServerManager::McpAnyAddressEntry(
++    size_t mcp_index) const {
++  if (!allow_remote_in_mcp_) {
++    return {};
++  }
++  return {mcp_index};
 +}
 +
 +void AnalOSServerManager::RestartServerForUpdate(
@@ -959,34 +1748,29 @@ index 0000000000000..dab79743c4753
 +    return;
 +  }
 +
++  // The next on-demand launch picks the new binary up
++  if (is_dormant_) {
++    std::move(callback).Run(true);
++    return;
++  }
++
 +  is_updating_ = true;
 +  update_complete_callback_ = std::move(callback);
 +
 +  // Use same restart flow as RestartAnalOSProcess
 +  is_restarting_ = true;
 +  health_check_timer_.Stop();
-+  process_check_timer_.Stop();
 +
-+  int cdp = cdp_port_;
-+  int mcp = mcp_port_;
-+  int agent = agent_port_;
-+  int extension = extension_port_;
-+
-+  base::ThreadPool::PostTaskAndReplyWithResult(
-+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
-+      base::BindOnce(
-+          [](AnalOSServerManager* manager, int cdp, int mcp, int agent,
-+             int extension) -> RevalidatedPorts {
-+            manager->TerminateAnalOSProcess(/*wait=*/true);
-+            return manager->RevalidatePorts(cdp, mcp, agent, extension);
-+          },
-+          base::Unretained(this), cdp, mcp, agent, extension),
-+      base::BindOnce(&AnalOSServerManager::OnPortsRevalidated,
-+                     weak_factory_.GetWeakPtr()));
++  // The new version takes over without a gap if the current one is alive
++  if (is_running_ && process_.IsValid()) {
++    StartStandbyProcess();
++  } else {
++    ColdRestart();
++  }
 +}
 +
 +void AnalOSServerManager::OnAllowRemoteInMCPChanged() {
-+  if (!is_running_) {
++  if (!is_running_ && !is_dormant_) {
 +    return;
 +  }
 +
@@ -1005,6 +1789,14 @@ index 0000000000000..dab79743c4753
 +
 +    allow_remote_in_mcp_ = new_value;
 +
++#if BUILDFLAG(IS_POSIX)
++    // The held MCP sockets are bound for the old setting
++    if (is_dormant_) {
++      RebindDormantPorts();
++      return;
++    }
++#endif
++
 +    // Restart server to apply new config
 +    RestartAnalOSProcess();
 +  }
@@ -1027,90 +1819,6 @@ index 0000000000000..dab79743c4753
 +  RestartAnalOSProcess();
 +}
 +
-+int AnalOSServerManager::FindAvailablePort(
-+    int starting_port,
-+    const std::set<int>& excluded_ports) {
-+  LOG(INFO) << "analos: Finding port starting from " << starting_port;
-+
-+  for (int i = 0; i < kMaxPortAttempts; i++) {
-+    int port_to_try = starting_port + i;
-+
-+    if (port_to_try > kMaxPort) {
-+      break;
-+    }
-+
-+    // Skip ports already assigned to other AnalOS services
-+    if (excluded_ports.count(port_to_try) > 0) {
-+      continue;
-+    }
-+
-+    if (IsPortAvailable(port_to_try)) {
-+      if (port_to_try != starting_port) {
-+        LOG(INFO) << "analos: Port " << starting_port
-+                  << " was in use or excluded, using " << port_to_try
-+                  << " instead";
-+      } else {
-+        LOG(INFO) << "analos: Using port " << port_to_try;
-+      }
-+      return port_to_try;
-+    }
-+  }
-+
-+  LOG(WARNING) << "analos: Could not find available port after "
-+               << kMaxPortAttempts
-+               << " attempts, using " << starting_port << " anyway";
-+  return starting_port;
-+}
-+
-+bool AnalOSServerManager::IsPortAvailable(int port) {
-+  // Check port is in valid range
-+  if (!net::IsPortValid(port) || port == 0) {
-+    return false;
-+  }
-+
-+  // Avoid well-known ports (0-1023, require elevated privileges)
-+  if (net::IsWellKnownPort(port)) {
-+    return false;
-+  }
-+
-+  // Avoid restricted ports (could interfere with system services)
-+  if (!net::IsPortAllowedForScheme(port, "http")) {
-+    return false;
-+  }
-+
-+  // Use TCPSocket directly instead of TCPServerSocket to avoid SO_REUSEADDR.
-+  // TCPServerSocket::Listen() calls SetDefaultOptionsForServer() which sets
-+  // SO_REUSEADDR, allowing bind to succeed even when another socket is bound
-+  // to 0.0.0.0 (especially on macOS). By using TCPSocket directly and NOT
-+  // calling SetDefaultOptionsForServer(), we get accurate port availability.
-+
-+  // Try binding to IPv4 localhost
-+  auto socket = net::TCPSocket::Create(nullptr, nullptr, net::NetLogSource());
-+  int result = socket->Open(net::ADDRESS_FAMILY_IPV4);
-+  if (result != net::OK) {
-+    return false;
-+  }
-+  result = socket->Bind(net::IPEndPoint(net::IPAddress::IPv4Localhost(), port));
-+  socket->Close();
-+  if (result != net::OK) {
-+    return false;  // IPv4 port is in use
-+  }
-+
-+  // Try binding to IPv6 localhost
-+  auto socket6 = net::TCPSocket::Create(nullptr, nullptr, net::NetLogSource());
-+  result = socket6->Open(net::ADDRESS_FAMILY_IPV6);
-+  if (result != net::OK) {
-+    return false;
-+  }
-+  result = socket6->Bind(net::IPEndPoint(net::IPAddress::IPv6Localhost(), port));
-+  socket6->Close();
-+  if (result != net::OK) {
-+    return false;  // IPv6 port is in use
-+  }
-+
-+  return true;
-+}
-+
 +base::FilePath AnalOSServerManager::GetAnalOSServerResourcesPath() const {
 +  // Check for command-line override first
 +  base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/server/analos_server_manager.h b/chrome/browser/analos/server/analos_server_manager.h
 new file mode 100644
-index 0000000000000..3c322437eada1
+index 0000000000000..16d57661d4edf
 --- /dev/null
 +++ b/chrome/browser/analos/server/analos_server_manager.h
-@@ -0,0 +1,182 @@
+@@ -0,0 +1,377 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -11,16 +11,26 @@ index 0000000000000..3c322437eada1
 +#ifndef CHROME_BROWSER_ANALOS_SERVER_ANALOS_SERVER_MANAGER_H_
 +#define CHROME_BROWSER_ANALOS_SERVER_ANALOS_SERVER_MANAGER_H_
 +
++#include <cstdint>
 +#include <memory>
++#include <optional>
 +#include <set>
++#include <vector>
 +
++#include "base/containers/circular_deque.h"
 +#include "base/files/file.h"
 +#include "base/files/file_path.h"
++#include "base/files/scoped_file.h"
++#include "base/functional/callback.h"
 +#include "base/memory/ref_counted.h"
 +#include "base/memory/weak_ptr.h"
 +#include "base/no_destructor.h"
 +#include "base/process/process.h"
++#include "base/process/process_handle.h"
++#include "base/task/sequenced_task_runner.h"
 +#include "base/timer/timer.h"
++#include "build/build_config.h"
++#include "chrome/browser/analos/server/analos_port_allocator.h"
 +
 +class PrefChangeRegistrar;
 +
@@ -28,21 +38,24 @@ index 0000000000000..3c322437eada1
 +class AnalOSServerUpdater;
 +}
 +
-+namespace net {
-+class HttpResponseHeaders;
-+}
-+
-+namespace network {
-+class SimpleURLLoader;
-+}
-+
 +namespace analos {
 +
 +// AnalOS: Manages the lifecycle of the AnalOS server process (singleton)
 +// This manager:
 +// 1. Starts Chromium's CDP WebSocket server (port 9222+, auto-discovered)
 +// 2. Launches the bundled AnalOS server binary with CDP and MCP ports
-+// 3. Monitors MCP server health via HTTP /health endpoint and auto-restarts
++// 3. Restarts the server as soon as it exits, and when the HTTP /health
++//    endpoint stops answering
++// Planned restarts (updates, config changes, hangs) are blue/green when the
++// server runs with socket activation (--analos-server-socket-activation, off
++// by default): the new process inherits the listening sockets of the current
++// one and takes over once it answers /health on a port of its own, so
++// clients never see the server down and the ports never change. Otherwise
++// the server is restarted in place on the same ports.
++// With an idle timeout set (and socket activation), the server runs on
++// demand: its ports are held open from startup, it is launched when the first
++// connection arrives and stopped again once its /health reports no open
++// connections or in-flight requests for the idle period.
 +class AnalOSServerManager {
 + public:
 +  static AnalOSServerManager* GetInstance();
@@ -79,6 +92,34 @@ index 0000000000000..3c322437eada1
 +  // Returns whether remote connections are allowed in MCP server
 +  bool IsAllowRemoteInMCP() const { return allow_remote_in_mcp_; }
 +
++  // Resource usage of the server process, sampled on a worker.
++  // Public because it's used by free function SampleProcessOnBackgroundThread
++  struct ProcessSample {
++    // Unset where the platform cannot report the value
++    std::optional<uint64_t> resident_set_bytes;
++    std::optional<base::TimeDelta> cpu_time;
++    std::optional<int> open_fd_count;
++  };
++
++  // Diagnostics for the server process, for chrome.analOS.getServerStats
++  struct ServerStats {
++    bool running = false;
++    base::ProcessId pid = base::kNullProcessId;
++    base::TimeDelta uptime;
++    // Relaunches since browser start (crashes, hangs, updates, config)
++    int restart_count = 0;
++    // Latest sample of the current process; empty until the first one
++    ProcessSample process;
++    // Over the most recent successful health checks
++    size_t health_check_count = 0;
++    base::TimeDelta health_check_latency_median;
++    base::TimeDelta health_check_latency_p95;
++    base::TimeDelta health_check_latency_max;
++    // Failed health checks since browser start
++    int health_check_failures = 0;
++  };
++  ServerStats GetServerStats() const;
++
 +  // Called when browser is shutting down
 +  void Shutdown();
 +
@@ -95,14 +136,31 @@ index 0000000000000..3c322437eada1
 +  // Result from launching the server process on background thread
 +  // Public because it's used by free function LaunchProcessOnBackgroundThread
 +  struct LaunchResult {
++    LaunchResult();
++    LaunchResult(LaunchResult&&);
++    LaunchResult& operator=(LaunchResult&&);
++    ~LaunchResult();
++
 +    base::Process process;
 +    bool used_fallback = false;  // True if fell back to bundled binary
++#if BUILDFLAG(IS_POSIX)
++    // Listening sockets the process inherited, in LISTEN_FDNAMES order
++    std::vector<base::ScopedFD> listeners;
++#endif
 +  };
 +
 + private:
 +  friend base::NoDestructor<AnalOSServerManager>;
 +
-+  // Result of port revalidation (passed between background and UI threads)
++  // Outcome of one /health request
++  struct HealthCheckResult {
++    bool healthy = false;
++    // Open connections plus in-flight requests reported by the server, not
++    // counting the check itself; unset if the response does not say
++    std::optional<int> activity;
++  };
++
++  // MCP/Agent/Extension ports of one server process
 +  struct RevalidatedPorts {
 +    int mcp_port;
 +    int agent_port;
@@ -113,44 +171,122 @@ index 0000000000000..3c322437eada1
 +  ~AnalOSServerManager();
 +
 +  bool AcquireLock();
-+  void InitializePortsAndPrefs();
++  // Loads the preferred ports and remote-MCP setting from prefs
++  void ReadPrefs();
++  // Takes the reserved ports, applies command-line overrides and continues
++  // startup: saves prefs, acquires the lock and launches
++  void OnStartupPortsReserved(
++      std::vector<analos_server::PortReservation> reservations);
 +  void SavePortsToPrefs();
 +  void StartCDPServer();
 +  void StopCDPServer();
-+  void LaunchAnalOSProcess();
++  // Launches on the current ports and continues in OnProcessLaunched.
++  // |reservations| hold the MCP/Agent/Extension ports until the launch.
++  void LaunchAnalOSProcess(
++      std::vector<analos_server::PortReservation> reservations);
++  // |config_slot| selects the config file, see |config_slot_|
++  void LaunchServerProcess(
++      const RevalidatedPorts& ports,
++      size_t config_slot,
++      std::vector<analos_server::PortReservation> reservations,
++      base::OnceCallback<void(LaunchResult)> callback);
 +  void OnProcessLaunched(LaunchResult result);
-+  // Terminates the AnalOS server process.
-+  // If wait=true, blocks until process exits (must be called from background thread).
-+  // If wait=false, just sends kill signal and returns (safe from any thread).
-+  void TerminateAnalOSProcess(bool wait);
++  // Clears restart/update state and reports |success| to a pending update
++  void CompleteRestart(bool success);
++  // Sends the kill signal to the AnalOS server process without waiting; its
++  // watcher reaps it
++  void TerminateAnalOSProcess();
++  // Kills the current process and runs |after_exit| once its watcher has
++  // reaped it, or right away if there is no process
++  void KillAndThen(base::OnceClosure after_exit);
 +  void RestartAnalOSProcess();
-+
-+  // Revalidates MCP/Agent/Extension ports on background thread.
++  // Kills the current process, then launches a new one on the same ports
++  void ColdRestart();
++
++  // Blue/green restart: launch a standby on the listening sockets of the
++  // current process, poll /health on a private port of the standby, then
++  // make it the current process and retire the old one. Falls back to
++  // ColdRestart() if the sockets cannot be handed over or the standby fails
++  // to come up.
++  void StartStandbyProcess();
++#if BUILDFLAG(IS_POSIX)
++  void OnStandbyHealthPortReserved(
++      std::vector<analos_server::PortReservation> reservations,
++      std::vector<analos_server::PortReservation> health_reservations);
++#endif
++  void OnStandbyLaunched(LaunchResult result);
++  void CheckStandbyHealth();
++  void OnStandbyHealthCheck(HealthCheckResult result);
++  void OnStandbyExited(int exit_code);
++  void PromoteStandby();
++  void AbandonStandby();
++  // Kills the process replaced by the last blue/green switch, if any
++  void RetireOldProcess();
++
++  // Reserves MCP/Agent/Extension ports starting from the current ones.
 +  // CDP port is excluded (still bound by Chrome's DevTools server).
-+  // Returns potentially updated port values.
-+  RevalidatedPorts RevalidatePorts(int cdp_port,
-+                                   int current_mcp,
-+                                   int current_agent,
-+                                   int current_extension);
-+
-+  // UI thread callback after port revalidation.
-+  // Updates member vars and prefs if changed, then launches process.
-+  void OnPortsRevalidated(RevalidatedPorts ports);
-+
++  void RevalidatePorts();
++
++  // Updates member vars and prefs if the reserved ports changed, then
++  // launches process.
++  void OnPortsRevalidated(
++      std::vector<analos_server::PortReservation> reservations);
++  // Adopts the MCP/Agent/Extension ports of |reservations|, saving them to
++  // prefs if they changed
++  void UpdatePorts(
++      const std::vector<analos_server::PortReservation>& reservations);
++
++#if BUILDFLAG(IS_POSIX)
++  // On-demand mode: holds the listening ports until a connection is queued,
++  // then launches the server with them. Launches right away if the ports
++  // cannot be held.
++  void EnterDormant(std::vector<analos_server::PortReservation> reservations);
++  void OnDormantConnection(
++      std::vector<analos_server::PortReservation> reservations);
++  // Stops a server that has been idle for |idle_timeout_| and goes dormant
++  void ShutDownIdleServer();
++  // Goes dormant on the listening sockets the stopped server inherited, or
++  // on newly reserved ports if it had none
++  void OnIdleServerStopped();
++  void OnIdlePortsReserved(
++      std::vector<analos_server::PortReservation> reservations);
++  // Reserves the MCP/Agent/Extension ports for going dormant
++  void ReserveDormantPorts();
++  // Replaces the ports held while dormant with ones bound for the current
++  // remote-MCP setting
++  void RebindDormantPorts();
++  // Whether |listeners_| are bound for the current remote-MCP setting: all
++  // interfaces when remote access is allowed, loopback otherwise
++  bool ListenersMatchRemoteSetting() const;
++#endif
++  // Reservation entries to bind to all interfaces: the MCP port at
++  // |mcp_index| when remote MCP access is allowed
++  std::set<size_t> McpAnyAddressEntry(size_t mcp_index) const;
++
++  // Waits for |process| to exit in a blocking pool task of its own, which is
++  // the only place the process is reaped, and reports the exit with
++  // |launch_id|
++  void WatchProcess(const base::Process& process, uint64_t launch_id);
++  // Reply from a watcher. Exits of the current process that were not caused
++  // by a deliberate restart or stop are handled as crashes.
++  void OnWatchedProcessExited(uint64_t launch_id, int exit_code);
 +  void OnProcessExited(int exit_code);
 +  void CheckServerHealth();
-+  void OnHealthCheckComplete(
-+      std::unique_ptr<network::SimpleURLLoader> url_loader,
-+      scoped_refptr<net::HttpResponseHeaders> headers);
++  // GETs /health on |port| and reports whether it answered 200, with the
++  // activity counts of the response body
++  void SendHealthCheck(int port,
++                       base::OnceCallback<void(HealthCheckResult)> callback);
++  void OnHealthCheckComplete(base::TimeTicks start_time,
++                             HealthCheckResult result);
++  // On-demand mode: stops the server once it reported no activity for
++  // |idle_timeout_|
++  void UpdateIdleState(std::optional<int> activity);
++  void SampleServerProcess();
++  void OnServerProcessSampled(uint64_t launch_id, ProcessSample sample);
 +  void OnAllowRemoteInMCPChanged();
 +  void OnRestartServerRequestedChanged();
-+  void CheckProcessStatus();
 +
 +  base::FilePath GetAnalOSExecutionDir() const;
-+  // Finds an available port starting from starting_port, excluding ports
-+  // already assigned to other services to prevent collisions.
-+  int FindAvailablePort(int starting_port, const std::set<int>& excluded_ports);
-+  bool IsPortAvailable(int port);
 +
 +  base::File lock_file_;  // System-wide lock to ensure single instance
 +  base::Process process_;
@@ -159,6 +295,18 @@ index 0000000000000..3c322437eada1
 +  int agent_port_ = 0;  // Agent port (auto-discovered)
 +  int extension_port_ = 0;  // Extension port (auto-discovered)
 +  bool allow_remote_in_mcp_ = false;  // Whether remote connections allowed in MCP
++  // Whether launches pass the listening sockets to the server
++  bool socket_activation_ = false;
++  // On-demand mode: launch on first connection, stop after |idle_timeout_|
++  bool on_demand_ = false;
++  base::TimeDelta idle_timeout_;
++  bool is_dormant_ = false;  // Ports held, server not launched
++  // Between Start() and the end of its port search
++  bool is_starting_ = false;
++  // A launch of the current process is in flight; cleared by Stop() so a
++  // process that comes up afterwards is killed instead of adopted
++  bool launch_pending_ = false;
++  base::TimeTicks last_active_time_;  // Last health check with activity
 +  bool is_running_ = false;
 +  bool is_restarting_ = false;  // Whether server is currently restarting
 +  bool is_updating_ = false;    // Whether restarting for OTA update
@@ -170,9 +318,54 @@ index 0000000000000..3c322437eada1
 +
 +  // Timer for health checks
 +  base::RepeatingTimer health_check_timer_;
-+
-+  // Timer for process status checks
-+  base::RepeatingTimer process_check_timer_;
++  int consecutive_health_failures_ = 0;
++
++  // Telemetry for GetServerStats()
++  base::RepeatingTimer process_sample_timer_;
++  ProcessSample last_process_sample_;
++  base::circular_deque<base::TimeDelta> health_check_latencies_;
++  int health_check_failures_ = 0;
++
++  // Every launched process, standby included, gets the next launch ID so
++  // watcher replies can be matched to it
++  uint64_t next_launch_id_ = 0;
++  // Launch ID of |process_|
++  uint64_t launch_id_ = 0;
++  // Processes that became the current one
++  int launch_count_ = 0;
++  // Continues a restart or idle stop once the killed |process_| is reaped
++  base::OnceClosure after_exit_;
++
++#if BUILDFLAG(IS_POSIX)
++  // Watches the held ports while dormant; lives on a pool sequence
++  class ConnectionWaiter;
++  std::unique_ptr<ConnectionWaiter, base::OnTaskRunnerDeleter>
++      connection_waiter_{nullptr, base::OnTaskRunnerDeleter(nullptr)};
++#endif
++
++  // Replacement process during a blue/green restart
++  base::Process standby_process_;
++  uint64_t standby_launch_id_ = 0;
++  // Port only the standby listens on, for its health checks
++  int standby_health_port_ = 0;
++  base::TimeTicks standby_deadline_;
++  base::OneShotTimer standby_check_timer_;
++
++  // Process replaced by a blue/green switch, serving in-flight requests
++  // until |retire_timer_| fires. Its watcher reaps it.
++  base::Process retiring_process_;
++  uint64_t retiring_launch_id_ = 0;
++  base::OneShotTimer retire_timer_;
++
++  // Which of the two config files the current process reads. A standby
++  // writes the other one, so the running process's file is never rewritten.
++  size_t config_slot_ = 0;
++
++#if BUILDFLAG(IS_POSIX)
++  // Listening sockets inherited by the current process, kept open so a
++  // standby can inherit the same ones
++  std::vector<base::ScopedFD> listeners_;
++#endif
 +
 +  // Preference change registrar for monitoring pref changes
 +  std::unique_ptr<PrefChangeRegistrar> pref_change_registrar_;
@@ -180,6 +373,8 @@ index 0000000000000..3c322437eada1
 +  // Server updater for OTA updates
 +  std::unique_ptr<analos_server::AnalOSServerUpdater> updater_;
 +
++  // Invalidated by Stop() to drop a startup port search still running
++  base::WeakPtrFactory<AnalOSServerManager> startup_weak_factory_{this};
 +  base::WeakPtrFactory<AnalOSServerManager> weak_factory_{this};
 +};
 +
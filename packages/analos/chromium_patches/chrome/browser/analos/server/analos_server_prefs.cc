@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/server/analos_server_prefs.cc b/chrome/browser/analos/server/analos_server_prefs.cc
 new file mode 100644
-index 0000000000000..9ea53758657d7
+index 0000000000000..1765a812479c7
 --- /dev/null
 +++ b/chrome/browser/analos/server/analos_server_prefs.cc
-@@ -0,0 +1,58 @@
+@@ -0,0 +1,86 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -35,6 +35,22 @@ index 0000000000000..9ea53758657d7
 +// Current active analos-server version (for observability)
 +const char kServerVersion[] = "analos.server.version";
 +
++// Seconds of inactivity after which the server is stopped until the next
++// connection (0 = launch at startup and keep running)
++const char kServerIdleTimeout[] = "analos.server.idle_timeout_seconds";
++
++// Partial update download in pending_update, resumed by the next attempt:
++// {"url": ..., "validator": ETag or Last-Modified of the response}
++const char kServerPendingDownload[] = "analos.server.pending_download";
++
++// Cap on update download speed in KB/s (0 = unlimited)
++const char kServerDownloadBandwidthLimit[] =
++    "analos.server.download_bandwidth_limit_kbps";
++
++// Validators of the last parsed appcast, sent with the next fetch:
++// {"url", "etag", "last_modified", "version": latest version it listed}
++const char kServerAppcastCache[] = "analos.server.appcast_cache";
++
 +// DEPRECATED: kept for migration, no longer used
 +const char kMCPServerEnabled[] = "analos.server.mcp_enabled";
 +
@@ -59,6 +75,18 @@ index 0000000000000..9ea53758657d7
 +
 +  // Current server version (empty = unknown/bundled)
 +  registry->RegisterStringPref(kServerVersion, std::string());
++
++  // On-demand server with idle shutdown (default off)
++  registry->RegisterIntegerPref(kServerIdleTimeout, 0);
++
++  // Resumable update download (empty = none)
++  registry->RegisterDictionaryPref(kServerPendingDownload);
++
++  // Update download bandwidth cap (default unlimited)
++  registry->RegisterIntegerPref(kServerDownloadBandwidthLimit, 0);
++
++  // Conditional appcast fetch (empty = fetch unconditionally)
++  registry->RegisterDictionaryPref(kServerAppcastCache);
 +}
 +
 +}  // namespace analos_server
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/server/analos_server_prefs.h b/chrome/browser/analos/server/analos_server_prefs.h
 new file mode 100644
-index 0000000000000..0506a219c6272
+index 0000000000000..9750137c221de
 --- /dev/null
 +++ b/chrome/browser/analos/server/analos_server_prefs.h
-@@ -0,0 +1,35 @@
+@@ -0,0 +1,39 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -29,6 +29,10 @@ index 0000000000000..0506a219c6272
 +extern const char kAllowRemoteInMCP[];
 +extern const char kRestartServerRequested[];
 +extern const char kServerVersion[];
++extern const char kServerIdleTimeout[];
++extern const char kServerPendingDownload[];
++extern const char kServerDownloadBandwidthLimit[];
++extern const char kServerAppcastCache[];
 +
 +// Deprecated prefs (kept for migration, will be removed in future)
 +extern const char kMCPServerEnabled[];  // DEPRECATED: no longer used
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/server/analos_server_updater.cc b/chrome/browser/analos/server/analos_server_updater.cc
 new file mode 100644
-index 0000000000000..62162c8924fce
+index 0000000000000..5f4377bca2f21
 --- /dev/null
 +++ b/chrome/browser/analos/server/analos_server_updater.cc
-@@ -0,0 +1,1061 @@
+@@ -0,0 +1,1481 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -16,9 +16,11 @@ index 0000000000000..62162c8924fce
 +#include "base/feature_list.h"
 +#include "base/files/file_enumerator.h"
 +#include "base/files/file_util.h"
++#include "base/files/memory_mapped_file.h"
 +#include "base/logging.h"
 +#include "base/path_service.h"
 +#include "base/process/launch.h"
++#include "base/rand_util.h"
 +#include "base/strings/string_number_conversions.h"
 +#include "base/strings/string_util.h"
 +#include "base/task/thread_pool.h"
@@ -26,16 +28,22 @@ index 0000000000000..62162c8924fce
 +#include "chrome/browser/browser_process.h"
 +#include "chrome/browser/analos/metrics/analos_metrics.h"
 +#include "chrome/browser/analos/core/analos_switches.h"
++#include "chrome/browser/analos/server/analos_delta_update.h"
 +#include "chrome/browser/analos/server/analos_server_constants.h"
 +#include "chrome/browser/analos/server/analos_server_manager.h"
 +#include "chrome/browser/analos/server/analos_server_prefs.h"
++#include "chrome/browser/analos/server/analos_version_manifest.h"
 +#include "components/prefs/pref_service.h"
 +#include "chrome/browser/net/system_network_context_manager.h"
 +#include "chrome/common/chrome_paths.h"
 +#include "net/base/net_errors.h"
++#include "net/http/http_request_headers.h"
++#include "net/http/http_response_headers.h"
++#include "net/http/http_status_code.h"
 +#include "net/traffic_annotation/network_traffic_annotation.h"
 +#include "services/network/public/cpp/resource_request.h"
 +#include "services/network/public/cpp/simple_url_loader.h"
++#include "services/network/public/mojom/url_response_head.mojom.h"
 +#include "third_party/boringssl/src/include/openssl/curve25519.h"
 +#include "third_party/zlib/google/zip.h"
 +#include "third_party/zlib/google/zip_reader.h"
@@ -45,6 +53,37 @@ index 0000000000000..62162c8924fce
 +
 +namespace {
 +
++// Retries of a failed download within one update check
++constexpr net::BackoffEntry::Policy kDownloadRetryPolicy = {
++    0,                // Number of initial errors to ignore.
++    30 * 1000,        // Initial delay of 30 seconds.
++    2.0,              // Factor by which the waiting time will be multiplied.
++    0.2,              // Fuzzing percentage.
++    10 * 60 * 1000,   // Maximum delay of 10 minutes.
++    -1,               // Never discard the entry.
++    false,            // Don't use initial delay unless the last request was
++                      // an error.
++};
++
++// Failed appcast fetches, which delay the next update check
++constexpr net::BackoffEntry::Policy kAppcastRetryPolicy = {
++    0,                   // Number of initial errors to ignore.
++    15 * 60 * 1000,      // Initial delay of kUpdateCheckInterval.
++    2.0,                 // Factor by which the waiting time will be multiplied.
++    kUpdateCheckJitter,  // Fuzzing percentage.
++    6 * 60 * 60 * 1000,  // Maximum delay of 6 hours.
++    -1,                  // Never discard the entry.
++    false,               // Don't use initial delay unless the last request was
++                         // an error.
++};
++
++// Returns |interval| spread randomly by up to kUpdateCheckJitter either way
++base::TimeDelta RandomizeInterval(base::TimeDelta interval) {
++  return base::Milliseconds(
++      interval.InMillisecondsF() *
++      (1.0 + kUpdateCheckJitter * (2.0 * base::RandDouble() - 1.0)));
++}
++
 +net::NetworkTrafficAnnotationTag GetAppcastTrafficAnnotation() {
 +  return net::DefineNetworkTrafficAnnotation("analos_server_appcast", R"(
 +    semantics {
@@ -115,61 +154,78 @@ index 0000000000000..62162c8924fce
 +    })");
 +}
 +
-+// Verifies Ed25519 signature of file contents.
-+// Returns true if signature is valid.
-+bool VerifyEd25519Signature(const base::FilePath& file_path,
-+                            const std::string& signature_base64,
-+                            const std::string& public_key_base64) {
-+  // Decode public key
-+  std::string public_key_bytes;
-+  if (!base::Base64Decode(public_key_base64, &public_key_bytes)) {
-+    LOG(ERROR) << "analos: Failed to decode public key from base64";
++// Decodes a base64 Ed25519 key or signature and checks its length.
++// Returns false (and logs) if either check fails.
++bool DecodeEd25519Value(const std::string& value_base64,
++                        size_t expected_length,
++                        const char* name,
++                        std::string* value_bytes) {
++  if (!base::Base64Decode(value_base64, value_bytes)) {
++    LOG(ERROR) << "analos: Failed to decode " << name << " from base64";
 +    return false;
 +  }
-+  if (public_key_bytes.size() != ED25519_PUBLIC_KEY_LEN) {
-+    LOG(ERROR) << "analos: Invalid public key length: "
-+               << public_key_bytes.size() << " (expected "
-+               << ED25519_PUBLIC_KEY_LEN << ")";
++  if (value_bytes->size() != expected_length) {
++    LOG(ERROR) << "analos: Invalid " << name
++               << " length: " << value_bytes->size() << " (expected "
++               << expected_length << ")";
 +    return false;
 +  }
++  return true;
++}
 +
-+  // Decode signature
-+  std::string signature_bytes;
-+  if (!base::Base64Decode(signature_base64, &signature_bytes)) {
-+    LOG(ERROR) << "analos: Failed to decode signature from base64";
-+    return false;
-+  }
-+  if (signature_bytes.size() != ED25519_SIGNATURE_LEN) {
-+    LOG(ERROR) << "analos: Invalid signature length: "
-+               << signature_bytes.size() << " (expected "
-+               << ED25519_SIGNATURE_LEN << ")";
++// Verifies the Ed25519 signature of a downloaded package.
++//
++// With |digest_signature_base64| (sparkle:edDigestSignature), the signed
++// message is the package's SHA-512 |digest|, hashed while downloading.
++// Otherwise falls back to |signature_base64| (sparkle:edSignature) over the
++// whole file, which is memory-mapped rather than read into memory.
++// Returns true if the signature is valid.
++bool VerifyEd25519Signature(const base::FilePath& file_path,
++                            const std::string& signature_base64,
++                            const std::string& digest_signature_base64,
++                            const PackageDigest& digest,
++                            const std::string& public_key_base64) {
++  std::string public_key_bytes;
++  if (!DecodeEd25519Value(public_key_base64, ED25519_PUBLIC_KEY_LEN,
++                          "public key", &public_key_bytes)) {
 +    return false;
 +  }
++  const uint8_t* pub_key =
++      reinterpret_cast<const uint8_t*>(public_key_bytes.data());
 +
-+  // Read file contents
-+  std::string file_contents;
-+  if (!base::ReadFileToString(file_path, &file_contents)) {
-+    LOG(ERROR) << "analos: Failed to read file for signature verification: "
-+               << file_path;
++  const bool digest_signed = !digest_signature_base64.empty();
++  std::string signature_bytes;
++  if (!DecodeEd25519Value(
++          digest_signed ? digest_signature_base64 : signature_base64,
++          ED25519_SIGNATURE_LEN, "signature", &signature_bytes)) {
 +    return false;
 +  }
-+
-+  // Verify signature
-+  const uint8_t* message =
-+      reinterpret_cast<const uint8_t*>(file_contents.data());
-+  size_t message_len = file_contents.size();
 +  const uint8_t* sig =
 +      reinterpret_cast<const uint8_t*>(signature_bytes.data());
-+  const uint8_t* pub_key =
-+      reinterpret_cast<const uint8_t*>(public_key_bytes.data());
 +
-+  int result = ED25519_verify(message, message_len, sig, pub_key);
++  int result = 0;
++  if (digest_signed) {
++    result = ED25519_verify(digest.data(), digest.size(), sig, pub_key);
++  } else {
++    // Mapped pages are backed by the file and can be dropped under memory
++    // pressure, unlike a heap copy of the package
++    base::MemoryMappedFile mapped_file;
++    if (!mapped_file.Initialize(file_path)) {
++      LOG(ERROR) << "analos: Failed to map file for signature verification: "
++                 << file_path;
++      return false;
++    }
++    result = ED25519_verify(mapped_file.data(), mapped_file.length(), sig,
++                            pub_key);
++  }
++
 +  if (result != 1) {
 +    LOG(ERROR) << "analos: Ed25519 signature verification failed";
 +    return false;
 +  }
 +
-+  LOG(INFO) << "analos: Ed25519 signature verified successfully";
++  LOG(INFO) << "analos: Ed25519 signature verified successfully"
++            << (digest_signed ? " (SHA-512 digest)" : "");
 +  return true;
 +}
 +
@@ -219,46 +275,149 @@ index 0000000000000..62162c8924fce
 +  }
 +}
 +
++// Returns the version of a server binary as {exit_code, output}, like
++// RunBinaryVersionCheck. Uses the signed manifest in |resources_dir| when it
++// verifies (and names |expected_version|, if valid), and only runs the binary
++// otherwise.
++std::pair<int, std::string> GetBinaryVersion(
++    const base::FilePath& binary_path,
++    const base::FilePath& resources_dir,
++    const base::Version& expected_version,
++    bool check_hash) {
++  base::Version version =
++      ReadVersionManifest(resources_dir, binary_path, check_hash);
++  if (version.IsValid() &&
++      (!expected_version.IsValid() || version == expected_version)) {
++    return {0, version.GetString()};
++  }
++
++  int exit_code = 0;
++  std::string output;
++  RunBinaryVersionCheck(binary_path, &exit_code, &output);
++  return {exit_code, output};
++}
++
 +// Background task: verify signature + extract ZIP
 +struct VerifyExtractResult {
 +  bool success = false;
 +  std::string error;
 +};
 +
++// Deletes |dir| if present. Returns false if it is still there.
++bool CleanDirectory(const base::FilePath& dir) {
++  return !base::PathExists(dir) || base::DeletePathRecursively(dir);
++}
++
++// Moves a fully built version from |staging_dir| to |dest_dir|, so a partial
++// extraction never appears under versions/.
++// Returns empty string on success, error message on failure.
++std::string InstallStagedVersion(const base::FilePath& staging_dir,
++                                 const base::FilePath& dest_dir) {
++  // Clean stale destination if exists (handles interrupted updates)
++  if (base::PathExists(dest_dir)) {
++    LOG(WARNING) << "analos: Cleaning stale version directory: " << dest_dir;
++    if (!base::DeletePathRecursively(dest_dir)) {
++      return "Failed to clean stale version directory";
++    }
++  }
++
++  // Both live under the execution dir, so this is a rename
++  if (!base::CreateDirectory(dest_dir.DirName()) ||
++      !base::Move(staging_dir, dest_dir)) {
++    return "Failed to move extracted files to " + dest_dir.AsUTF8Unsafe();
++  }
++  return "";  // Success
++}
++
 +VerifyExtractResult DoVerifyAndExtract(const base::FilePath& zip_path,
 +                                       const std::string& signature,
++                                       const std::string& digest_signature,
++                                       const PackageDigest& digest,
 +                                       const base::FilePath& dest_dir) {
 +  VerifyExtractResult result;
 +
 +  // Step 1: Verify signature
-+  if (!VerifyEd25519Signature(zip_path, signature, kServerUpdatePublicKey)) {
++  if (!VerifyEd25519Signature(zip_path, signature, digest_signature, digest,
++                              kServerUpdatePublicKey)) {
 +    result.error = "Signature verification failed";
 +    base::DeleteFile(zip_path);
 +    return result;
 +  }
 +
-+  // Step 2: Clean stale destination if exists (handles interrupted updates)
-+  if (base::PathExists(dest_dir)) {
-+    LOG(WARNING) << "analos: Cleaning stale version directory: " << dest_dir;
-+    if (!base::DeletePathRecursively(dest_dir)) {
-+      result.error = "Failed to clean stale version directory";
-+      base::DeleteFile(zip_path);
-+      return result;
-+    }
++  // Step 2: Extract ZIP to the staging directory next to it
++  base::FilePath staging_dir =
++      zip_path.DirName().AppendASCII(kExtractStagingDirectoryName);
++  if (!CleanDirectory(staging_dir)) {
++    result.error = "Failed to clean staging directory";
++    base::DeleteFile(zip_path);
++    return result;
++  }
++  result.error = ExtractZipFile(zip_path, staging_dir);
++  base::DeleteFile(zip_path);
++
++  // Step 3: Move into place
++  if (result.error.empty()) {
++    result.error = InstallStagedVersion(staging_dir, dest_dir);
++  }
++  if (!result.error.empty()) {
++    base::DeletePathRecursively(staging_dir);
++    return result;
 +  }
 +
-+  // Step 3: Extract ZIP
-+  std::string extract_error = ExtractZipFile(zip_path, dest_dir);
-+  if (!extract_error.empty()) {
-+    result.error = extract_error;
-+    // Cleanup partial extraction
-+    base::DeletePathRecursively(dest_dir);
++  result.success = true;
++  return result;
++}
++
++// Like DoVerifyAndExtract, but |zip_path| is a delta package that is applied
++// against |base_resources_dir| (the resources of |base_version|).
++VerifyExtractResult DoVerifyAndApplyDelta(
++    const base::FilePath& zip_path,
++    const std::string& signature,
++    const std::string& digest_signature,
++    const PackageDigest& digest,
++    const base::Version& base_version,
++    const base::FilePath& base_resources_dir,
++    const base::FilePath& dest_dir) {
++  VerifyExtractResult result;
++
++  // Step 1: Verify signature of the delta package
++  if (!VerifyEd25519Signature(zip_path, signature, digest_signature, digest,
++                              kServerUpdatePublicKey)) {
++    result.error = "Delta signature verification failed";
 +    base::DeleteFile(zip_path);
 +    return result;
 +  }
 +
-+  // Success - delete the ZIP file (we have extracted contents)
++  // Step 2: Extract the delta package
++  base::FilePath delta_dir =
++      zip_path.DirName().AppendASCII(kDeltaDirectoryName);
++  base::FilePath staging_dir =
++      zip_path.DirName().AppendASCII(kExtractStagingDirectoryName);
++  if (!CleanDirectory(delta_dir) || !CleanDirectory(staging_dir)) {
++    result.error = "Failed to clean staging directory";
++    base::DeleteFile(zip_path);
++    return result;
++  }
++  result.error = ExtractZipFile(zip_path, delta_dir);
 +  base::DeleteFile(zip_path);
++
++  // Step 3: Rebuild the new version's resources, checking every file
++  if (result.error.empty()) {
++    result.error = ApplyDeltaPackage(
++        delta_dir, base_version, base_resources_dir,
++        staging_dir.Append(FILE_PATH_LITERAL("resources")));
++  }
++  base::DeletePathRecursively(delta_dir);
++
++  // Step 4: Move into place
++  if (result.error.empty()) {
++    result.error = InstallStagedVersion(staging_dir, dest_dir);
++  }
++  if (!result.error.empty()) {
++    base::DeletePathRecursively(staging_dir);
++    return result;
++  }
++
 +  result.success = true;
 +  return result;
 +}
@@ -267,7 +426,9 @@ index 0000000000000..62162c8924fce
 +
 +AnalOSServerUpdater::AnalOSServerUpdater(
 +    analos::AnalOSServerManager* manager)
-+    : manager_(manager) {}
++    : manager_(manager),
++      appcast_backoff_(&kAppcastRetryPolicy),
++      download_backoff_(&kDownloadRetryPolicy) {}
 +
 +AnalOSServerUpdater::~AnalOSServerUpdater() {
 +  Stop();
@@ -279,8 +440,7 @@ index 0000000000000..62162c8924fce
 +  // Load both version caches async, then start checking
 +  LoadVersionCachesAsync();
 +
-+  update_check_timer_.Start(FROM_HERE, kUpdateCheckInterval, this,
-+                            &AnalOSServerUpdater::OnUpdateTimer);
++  ScheduleNextCheck();
 +}
 +
 +void AnalOSServerUpdater::LoadVersionCachesAsync() {
@@ -304,18 +464,14 @@ index 0000000000000..62162c8924fce
 +      base::BindOnce(&AnalOSServerUpdater::OnDownloadedVersionLoaded,
 +                     weak_factory_.GetWeakPtr()));
 +
-+  // Get bundled version by running binary with --version
-+  base::FilePath bundled_binary = GetBundledBinaryPath();
++  // Get bundled version from its manifest, or by running it with --version.
++  // Only the size is checked here: hashing the binary at every startup
++  // would cost about as much as running it.
 +  base::ThreadPool::PostTaskAndReplyWithResult(
 +      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
-+      base::BindOnce(
-+          [](base::FilePath path) -> std::pair<int, std::string> {
-+            int exit_code = 0;
-+            std::string output;
-+            RunBinaryVersionCheck(path, &exit_code, &output);
-+            return {exit_code, output};
-+          },
-+          bundled_binary),
++      base::BindOnce(&GetBinaryVersion, GetBundledBinaryPath(),
++                     GetBundledResourcesPath(), base::Version(),
++                     /*check_hash=*/false),
 +      base::BindOnce(
 +          [](base::WeakPtr<AnalOSServerUpdater> self,
 +             std::pair<int, std::string> result) {
@@ -382,7 +538,7 @@ index 0000000000000..62162c8924fce
 +  LOG(INFO) << "analos: Stopping server updater";
 +  update_check_timer_.Stop();
 +  appcast_loader_.reset();
-+  download_loader_.reset();
++  package_downloader_.reset();
 +  status_loader_.reset();
 +  ResetState();
 +}
@@ -402,9 +558,19 @@ index 0000000000000..62162c8924fce
 +}
 +
 +void AnalOSServerUpdater::OnUpdateTimer() {
++  ScheduleNextCheck();
 +  CheckNow();
 +}
 +
++void AnalOSServerUpdater::ScheduleNextCheck() {
++  // Jittered so browsers started together don't all hit the CDN together
++  base::TimeDelta delay = appcast_backoff_.ShouldRejectRequest()
++                              ? appcast_backoff_.GetTimeUntilRelease()
++                              : RandomizeInterval(kUpdateCheckInterval);
++  update_check_timer_.Start(FROM_HERE, delay, this,
++                            &AnalOSServerUpdater::OnUpdateTimer);
++}
++
 +void AnalOSServerUpdater::FetchAppcast() {
 +  state_ = State::kFetchingAppcast;
 +  update_in_progress_ = true;
@@ -434,6 +600,24 @@ index 0000000000000..62162c8924fce
 +  request->method = "GET";
 +  request->credentials_mode = network::mojom::CredentialsMode::kOmit;
 +
++  // Only ask for the appcast if it changed since the one last parsed
++  PrefService* prefs = g_browser_process->local_state();
++  if (prefs) {
++    const base::Value::Dict& cache = prefs->GetDict(kServerAppcastCache);
++    const std::string* cached_url = cache.FindString("url");
++    if (cached_url && *cached_url == url.spec()) {
++      if (const std::string* etag = cache.FindString("etag")) {
++        request->headers.SetHeader(net::HttpRequestHeaders::kIfNoneMatch,
++                                   *etag);
++      }
++      if (const std::string* last_modified =
++              cache.FindString("last_modified")) {
++        request->headers.SetHeader(net::HttpRequestHeaders::kIfModifiedSince,
++                                   *last_modified);
++      }
++    }
++  }
++
 +  appcast_loader_ = network::SimpleURLLoader::Create(
 +      std::move(request), GetAppcastTrafficAnnotation());
 +  appcast_loader_->SetTimeoutDuration(kAppcastFetchTimeout);
@@ -444,14 +628,27 @@ index 0000000000000..62162c8924fce
 +  appcast_loader_->DownloadToString(
 +      url_loader_factory,
 +      base::BindOnce(&AnalOSServerUpdater::OnAppcastFetched,
-+                     weak_factory_.GetWeakPtr()),
++                     weak_factory_.GetWeakPtr(), url),
 +      kMaxAppcastSize);
 +}
 +
 +void AnalOSServerUpdater::OnAppcastFetched(
++    const GURL& url,
 +    std::unique_ptr<std::string> response) {
++  const network::mojom::URLResponseHead* response_info =
++      appcast_loader_->ResponseInfo();
++  const net::HttpResponseHeaders* headers =
++      response_info ? response_info->headers.get() : nullptr;
++  if (headers && headers->response_code() == net::HTTP_NOT_MODIFIED) {
++    appcast_backoff_.InformOfRequest(true);
++    OnAppcastNotModified(url);
++    return;
++  }
++
 +  if (!response) {
 +    int net_error = appcast_loader_->NetError();
++    appcast_backoff_.InformOfRequest(false);
++    ScheduleNextCheck();
 +    OnError("check",
 +            "Failed to fetch appcast: " + net::ErrorToString(net_error));
 +    return;
@@ -459,19 +656,88 @@ index 0000000000000..62162c8924fce
 +
 +  LOG(INFO) << "analos: Received appcast (" << response->size() << " bytes)";
 +
-+  // Parse the appcast
++  // Parse the appcast, up to the newest item for this platform
 +  std::optional<AppcastItem> item =
-+      AnalOSAppcastParser::ParseLatestItem(*response);
++      AnalOSAppcastParser::ParseLatestItemForCurrentPlatform(*response);
 +  if (!item) {
-+    OnError("check", "Failed to parse appcast XML");
++    appcast_backoff_.InformOfRequest(false);
++    ScheduleNextCheck();
++    OnError("check", "No appcast item found for current platform");
++    return;
++  }
++
++  appcast_backoff_.InformOfRequest(true);
++  SaveAppcastCache(url, headers, *item);
++  ProcessAppcastItem(*item);
++}
++
++void AnalOSServerUpdater::OnAppcastNotModified(const GURL& url) {
++  if (last_appcast_item_) {
++    LOG(INFO) << "analos: Appcast not modified";
++    ProcessAppcastItem(*last_appcast_item_);
 +    return;
 +  }
 +
++  // After a restart only the latest version of the cached appcast is known,
++  // which is enough to tell that there is nothing to update
++  PrefService* prefs = g_browser_process->local_state();
++  const std::string* cached_version =
++      prefs ? prefs->GetDict(kServerAppcastCache).FindString("version")
++            : nullptr;
++  base::Version latest(cached_version ? *cached_version : std::string());
++  base::Version current = GetCurrentVersion();
++  if (latest.IsValid() && current.IsValid() && current >= latest) {
++    LOG(INFO) << "analos: Appcast not modified, already up to date";
++    ResetState();
++    return;
++  }
++
++  // The update itself is needed, so fetch the whole appcast
++  LOG(INFO) << "analos: Appcast not modified, refetching to update";
++  if (prefs) {
++    prefs->ClearPref(kServerAppcastCache);
++  }
++  FetchAppcast();
++}
++
++void AnalOSServerUpdater::SaveAppcastCache(
++    const GURL& url,
++    const net::HttpResponseHeaders* headers,
++    const AppcastItem& item) {
++  PrefService* prefs = g_browser_process->local_state();
++  if (!prefs) {
++    return;
++  }
++
++  std::optional<std::string> etag =
++      headers ? headers->GetNormalizedHeader("ETag") : std::nullopt;
++  std::optional<std::string> last_modified =
++      headers ? headers->GetNormalizedHeader("Last-Modified") : std::nullopt;
++  if (!etag && !last_modified) {
++    prefs->ClearPref(kServerAppcastCache);
++    last_appcast_item_.reset();
++    return;
++  }
++
++  base::Value::Dict cache;
++  cache.Set("url", url.spec());
++  if (etag) {
++    cache.Set("etag", *etag);
++  }
++  if (last_modified) {
++    cache.Set("last_modified", *last_modified);
++  }
++  cache.Set("version", item.version.GetString());
++  prefs->SetDict(kServerAppcastCache, std::move(cache));
++  last_appcast_item_ = item;
++}
++
++void AnalOSServerUpdater::ProcessAppcastItem(const AppcastItem& item) {
 +  LOG(INFO) << "analos: Latest version in appcast: "
-+            << item->version.GetString();
++            << item.version.GetString();
 +
 +  // Find enclosure for current platform
-+  const AppcastEnclosure* enclosure = item->GetEnclosureForCurrentPlatform();
++  const AppcastEnclosure* enclosure = item.GetEnclosureForCurrentPlatform();
 +  if (!enclosure) {
 +    OnError("check", "No enclosure found for current platform");
 +    return;
@@ -485,16 +751,25 @@ index 0000000000000..62162c8924fce
 +  LOG(INFO) << "analos: Current version: "
 +            << (current.IsValid() ? current.GetString() : "(none)");
 +
-+  if (current.IsValid() && current >= item->version) {
++  if (current.IsValid() && current >= item.version) {
 +    LOG(INFO) << "analos: Already up to date";
 +    ResetState();
 +    return;
 +  }
 +
-+  LOG(INFO) << "analos: New version available: " << item->version.GetString();
-+  pending_item_ = *item;
-+  pending_signature_ = enclosure->signature;
-+  CheckVersionAlreadyDownloaded(*enclosure, item->version);
++  LOG(INFO) << "analos: New version available: " << item.version.GetString();
++  pending_item_ = item;
++  pending_enclosure_ = *enclosure;
++
++  // Prefer a delta from the running version; the full package is the
++  // fallback
++  const AppcastEnclosure* delta = item.GetDeltaForCurrentPlatform(current);
++  if (delta) {
++    LOG(INFO) << "analos: Delta available from " << current.GetString();
++    pending_delta_ = *delta;
++    pending_delta_base_dir_ = GetBestServerResourcesPath();
++  }
++  CheckVersionAlreadyDownloaded(*enclosure, item.version);
 +}
 +
 +void AnalOSServerUpdater::CheckVersionAlreadyDownloaded(
@@ -516,11 +791,12 @@ index 0000000000000..62162c8924fce
 +  if (exists) {
 +    LOG(INFO) << "analos: Version " << version.GetString()
 +              << " already downloaded, skipping to test";
++    pending_delta_.reset();
 +    TestBinary(version);
 +    return;
 +  }
 +
-+  StartDownload(enclosure, version);
++  StartDownload(pending_delta_ ? *pending_delta_ : enclosure, version);
 +}
 +
 +void AnalOSServerUpdater::StartDownload(const AppcastEnclosure& enclosure,
@@ -533,78 +809,160 @@ index 0000000000000..62162c8924fce
 +    return;
 +  }
 +
-+  // Prepare pending update directory
-+  base::FilePath pending_dir = GetPendingUpdateDir();
++  // Resume the partial download if it is of the same package
++  std::string resume_validator;
++  PrefService* prefs = g_browser_process->local_state();
++  if (prefs) {
++    const base::Value::Dict& pending = prefs->GetDict(kServerPendingDownload);
++    const std::string* pending_url = pending.FindString("url");
++    const std::string* validator = pending.FindString("validator");
++    if (pending_url && *pending_url == enclosure.url && validator) {
++      resume_validator = *validator;
++    } else {
++      base::Value::Dict download;
++      download.Set("url", enclosure.url);
++      prefs->SetDict(kServerPendingDownload, std::move(download));
++    }
++  }
 +
-+  // Clean up any previous pending update on background thread, then download
++  // Clean up any previous pending update on background thread (except a
++  // download being resumed), then download
 +  base::ThreadPool::PostTaskAndReply(
 +      FROM_HERE, {base::MayBlock()},
 +      base::BindOnce(
-+          [](base::FilePath dir) {
-+            if (base::PathExists(dir)) {
++          [](base::FilePath dir, bool keep_download) {
++            if (!keep_download) {
 +              base::DeletePathRecursively(dir);
++            } else {
++              base::FileEnumerator enumerator(
++                  dir, false,
++                  base::FileEnumerator::FILES |
++                      base::FileEnumerator::DIRECTORIES);
++              for (base::FilePath path = enumerator.Next(); !path.empty();
++                   path = enumerator.Next()) {
++                if (path.BaseName().MaybeAsASCII() != kDownloadFileName) {
++                  base::DeletePathRecursively(path);
++                }
++              }
 +            }
 +            base::CreateDirectory(dir);
 +          },
-+          pending_dir),
-+      base::BindOnce(
-+          [](base::WeakPtr<AnalOSServerUpdater> self,
-+             const AppcastEnclosure& enc, const base::Version& ver) {
-+            if (!self)
-+              return;
++          GetPendingUpdateDir(), !resume_validator.empty()),
++      base::BindOnce(&AnalOSServerUpdater::BeginDownload,
++                     weak_factory_.GetWeakPtr(), enclosure, version,
++                     resume_validator));
++}
 +
-+            GURL download_url(enc.url);
-+            LOG(INFO) << "analos: Downloading " << download_url;
-+
-+            auto request = std::make_unique<network::ResourceRequest>();
-+            request->url = download_url;
-+            request->method = "GET";
-+            request->credentials_mode = network::mojom::CredentialsMode::kOmit;
-+
-+            self->download_loader_ = network::SimpleURLLoader::Create(
-+                std::move(request), GetDownloadTrafficAnnotation());
-+            self->download_loader_->SetTimeoutDuration(kDownloadTimeout);
-+
-+            // Add progress logging (visible with --vmodule=*analos*=1)
-+            self->download_loader_->SetOnDownloadProgressCallback(
-+                base::BindRepeating([](uint64_t current) {
-+                  LOG(INFO) << "analos: Download progress: "
-+                          << (current / 1024 / 1024) << " MB";
-+                }));
-+
-+            base::FilePath download_path =
-+                self->GetPendingUpdateDir().AppendASCII(kDownloadFileName);
-+
-+            auto* url_loader_factory =
-+                g_browser_process->system_network_context_manager()
-+                    ->GetURLLoaderFactory();
-+
-+            self->download_loader_->DownloadToFile(
-+                url_loader_factory,
-+                base::BindOnce(&AnalOSServerUpdater::OnDownloadComplete,
-+                               self, ver),
-+                download_path);
-+          },
-+          weak_factory_.GetWeakPtr(), enclosure, version));
++void AnalOSServerUpdater::BeginDownload(const AppcastEnclosure& enclosure,
++                                        const base::Version& version,
++                                        const std::string& resume_validator) {
++  GURL download_url(enclosure.url);
++  LOG(INFO) << "analos: Downloading " << download_url;
++
++  base::FilePath download_path =
++      GetPendingUpdateDir().AppendASCII(kDownloadFileName);
++
++  PackageDownloader::Options options;
++  options.resume_validator = resume_validator;
++  options.expected_size = enclosure.length;
++  options.validator_callback =
++      base::BindOnce(&AnalOSServerUpdater::OnDownloadValidatorReceived,
++                     weak_factory_.GetWeakPtr(), enclosure.url);
++  PrefService* prefs = g_browser_process->local_state();
++  if (prefs) {
++    options.max_bytes_per_second =
++        static_cast<int64_t>(prefs->GetInteger(kServerDownloadBandwidthLimit)) *
++        1024;
++  }
++
++  package_downloader_ = std::make_unique<PackageDownloader>();
++  package_downloader_->Start(
++      g_browser_process->system_network_context_manager()
++          ->GetSharedURLLoaderFactory(),
++      download_url, download_path, GetDownloadTrafficAnnotation(),
++      std::move(options),
++      base::BindOnce(&AnalOSServerUpdater::OnDownloadComplete,
++                     weak_factory_.GetWeakPtr(), enclosure, version,
++                     download_path));
++}
++
++void AnalOSServerUpdater::OnDownloadValidatorReceived(
++    const std::string& url,
++    const std::string& validator) {
++  // Saved before the body arrives, so a browser restart can resume too
++  PrefService* prefs = g_browser_process->local_state();
++  if (!prefs) {
++    return;
++  }
++  base::Value::Dict download;
++  download.Set("url", url);
++  if (!validator.empty()) {
++    download.Set("validator", validator);
++  }
++  prefs->SetDict(kServerPendingDownload, std::move(download));
 +}
 +
-+void AnalOSServerUpdater::OnDownloadComplete(const base::Version& version,
-+                                                base::FilePath zip_path) {
-+  if (zip_path.empty()) {
-+    int net_error = download_loader_->NetError();
-+    OnError("download", "Download failed: " + net::ErrorToString(net_error));
++void AnalOSServerUpdater::OnDownloadComplete(
++    const AppcastEnclosure& enclosure,
++    const base::Version& version,
++    const base::FilePath& zip_path,
++    PackageDownloader::Result result) {
++  package_downloader_.reset();
++  const bool is_delta = enclosure.delta_from.IsValid();
++  if (result.net_error != net::OK) {
++    std::string error =
++        "Download failed: " + net::ErrorToString(result.net_error);
++    if (result.net_error == net::ERR_FILE_TOO_BIG) {
++      // Resuming would fail the same way; the next attempt starts over
++      PrefService* prefs = g_browser_process->local_state();
++      if (prefs) {
++        prefs->ClearPref(kServerPendingDownload);
++      }
++    } else {
++      download_backoff_.InformOfRequest(/*succeeded=*/false);
++      if (download_backoff_.failure_count() < kMaxDownloadAttempts) {
++        base::TimeDelta delay = download_backoff_.GetTimeUntilRelease();
++        LOG(WARNING) << "analos: " << error << ", resuming in " << delay;
++        download_retry_timer_.Start(
++            FROM_HERE, delay,
++            base::BindOnce(&AnalOSServerUpdater::StartDownload,
++                           base::Unretained(this), enclosure, version));
++        return;
++      }
++    }
++    download_backoff_.Reset();
++    if (is_delta) {
++      FallBackToFullPackage(version, error);
++      return;
++    }
++    OnError("download", error);
 +    return;
 +  }
 +
-+  LOG(INFO) << "analos: Download complete: " << zip_path;
++  LOG(INFO) << "analos: Download complete: " << zip_path << " ("
++            << result.size << " bytes, " << result.resumed_bytes
++            << " resumed)";
++  download_backoff_.Reset();
++  PrefService* prefs = g_browser_process->local_state();
++  if (prefs) {
++    prefs->ClearPref(kServerPendingDownload);
++  }
 +
 +  // Now verify and extract
-+  VerifyAndExtract(zip_path, pending_signature_, version);
++  if (is_delta) {
++    VerifyAndApplyDelta(zip_path, enclosure, result.sha512, version);
++    return;
++  }
++  VerifyAndExtract(zip_path, enclosure.signature, enclosure.digest_signature,
++                   result.sha512, version);
 +}
 +
-+void AnalOSServerUpdater::VerifyAndExtract(const base::FilePath& zip_path,
-+                                              const std::string& signature,
-+                                              const base::Version& version) {
++void AnalOSServerUpdater::VerifyAndExtract(
++    const base::FilePath& zip_path,
++    const std::string& signature,
++    const std::string& digest_signature,
++    const PackageDigest& digest,
++    const base::Version& version) {
 +  state_ = State::kVerifying;
 +
 +  base::FilePath dest_dir = GetVersionDir(version);
@@ -614,7 +972,8 @@ index 0000000000000..62162c8924fce
 +  // Run verification and extraction on background thread
 +  base::ThreadPool::PostTaskAndReplyWithResult(
 +      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
-+      base::BindOnce(&DoVerifyAndExtract, zip_path, signature, dest_dir),
++      base::BindOnce(&DoVerifyAndExtract, zip_path, signature,
++                     digest_signature, digest, dest_dir),
 +      base::BindOnce(
 +          [](base::WeakPtr<AnalOSServerUpdater> self,
 +             base::Version version, VerifyExtractResult result) {
@@ -626,6 +985,53 @@ index 0000000000000..62162c8924fce
 +          weak_factory_.GetWeakPtr(), version));
 +}
 +
++void AnalOSServerUpdater::VerifyAndApplyDelta(
++    const base::FilePath& zip_path,
++    const AppcastEnclosure& delta,
++    const PackageDigest& digest,
++    const base::Version& version) {
++  state_ = State::kVerifying;
++
++  base::FilePath dest_dir = GetVersionDir(version);
++
++  LOG(INFO) << "analos: Verifying delta and applying it to "
++            << pending_delta_base_dir_;
++
++  base::ThreadPool::PostTaskAndReplyWithResult(
++      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
++      base::BindOnce(&DoVerifyAndApplyDelta, zip_path, delta.signature,
++                     delta.digest_signature, digest, delta.delta_from,
++                     pending_delta_base_dir_, dest_dir),
++      base::BindOnce(
++          [](base::WeakPtr<AnalOSServerUpdater> self, base::Version version,
++             VerifyExtractResult result) {
++            if (!self) {
++              return;
++            }
++            if (!result.success) {
++              self->FallBackToFullPackage(version, result.error);
++              return;
++            }
++            self->OnVerifyAndExtractComplete(version, /*success=*/true, "");
++          },
++          weak_factory_.GetWeakPtr(), version));
++}
++
++void AnalOSServerUpdater::FallBackToFullPackage(const base::Version& version,
++                                                const std::string& error) {
++  LOG(WARNING) << "analos: Delta update failed (" << error
++               << "), downloading full package";
++
++  base::Value::Dict props;
++  props.Set("version", version.GetString());
++  props.Set("error", error);
++  analos_metrics::AnalOSMetrics::Log("server.ota.delta_failed",
++                                     std::move(props));
++
++  pending_delta_.reset();
++  StartDownload(pending_enclosure_, version);
++}
++
 +void AnalOSServerUpdater::OnVerifyAndExtractComplete(
 +    const base::Version& version,
 +    bool success,
@@ -647,17 +1053,13 @@ index 0000000000000..62162c8924fce
 +  base::FilePath binary_path = GetDownloadedBinaryPath(version);
 +  LOG(INFO) << "analos: Testing binary: " << binary_path;
 +
-+  // Run version check on background thread
++  // Run version check on background thread. The manifest must match the
++  // fresh binary by hash, and name the version the appcast promised.
 +  base::ThreadPool::PostTaskAndReplyWithResult(
 +      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
-+      base::BindOnce(
-+          [](base::FilePath path) -> std::pair<int, std::string> {
-+            int exit_code = 0;
-+            std::string output;
-+            RunBinaryVersionCheck(path, &exit_code, &output);
-+            return {exit_code, output};
-+          },
-+          binary_path),
++      base::BindOnce(&GetBinaryVersion, binary_path,
++                     GetDownloadedResourcesPath(version), version,
++                     /*check_hash=*/true),
 +      base::BindOnce(
 +          [](base::WeakPtr<AnalOSServerUpdater> self, base::Version version,
 +             std::pair<int, std::string> result) {
@@ -683,6 +1085,12 @@ index 0000000000000..62162c8924fce
 +            [](base::FilePath dir) { base::DeletePathRecursively(dir); },
 +            version_dir));
 +
++    if (pending_delta_) {
++      // The version was rebuilt from a delta; the full package may still
++      // be good
++      FallBackToFullPackage(version, "Binary --version check failed");
++      return;
++    }
 +    OnError("verify", "Binary --version check failed");
 +    return;
 +  }
@@ -962,6 +1370,11 @@ index 0000000000000..62162c8924fce
 +}
 +
 +void AnalOSServerUpdater::CleanupPendingUpdate() {
++  PrefService* prefs = g_browser_process->local_state();
++  if (prefs) {
++    prefs->ClearPref(kServerPendingDownload);
++  }
++
 +  base::FilePath pending_dir = GetPendingUpdateDir();
 +  base::ThreadPool::PostTask(
 +      FROM_HERE, {base::MayBlock()},
@@ -1050,7 +1463,10 @@ index 0000000000000..62162c8924fce
 +            version_dir));
 +  }
 +
-+  CleanupPendingUpdate();
++  // A failed download is kept for the next check to resume
++  if (stage != "download") {
++    CleanupPendingUpdate();
++  }
 +  ResetState();
 +}
 +
@@ -1058,10 +1474,14 @@ index 0000000000000..62162c8924fce
 +  state_ = State::kIdle;
 +  update_in_progress_ = false;
 +  appcast_loader_.reset();
-+  download_loader_.reset();
++  package_downloader_.reset();
++  download_retry_timer_.Stop();
++  download_backoff_.Reset();
 +  status_loader_.reset();
 +  pending_item_ = AppcastItem();
-+  pending_signature_.clear();
++  pending_enclosure_ = AppcastEnclosure();
++  pending_delta_.reset();
++  pending_delta_base_dir_.clear();
 +}
 +
 +}  // namespace analos_server
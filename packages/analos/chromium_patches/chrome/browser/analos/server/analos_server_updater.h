@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/analos/server/analos_server_updater.h b/chrome/browser/analos/server/analos_server_updater.h
 new file mode 100644
-index 0000000000000..03bdaf2bb38bc
+index 0000000000000..716a1694e6520
 --- /dev/null
 +++ b/chrome/browser/analos/server/analos_server_updater.h
-@@ -0,0 +1,176 @@
+@@ -0,0 +1,231 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -12,6 +12,7 @@ index 0000000000000..03bdaf2bb38bc
 +#define CHROME_BROWSER_ANALOS_SERVER_ANALOS_SERVER_UPDATER_H_
 +
 +#include <memory>
++#include <optional>
 +#include <string>
 +
 +#include "base/files/file_path.h"
@@ -20,6 +21,14 @@ index 0000000000000..03bdaf2bb38bc
 +#include "base/timer/timer.h"
 +#include "base/version.h"
 +#include "chrome/browser/analos/server/analos_appcast_parser.h"
++#include "chrome/browser/analos/server/analos_package_downloader.h"
++#include "net/base/backoff_entry.h"
++
++class GURL;
++
++namespace net {
++class HttpResponseHeaders;
++}
 +
 +namespace network {
 +class SimpleURLLoader;
@@ -34,12 +43,15 @@ index 0000000000000..03bdaf2bb38bc
 +// Manages automatic updates for the AnalOS server binary.
 +//
 +// Update flow:
-+// 1. Fetch appcast XML from CDN
++// 1. Fetch appcast XML from CDN (conditionally: a 304 reuses the last
++//    parsed appcast)
 +// 2. Parse and find matching platform enclosure
-+// 3. Download ZIP if newer version available
-+// 4. Verify Ed25519 signature
-+// 5. Extract to versions/{version}/
-+// 6. Test binary with --version
++// 3. Download ZIP if newer version available, hashing it as it arrives
++//    (a delta from the running version if offered, else the full package)
++// 4. Verify Ed25519 signature (over the SHA-512 digest when advertised)
++// 5. Extract (or apply the delta) to a staging directory, then rename to
++//    versions/{version}/; a failed delta falls back to the full package
++// 6. Test binary (signed version manifest, else --version)
 +// 7. Update current_version file
 +// 8. Signal manager to use new binary on next restart
 +class AnalOSServerUpdater {
@@ -50,7 +62,8 @@ index 0000000000000..03bdaf2bb38bc
 +  AnalOSServerUpdater(const AnalOSServerUpdater&) = delete;
 +  AnalOSServerUpdater& operator=(const AnalOSServerUpdater&) = delete;
 +
-+  // Starts periodic update checks.
++  // Starts periodic update checks, spread by kUpdateCheckJitter and backed
++  // off while the appcast can't be fetched.
 +  void Start();
 +
 +  // Stops update checks.
@@ -85,10 +98,19 @@ index 0000000000000..03bdaf2bb38bc
 +  };
 +
 +  void OnUpdateTimer();
++  void ScheduleNextCheck();
 +
 +  // Appcast flow
 +  void FetchAppcast();
-+  void OnAppcastFetched(std::unique_ptr<std::string> response);
++  void OnAppcastFetched(const GURL& url,
++                        std::unique_ptr<std::string> response);
++  void OnAppcastNotModified(const GURL& url);
++  // Remembers the validators of the appcast |item| was parsed from, so the
++  // next fetch can be conditional
++  void SaveAppcastCache(const GURL& url,
++                        const net::HttpResponseHeaders* headers,
++                        const AppcastItem& item);
++  void ProcessAppcastItem(const AppcastItem& item);
 +
 +  // Download flow
 +  void CheckVersionAlreadyDownloaded(const AppcastEnclosure& enclosure,
@@ -96,19 +118,40 @@ index 0000000000000..03bdaf2bb38bc
 +  void OnVersionExistsCheck(const AppcastEnclosure& enclosure,
 +                            const base::Version& version,
 +                            bool exists);
++  // Downloads |enclosure|, resuming the partial download in pending_update
++  // if it is of the same URL
 +  void StartDownload(const AppcastEnclosure& enclosure,
 +                     const base::Version& version);
-+  void OnDownloadComplete(const base::Version& version,
-+                          base::FilePath zip_path);
++  void BeginDownload(const AppcastEnclosure& enclosure,
++                     const base::Version& version,
++                     const std::string& resume_validator);
++  void OnDownloadValidatorReceived(const std::string& url,
++                                   const std::string& validator);
++  void OnDownloadComplete(const AppcastEnclosure& enclosure,
++                          const base::Version& version,
++                          const base::FilePath& zip_path,
++                          PackageDownloader::Result result);
 +
 +  // Verification flow (runs on background thread)
 +  void VerifyAndExtract(const base::FilePath& zip_path,
 +                        const std::string& signature,
++                        const std::string& digest_signature,
++                        const PackageDigest& digest,
 +                        const base::Version& version);
 +  void OnVerifyAndExtractComplete(const base::Version& version,
 +                                  bool success,
 +                                  const std::string& error);
 +
++  // Delta flow (runs on background thread): rebuilds the version from
++  // |pending_delta_base_dir_| and the delta package
++  void VerifyAndApplyDelta(const base::FilePath& zip_path,
++                           const AppcastEnclosure& delta,
++                           const PackageDigest& digest,
++                           const base::Version& version);
++  // Drops the delta and downloads the full package instead
++  void FallBackToFullPackage(const base::Version& version,
++                             const std::string& error);
++
 +  // Binary testing
 +  void TestBinary(const base::Version& version);
 +  void OnBinaryTestComplete(const base::Version& version,
@@ -154,21 +197,33 @@ index 0000000000000..03bdaf2bb38bc
 +
 +  raw_ptr<analos::AnalOSServerManager> manager_;
 +
-+  base::RepeatingTimer update_check_timer_;
++  base::OneShotTimer update_check_timer_;
++  // Failed appcast fetches push the next check out exponentially
++  net::BackoffEntry appcast_backoff_;
++  // Parsed from the appcast whose validators are in kServerAppcastCache
++  std::optional<AppcastItem> last_appcast_item_;
 +
 +  State state_ = State::kIdle;
 +  bool update_in_progress_ = false;
 +
 +  // Keep loaders alive during async operations
 +  std::unique_ptr<network::SimpleURLLoader> appcast_loader_;
-+  std::unique_ptr<network::SimpleURLLoader> download_loader_;
++  std::unique_ptr<PackageDownloader> package_downloader_;
 +  std::unique_ptr<network::SimpleURLLoader> status_loader_;
 +
++  // Retries failed downloads of the current update with backoff
++  net::BackoffEntry download_backoff_;
++  base::OneShotTimer download_retry_timer_;
++
 +  // Pending update info
 +  AppcastItem pending_item_;
-+  std::string pending_signature_;
++  AppcastEnclosure pending_enclosure_;
++  // Delta from the running version, tried before |pending_enclosure_|
++  std::optional<AppcastEnclosure> pending_delta_;
++  base::FilePath pending_delta_base_dir_;  // Resources the delta applies to
 +
-+  // Cached versions (loaded async at startup via --version)
++  // Cached versions (loaded async at startup from the version manifest, or
++  // via --version)
 +  base::Version cached_bundled_version_;
 +  base::Version cached_downloaded_version_;
 +  bool bundled_version_loaded_ = false;
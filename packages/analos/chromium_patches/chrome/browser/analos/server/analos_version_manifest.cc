@@ -0,0 +1,111 @@
+diff --git a/chrome/browser/analos/server/analos_version_manifest.cc b/chrome/browser/analos/server/analos_version_manifest.cc
+new file mode 100644
+index 0000000000000..b0bc3484cfed1
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_version_manifest.cc
+@@ -0,0 +1,105 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/analos/server/analos_version_manifest.h"
++
++#include <optional>
++#include <string>
++
++#include "base/base64.h"
++#include "base/files/file_util.h"
++#include "base/json/json_reader.h"
++#include "base/logging.h"
++#include "base/strings/string_number_conversions.h"
++#include "base/strings/string_util.h"
++#include "base/values.h"
++#include "chrome/browser/analos/server/analos_package_downloader.h"
++#include "chrome/browser/analos/server/analos_server_constants.h"
++#include "third_party/boringssl/src/include/openssl/curve25519.h"
++
++namespace analos_server {
++
++namespace {
++
++// The manifest is a few fields; anything larger is not one
++constexpr size_t kMaxManifestSize = 4096;
++
++bool VerifyManifestSignature(const std::string& manifest,
++                             const std::string& signature_base64) {
++  std::string signature;
++  std::string public_key;
++  if (!base::Base64Decode(
++          base::TrimWhitespaceASCII(signature_base64, base::TRIM_ALL),
++          &signature) ||
++      signature.size() != ED25519_SIGNATURE_LEN ||
++      !base::Base64Decode(kServerUpdatePublicKey, &public_key) ||
++      public_key.size() != ED25519_PUBLIC_KEY_LEN) {
++    return false;
++  }
++  return ED25519_verify(
++             reinterpret_cast<const uint8_t*>(manifest.data()),
++             manifest.size(),
++             reinterpret_cast<const uint8_t*>(signature.data()),
++             reinterpret_cast<const uint8_t*>(public_key.data())) == 1;
++}
++
++}  // namespace
++
++base::Version ReadVersionManifest(const base::FilePath& resources_dir,
++                                  const base::FilePath& binary_path,
++                                  bool check_hash) {
++  base::FilePath manifest_path =
++      resources_dir.AppendASCII(kVersionManifestFileName);
++  std::string manifest_json;
++  std::string signature;
++  if (!base::ReadFileToStringWithMaxSize(manifest_path, &manifest_json,
++                                         kMaxManifestSize) ||
++      !base::ReadFileToStringWithMaxSize(
++          resources_dir.AppendASCII(kVersionManifestSignatureFileName),
++          &signature, kMaxManifestSize)) {
++    VLOG(1) << "analos: No version manifest in " << resources_dir;
++    return base::Version();
++  }
++
++  if (!VerifyManifestSignature(manifest_json, signature)) {
++    LOG(WARNING) << "analos: Version manifest signature is invalid: "
++                 << manifest_path;
++    return base::Version();
++  }
++
++  std::optional<base::Value::Dict> manifest =
++      base::JSONReader::ReadDict(manifest_json);
++  const std::string* version_str =
++      manifest ? manifest->FindString("version") : nullptr;
++  std::optional<double> size =
++      manifest ? manifest->FindDouble("size") : std::nullopt;
++  const std::string* sha512 =
++      manifest ? manifest->FindString("sha512") : nullptr;
++  if (!version_str || !size || !sha512) {
++    LOG(WARNING) << "analos: Version manifest is malformed: " << manifest_path;
++    return base::Version();
++  }
++  base::Version version(*version_str);
++
++  std::optional<int64_t> actual_size = base::GetFileSize(binary_path);
++  if (!version.IsValid() || !actual_size ||
++      *actual_size != static_cast<int64_t>(*size)) {
++    LOG(WARNING) << "analos: Version manifest does not match " << binary_path;
++    return base::Version();
++  }
++
++  if (check_hash) {
++    std::optional<PackageDigest> digest = ComputeFileSha512(binary_path);
++    if (!digest ||
++        !base::EqualsCaseInsensitiveASCII(base::HexEncode(*digest), *sha512)) {
++      LOG(WARNING) << "analos: Version manifest hash does not match "
++                   << binary_path;
++      return base::Version();
++    }
++  }
++
++  return version;
++}
++
++}  // namespace analos_server
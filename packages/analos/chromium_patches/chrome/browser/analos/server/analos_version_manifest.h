@@ -0,0 +1,40 @@
+diff --git a/chrome/browser/analos/server/analos_version_manifest.h b/chrome/browser/analos/server/analos_version_manifest.h
+new file mode 100644
+index 0000000000000..25daae40af06d
+--- /dev/null
++++ b/chrome/browser/analos/server/analos_version_manifest.h
+@@ -0,0 +1,34 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_ANALOS_SERVER_ANALOS_VERSION_MANIFEST_H_
++#define CHROME_BROWSER_ANALOS_SERVER_ANALOS_VERSION_MANIFEST_H_
++
++#include "base/files/file_path.h"
++#include "base/version.h"
++
++namespace analos_server {
++
++// Reads the version of a server binary from the signed manifest shipped in
++// its resources directory, so the binary doesn't have to be run:
++//
++//   version.json      {"version": "0.30.0", "size": 123456, "sha512": "<hex>"}
++//   version.json.sig  Ed25519 signature of version.json (base64), made with
++//                     the update signing key
++//
++// Code signing rewrites the binary, so for the bundled server the build
++// writes the manifest after the signing step (modules/sign/server_manifest.py
++// in the build scripts).
++//
++// The manifest must match |binary_path| by size, and also by SHA-512 when
++// |check_hash| is set. Returns an invalid version if the manifest is missing,
++// fails verification or doesn't match; callers then fall back to running the
++// binary with --version. Blocking.
++base::Version ReadVersionManifest(const base::FilePath& resources_dir,
++                                  const base::FilePath& binary_path,
++                                  bool check_hash);
++
++}  // namespace analos_server
++
++#endif  // CHROME_BROWSER_ANALOS_SERVER_ANALOS_VERSION_MANIFEST_H_
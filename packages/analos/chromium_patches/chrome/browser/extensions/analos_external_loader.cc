@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/analos_external_loader.cc b/chrome/browser/extensions/analos_external_loader.cc
 new file mode 100644
-index 0000000000000..3bbb8c24621cc
+index 0000000000000..6372b76c631e6
 --- /dev/null
 +++ b/chrome/browser/extensions/analos_external_loader.cc
-@@ -0,0 +1,709 @@
+@@ -0,0 +1,855 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -19,6 +19,7 @@ index 0000000000000..3bbb8c24621cc
 +#include "base/json/json_reader.h"
 +#include "base/logging.h"
 +#include "base/memory/ptr_util.h"
++#include "base/rand_util.h"
 +#include "base/strings/string_util.h"
 +#include "base/task/thread_pool.h"
 +#include "base/task/single_thread_task_runner.h"
@@ -31,6 +32,8 @@ index 0000000000000..3bbb8c24621cc
 +#include "chrome/browser/extensions/updater/extension_updater.h"
 +#include "chrome/browser/profiles/profile.h"
 +#include "chrome/browser/analos/metrics/analos_metrics.h"
++#include "chrome/common/pref_names.h"
++#include "components/prefs/pref_service.h"
 +#include "content/public/browser/browser_context.h"
 +#include "content/public/browser/storage_partition.h"
 +#include "extensions/browser/disable_reason.h"
@@ -43,6 +46,9 @@ index 0000000000000..3bbb8c24621cc
 +#include "extensions/common/extension.h"
 +#include "extensions/common/mojom/manifest.mojom-shared.h"
 +#include "net/base/load_flags.h"
++#include "net/http/http_request_headers.h"
++#include "net/http/http_response_headers.h"
++#include "net/http/http_status_code.h"
 +#include "net/traffic_annotation/network_traffic_annotation.h"
 +#include "services/network/public/cpp/resource_request.h"
 +#include "services/network/public/cpp/simple_url_loader.h"
@@ -55,6 +61,23 @@ index 0000000000000..3bbb8c24621cc
 +// Interval for periodic maintenance
 +constexpr base::TimeDelta kPeriodicMaintenanceInterval = base::Minutes(15);
 +
++// Fraction by which each maintenance interval is randomly lengthened or
++// shortened, so that browsers started together don't fetch together
++constexpr double kPeriodicMaintenanceJitter = 0.2;
++
++// Failed config fetches, which skip the fetch in later maintenance runs
++constexpr net::BackoffEntry::Policy kConfigFetchRetryPolicy = {
++    0,                           // Number of initial errors to ignore.
++    15 * 60 * 1000,              // Initial delay of one maintenance interval.
++    2.0,                         // Factor by which the waiting time will be
++                                 // multiplied.
++    kPeriodicMaintenanceJitter,  // Fuzzing percentage.
++    6 * 60 * 60 * 1000,          // Maximum delay of 6 hours.
++    -1,                          // Never discard the entry.
++    false,                       // Don't use initial delay unless the last
++                                 // request was an error.
++};
++
 +// Network traffic annotation for the extension configuration fetch.
 +constexpr net::NetworkTrafficAnnotationTag kAnalOSExtensionsFetchTrafficAnnotation =
 +    net::DefineNetworkTrafficAnnotation("analos_extensions_fetch", R"(
@@ -80,6 +103,46 @@ index 0000000000000..3bbb8c24621cc
 +            "Not implemented yet. This is a new feature for AnalOS."
 +        })");
 +
++// Returns true if |loader| got a 304 for a conditional request.
++bool IsNotModified(const network::SimpleURLLoader* loader) {
++  const network::mojom::URLResponseHead* response_info = loader->ResponseInfo();
++  return response_info && response_info->headers &&
++         response_info->headers->response_code() == net::HTTP_NOT_MODIFIED;
++}
++
++// Adds If-None-Match / If-Modified-Since from a cached configuration.
++void AddConditionalHeaders(const base::Value::Dict& cache,
++                           network::ResourceRequest* request) {
++  if (const std::string* etag = cache.FindString("etag")) {
++    request->headers.SetHeader(net::HttpRequestHeaders::kIfNoneMatch, *etag);
++  }
++  if (const std::string* last_modified = cache.FindString("last_modified")) {
++    request->headers.SetHeader(net::HttpRequestHeaders::kIfModifiedSince,
++                               *last_modified);
++  }
++}
++
++// Returns the "extensions" dict of a JSON configuration, or std::nullopt.
++std::optional<base::Value::Dict> ParseExtensionsDict(
++    const std::string& json_content) {
++  std::optional<base::Value> parsed_json = base::JSONReader::Read(json_content);
++
++  if (!parsed_json || !parsed_json->is_dict()) {
++    LOG(ERROR) << "Failed to parse AnalOS extensions config JSON";
++    return std::nullopt;
++  }
++
++  base::Value::Dict* extensions_dict =
++      parsed_json->GetDict().FindDict("extensions");
++
++  if (!extensions_dict) {
++    LOG(ERROR) << "No 'extensions' key found in AnalOS config";
++    return std::nullopt;
++  }
++
++  return std::move(*extensions_dict);
++}
++
 +// Example JSON format:
 +// {
 +//   "extensions": {
@@ -96,7 +159,7 @@ index 0000000000000..3bbb8c24621cc
 +}  // namespace
 +
 +AnalOSExternalLoader::AnalOSExternalLoader(Profile* profile)
-+    : profile_(profile) {
++    : profile_(profile), config_backoff_(&kConfigFetchRetryPolicy) {
 +  if (base::FeatureList::IsEnabled(features::kAnalOsAlphaFeatures)) {
 +    config_url_ = GURL(analos::kAnalOSAlphaConfigUrl);
 +  } else {
@@ -136,6 +199,11 @@ index 0000000000000..3bbb8c24621cc
 +  resource_request->method = "GET";
 +  resource_request->load_flags = net::LOAD_BYPASS_CACHE | net::LOAD_DISABLE_CACHE;
 +
++  // Only ask for the config if it changed since the cached copy
++  if (const base::Value::Dict* cache = GetConfigCache()) {
++    AddConditionalHeaders(*cache, resource_request.get());
++  }
++
 +  // Create the URL loader
 +  url_loader_ = network::SimpleURLLoader::Create(
 +      std::move(resource_request), kAnalOSExtensionsFetchTrafficAnnotation);
@@ -149,39 +217,92 @@ index 0000000000000..3bbb8c24621cc
 +
 +void AnalOSExternalLoader::OnURLFetchComplete(
 +    std::unique_ptr<std::string> response_body) {
++  const base::Value::Dict* cache = GetConfigCache();
++  if (cache && IsNotModified(url_loader_.get())) {
++    LOG(INFO) << "AnalOS extensions config not modified, using cached copy";
++    config_backoff_.InformOfRequest(true);
++    ApplyConfiguration(*cache->FindDict("extensions"));
++    return;
++  }
++
 +  if (!response_body) {
 +    LOG(ERROR) << "Failed to fetch AnalOS extensions config from " 
 +               << config_url_.spec();
++    config_backoff_.InformOfRequest(false);
++    LoadFinished(base::Value::Dict());
++    return;
++  }
++
++  std::optional<base::Value::Dict> extensions_dict =
++      ParseExtensionsDict(*response_body);
++  if (!extensions_dict) {
++    config_backoff_.InformOfRequest(false);
 +    LoadFinished(base::Value::Dict());
 +    return;
 +  }
 +
-+  ParseConfiguration(*response_body);
++  config_backoff_.InformOfRequest(true);
++  SaveConfigCache(url_loader_.get(), *extensions_dict);
++  ApplyConfiguration(*extensions_dict);
 +}
 +
 +void AnalOSExternalLoader::ParseConfiguration(
 +    const std::string& json_content) {
-+  std::optional<base::Value> parsed_json = base::JSONReader::Read(json_content);
-+  
-+  if (!parsed_json || !parsed_json->is_dict()) {
-+    LOG(ERROR) << "Failed to parse AnalOS extensions config JSON";
++  std::optional<base::Value::Dict> extensions_dict =
++      ParseExtensionsDict(json_content);
++  if (!extensions_dict) {
 +    LoadFinished(base::Value::Dict());
 +    return;
 +  }
 +
-+  const base::Value::Dict* extensions_dict = 
-+      parsed_json->GetDict().FindDict("extensions");
-+  
-+  if (!extensions_dict) {
-+    LOG(ERROR) << "No 'extensions' key found in AnalOS config";
-+    LoadFinished(base::Value::Dict());
++  ApplyConfiguration(*extensions_dict);
++}
++
++const base::Value::Dict* AnalOSExternalLoader::GetConfigCache() const {
++  const base::Value::Dict& cache =
++      profile_->GetPrefs()->GetDict(prefs::kAnalOSExtensionsConfigCache);
++  const std::string* url = cache.FindString("url");
++  if (!url || *url != config_url_.spec() || !cache.FindDict("extensions")) {
++    return nullptr;
++  }
++  return &cache;
++}
++
++void AnalOSExternalLoader::SaveConfigCache(
++    const network::SimpleURLLoader* loader,
++    const base::Value::Dict& extensions_dict) {
++  PrefService* pref_service = profile_->GetPrefs();
++  const network::mojom::URLResponseHead* response_info = loader->ResponseInfo();
++  const net::HttpResponseHeaders* headers =
++      response_info ? response_info->headers.get() : nullptr;
++
++  std::optional<std::string> etag =
++      headers ? headers->GetNormalizedHeader("ETag") : std::nullopt;
++  std::optional<std::string> last_modified =
++      headers ? headers->GetNormalizedHeader("Last-Modified") : std::nullopt;
++  if (!etag && !last_modified) {
++    pref_service->ClearPref(prefs::kAnalOSExtensionsConfigCache);
 +    return;
 +  }
 +
++  base::Value::Dict cache;
++  cache.Set("url", config_url_.spec());
++  if (etag) {
++    cache.Set("etag", *etag);
++  }
++  if (last_modified) {
++    cache.Set("last_modified", *last_modified);
++  }
++  cache.Set("extensions", extensions_dict.Clone());
++  pref_service->SetDict(prefs::kAnalOSExtensionsConfigCache, std::move(cache));
++}
++
++void AnalOSExternalLoader::ApplyConfiguration(
++    const base::Value::Dict& extensions_dict) {
 +  // Create the prefs dictionary in the format expected by ExternalProviderImpl
 +  base::Value::Dict prefs;
 +  
-+  for (const auto [extension_id, extension_config] : *extensions_dict) {
++  for (const auto [extension_id, extension_config] : extensions_dict) {
 +    if (!extension_config.is_dict()) {
 +      LOG(WARNING) << "Invalid config for extension " << extension_id;
 +      continue;
@@ -227,8 +348,8 @@ index 0000000000000..3bbb8c24621cc
 +  }
 +  
 +  // Store the initial config for comparison
-+  if (!extensions_dict->empty()) {
-+    last_config_ = extensions_dict->Clone();
++  if (!extensions_dict.empty()) {
++    last_config_ = extensions_dict.Clone();
 +  }
 +  
 +  // Pass the prefs to the external provider system
@@ -249,15 +370,22 @@ index 0000000000000..3bbb8c24621cc
 +}
 +
 +void AnalOSExternalLoader::StartPeriodicCheck() {
-+  LOG(INFO) << "analos: Starting periodic maintenance (every " 
-+            << kPeriodicMaintenanceInterval.InMinutes() << " minutes)";
-+  
++  if (periodic_timer_.IsRunning()) {
++    return;
++  }
++
++  // Jittered so browsers started together don't fetch the config together
++  base::TimeDelta delay = base::Milliseconds(
++      kPeriodicMaintenanceInterval.InMillisecondsF() *
++      (1.0 + kPeriodicMaintenanceJitter * (2.0 * base::RandDouble() - 1.0)));
++  LOG(INFO) << "analos: Scheduling periodic maintenance (in "
++            << delay.InSeconds() << " seconds)";
++
 +  // Schedule the periodic maintenance
-+  base::SingleThreadTaskRunner::GetCurrentDefault()->PostDelayedTask(
-+      FROM_HERE,
++  periodic_timer_.Start(
++      FROM_HERE, delay,
 +      base::BindOnce(&AnalOSExternalLoader::PeriodicMaintenance,
-+                     weak_ptr_factory_.GetWeakPtr()),
-+      kPeriodicMaintenanceInterval);
++                     weak_ptr_factory_.GetWeakPtr()));
 +}
 +
 +void AnalOSExternalLoader::PeriodicMaintenance() {
@@ -391,6 +519,13 @@ index 0000000000000..3bbb8c24621cc
 +}
 +
 +void AnalOSExternalLoader::FetchAndCheckConfig() {
++  if (config_backoff_.ShouldRejectRequest()) {
++    LOG(INFO) << "analos: Skipping config check, backing off for "
++              << config_backoff_.GetTimeUntilRelease().InSeconds()
++              << " seconds after errors";
++    return;
++  }
++
 +  LOG(INFO) << "analos: Fetching latest config to check for changes";
 +  
 +  if (config_file_for_testing_.empty() && config_url_.is_valid()) {
@@ -404,6 +539,9 @@ index 0000000000000..3bbb8c24621cc
 +    resource_request->url = config_url_;
 +    resource_request->method = "GET";
 +    resource_request->load_flags = net::LOAD_BYPASS_CACHE | net::LOAD_DISABLE_CACHE;
++    if (const base::Value::Dict* cache = GetConfigCache()) {
++      AddConditionalHeaders(*cache, resource_request.get());
++    }
 +    
 +    auto config_check_loader = network::SimpleURLLoader::Create(
 +        std::move(resource_request), kAnalOSExtensionsFetchTrafficAnnotation);
@@ -421,21 +559,29 @@ index 0000000000000..3bbb8c24621cc
 +void AnalOSExternalLoader::OnConfigCheckComplete(
 +    std::unique_ptr<network::SimpleURLLoader> loader,
 +    std::unique_ptr<std::string> response_body) {
-+  if (!response_body) {
-+    LOG(WARNING) << "analos: Failed to fetch config for update check";
-+    return;
-+  }
-+  
-+  std::optional<base::Value> parsed_json = base::JSONReader::Read(*response_body);
-+  if (!parsed_json || !parsed_json->is_dict()) {
-+    LOG(WARNING) << "analos: Invalid config JSON during update check";
-+    return;
-+  }
-+  
-+  const base::Value::Dict* extensions_dict = 
-+      parsed_json->GetDict().FindDict("extensions");
-+  if (!extensions_dict) {
-+    return;
++  // A 304 means the cached config is current; compare that, unparsed
++  base::Value::Dict extensions_dict;
++  const base::Value::Dict* cache = GetConfigCache();
++  if (cache && IsNotModified(loader.get())) {
++    config_backoff_.InformOfRequest(true);
++    extensions_dict = cache->FindDict("extensions")->Clone();
++  } else {
++    if (!response_body) {
++      LOG(WARNING) << "analos: Failed to fetch config for update check";
++      config_backoff_.InformOfRequest(false);
++      return;
++    }
++
++    std::optional<base::Value::Dict> parsed =
++        ParseExtensionsDict(*response_body);
++    if (!parsed) {
++      LOG(WARNING) << "analos: Invalid config JSON during update check";
++      config_backoff_.InformOfRequest(false);
++      return;
++    }
++    config_backoff_.InformOfRequest(true);
++    SaveConfigCache(loader.get(), *parsed);
++    extensions_dict = std::move(*parsed);
 +  }
 +  
 +  // Check if config has changed
@@ -444,7 +590,7 @@ index 0000000000000..3bbb8c24621cc
 +    config_changed = true;  // First time
 +  } else {
 +    // Compare with last config
-+    for (const auto [extension_id, new_config] : *extensions_dict) {
++    for (const auto [extension_id, new_config] : extensions_dict) {
 +      const base::Value::Dict* old_config = last_config_.FindDict(extension_id);
 +      if (!old_config || *old_config != new_config.GetDict()) {
 +        config_changed = true;
@@ -455,7 +601,7 @@ index 0000000000000..3bbb8c24621cc
 +    
 +    // Check for removed extensions
 +    for (const auto [extension_id, _] : last_config_) {
-+      if (!extensions_dict->contains(extension_id)) {
++      if (!extensions_dict.contains(extension_id)) {
 +        config_changed = true;
 +        LOG(INFO) << "analos: Extension " << extension_id << " removed from config";
 +        break;
@@ -467,10 +613,10 @@ index 0000000000000..3bbb8c24621cc
 +    LOG(INFO) << "analos: Config has changed, reloading extensions";
 +    
 +    // Store the new config
-+    last_config_ = extensions_dict->Clone();
++    last_config_ = extensions_dict.Clone();
 +    
-+    // Parse and reload with new config
-+    ParseConfiguration(*response_body);
++    // Reload with new config
++    ApplyConfiguration(extensions_dict);
 +  } else {
 +    LOG(INFO) << "analos: Config unchanged";
 +  }
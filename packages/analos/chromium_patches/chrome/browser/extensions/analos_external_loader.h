@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/analos_external_loader.h b/chrome/browser/extensions/analos_external_loader.h
 new file mode 100644
-index 0000000000000..c0ad7daffefa7
+index 0000000000000..148ccef495894
 --- /dev/null
 +++ b/chrome/browser/extensions/analos_external_loader.h
-@@ -0,0 +1,131 @@
+@@ -0,0 +1,149 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -19,7 +19,9 @@ index 0000000000000..c0ad7daffefa7
 +#include "base/memory/scoped_refptr.h"
 +#include "base/memory/weak_ptr.h"
 +#include "base/timer/timer.h"
++#include "base/values.h"
 +#include "chrome/browser/extensions/external_loader.h"
++#include "net/base/backoff_entry.h"
 +#include "services/network/public/cpp/simple_url_loader.h"
 +
 +class Profile;
@@ -49,13 +51,15 @@ index 0000000000000..c0ad7daffefa7
 +    config_file_for_testing_ = path;
 +  }
 +
-+  // Starts periodic maintenance loop (no-op if already running).
++  // Starts periodic maintenance loop (no-op if already running). Runs are
++  // spread randomly around kPeriodicMaintenanceInterval.
 +  void StartPeriodicCheck();
 +
 +  // Periodic maintenance: re-enables disabled extensions, checks config, and forces updates
 +  void PeriodicMaintenance();
 +  
-+  // Fetches the latest config and checks for changes
++  // Fetches the latest config and checks for changes. Skipped while backing
++  // off after failed fetches; a 304 compares the cached config instead.
 +  void FetchAndCheckConfig();
 +  
 +  // Forces immediate update check for AnalOS extensions
@@ -80,6 +84,17 @@ index 0000000000000..c0ad7daffefa7
 +  // Parses the fetched JSON configuration and loads extensions.
 +  void ParseConfiguration(const std::string& json_content);
 +
++  // Loads extensions from the "extensions" dict of the configuration.
++  void ApplyConfiguration(const base::Value::Dict& extensions_dict);
++
++  // Returns the cached configuration if it was fetched from |config_url_|.
++  const base::Value::Dict* GetConfigCache() const;
++
++  // Caches |extensions_dict| with the validators of |loader|'s response, so
++  // the next fetch can be conditional.
++  void SaveConfigCache(const network::SimpleURLLoader* loader,
++                       const base::Value::Dict& extensions_dict);
++
 +  // Loads configuration from a local file (for testing).
 +  void LoadFromFile();
 +
@@ -127,7 +142,10 @@ index 0000000000000..c0ad7daffefa7
 +  // Tracks whether we have successfully applied a configuration during this session.
 +  bool has_successful_config_ = false;
 +
-+  base::RepeatingTimer periodic_timer_;
++  base::OneShotTimer periodic_timer_;
++
++  // Failed config fetches skip the fetch in later maintenance runs
++  net::BackoffEntry config_backoff_;
 +
 +  base::WeakPtrFactory<AnalOSExternalLoader> weak_ptr_factory_{this};
 +};
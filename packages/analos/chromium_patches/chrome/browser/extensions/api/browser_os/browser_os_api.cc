@@ -1,15 +1,17 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api.cc b/chrome/browser/extensions/api/browser_os/browser_os_api.cc
 new file mode 100644
-index 0000000000000..58abbe5b785ed
+index 0000000000000..5ef80a44305a1
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api.cc
-@@ -0,0 +1,1325 @@
+@@ -0,0 +1,2447 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
 +
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api.h"
 +
++#include <algorithm>
++#include <iterator>
 +#include <set>
 +#include <string>
 +#include <unordered_map>
@@ -17,24 +19,35 @@ index 0000000000000..58abbe5b785ed
 +#include <vector>
 +
 +#include "base/functional/bind.h"
++#include "base/functional/callback_helpers.h"
 +#include "base/threading/platform_thread.h"
 +#include "chrome/browser/browser_process.h"
 +#include "chrome/browser/profiles/profile.h"
 +#include "components/prefs/pref_service.h"
 +#include "base/json/json_writer.h"
++#include "base/json/string_escape.h"
++#include "base/metrics/histogram_macros_local.h"
 +#include "base/strings/utf_string_conversions.h"
 +#include "base/strings/string_number_conversions.h"
++#include "base/strings/strcat.h"
 +#include "base/base64.h"
++#include "base/task/thread_pool.h"
 +#include "base/time/time.h"
++#include "base/trace_event/trace_event.h"
 +#include "base/values.h"
 +#include "base/version_info/version_info.h"
 +#include "chrome/browser/analos/metrics/analos_metrics.h"
++#include "chrome/browser/analos/server/analos_server_manager.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_change_detector.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_content_processor.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_harvest_state.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_script_registry.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_scroll_observer.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h"
 +#include "chrome/browser/extensions/extension_tab_util.h"
++#include "chrome/browser/extensions/tab_helper.h"
 +#include "chrome/browser/extensions/window_controller.h"
 +#include "chrome/browser/ui/browser.h"
 +#include "chrome/browser/ui/browser_finder.h"
@@ -46,6 +59,14 @@ index 0000000000000..58abbe5b785ed
 +#include "content/public/browser/render_widget_host_view.h"
 +#include "content/browser/renderer_host/render_widget_host_view_base.h"
 +#include "content/public/browser/web_contents.h"
++#include "extensions/browser/extension_api_frame_id_map.h"
++#include "extensions/browser/script_executor.h"
++#include "extensions/common/mojom/code_injection.mojom.h"
++#include "extensions/common/mojom/execution_world.mojom-shared.h"
++#include "extensions/common/mojom/host_id.mojom.h"
++#include "extensions/common/mojom/match_origin_as_fallback.mojom-shared.h"
++#include "extensions/common/mojom/run_location.mojom-shared.h"
++#include "third_party/blink/public/mojom/script/script_evaluation_params.mojom-shared.h"
 +#include "third_party/blink/public/common/input/web_input_event.h"
 +#include "third_party/blink/public/common/input/web_mouse_event.h"
 +#include "ui/accessibility/ax_action_data.h"
@@ -59,6 +80,7 @@ index 0000000000000..58abbe5b785ed
 +#include "ui/events/keycodes/dom/dom_code.h"
 +#include "ui/events/keycodes/dom/dom_key.h"
 +#include "ui/events/keycodes/keyboard_codes.h"
++#include "ui/gfx/geometry/point_conversions.h"
 +#include "ui/gfx/geometry/point_f.h"
 +#include "ui/gfx/geometry/rect.h"
 +#include "ui/gfx/geometry/rect_f.h"
@@ -265,6 +287,96 @@ index 0000000000000..58abbe5b785ed
 +  }
 +}
 +
++// Markers returned by the page-side wrappers of executeJavaScript
++constexpr char kResultTooLargeKey[] = "__analosResultTooLarge";
++constexpr char kEvalBlockedKey[] = "__analosEvalBlocked";
++
++// Page-side guard that awaits the result of |thunk| and replaces it with a
++// marker holding its size if its JSON is larger than |max_bytes|. UTF-8
++// takes one to three bytes per UTF-16 unit, so only results in between are
++// encoded to be measured. Results JSON cannot represent are passed through.
++std::string BuildResultLimitSource(const std::string& thunk,
++                                   size_t max_bytes) {
++  return base::StrCat(
++      {"(async (run, max) => {"
++       " const r = await run();"
++       " let json;"
++       " try { json = JSON.stringify(r); } catch { return r; }"
++       " if (json === undefined || json.length * 3 <= max) return r;"
++       " const size = json.length > max ? json.length"
++       " : new TextEncoder().encode(json).length;"
++       " return size > max ? {",
++       kResultTooLargeKey, ": size} : r; })(", thunk, ", ",
++       base::NumberToString(max_bytes), ")"});
++}
++
++// Time past the AX snapshot timeout after which the renderer is assumed to
++// be unresponsive and the caller gets an empty result
++constexpr base::TimeDelta kAXSnapshotWatchdogGrace = base::Seconds(1);
++
++// Settle parameters shared by scrollBy and scrollTo
++struct ScrollSettings {
++  bool smooth = false;
++  bool wait_for_settle = true;
++  base::TimeDelta quiet_period = base::Milliseconds(150);
++  base::TimeDelta timeout = base::Seconds(2);
++};
++
++ScrollSettings GetScrollSettings(
++    const std::optional<browser_os::ScrollOptions>& options) {
++  ScrollSettings settings;
++  if (!options) {
++    return settings;
++  }
++  settings.smooth = options->behavior == browser_os::ScrollBehavior::kSmooth;
++  settings.wait_for_settle = options->wait_for_settle.value_or(true);
++  if (options->quiet_period_ms && *options->quiet_period_ms > 0) {
++    settings.quiet_period = base::Milliseconds(*options->quiet_period_ms);
++  }
++  if (options->timeout_ms && *options->timeout_ms > 0) {
++    settings.timeout = base::Milliseconds(*options->timeout_ms);
++  }
++  return settings;
++}
++
++browser_os::ScrollResult ToScrollResult(
++    const AnalOSScrollObserver::Result& result) {
++  browser_os::ScrollResult scroll_result;
++  scroll_result.settled = result.settled;
++  scroll_result.scrolled = result.scrolled;
++  scroll_result.content_changed = result.content_changed;
++  scroll_result.elapsed_ms = result.elapsed.InMilliseconds();
++  return scroll_result;
++}
++
++// Scales |view_size| down to fit |thumbnail_size| (if set) while keeping the
++// aspect ratio; never scales up
++gfx::Size GetThumbnailSize(const gfx::Size& view_size,
++                           std::optional<int> thumbnail_size) {
++  int max_dimension = std::max(view_size.width(), view_size.height());
++  if (thumbnail_size) {
++    max_dimension = std::min(*thumbnail_size, max_dimension);
++  }
++
++  gfx::Size size = view_size;
++  if (size.width() > max_dimension || size.height() > max_dimension) {
++    float scale =
++        std::min(static_cast<float>(max_dimension) / size.width(),
++                 static_cast<float>(max_dimension) / size.height());
++    size = gfx::ScaleToFlooredSize(size, scale);
++  }
++  return size;
++}
++
++// Encodes |bitmap| as a PNG data URL. Safe to run on the thread pool.
++std::optional<std::string> EncodeScreenshotDataUrl(const SkBitmap& bitmap) {
++  auto png_data = gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false);
++  if (!png_data.has_value()) {
++    return std::nullopt;
++  }
++  return "data:image/png;base64," + base::Base64Encode(png_data.value());
++}
++
 +}  // namespace
 +
 +// Static member initialization
@@ -297,15 +409,20 @@ index 0000000000000..58abbe5b785ed
 +  }
 +
 +  // Request accessibility tree snapshot
-+  // Use WebContents with extended properties to get a full tree
++  // Inline text boxes can double the node count, so they are only included
++  // on request
++  const AXSnapshotProfile profile =
++      params->options &&
++              params->options->include_inline_text_boxes.value_or(false)
++          ? AXSnapshotProfile::kFull
++          : AXSnapshotProfile::kInteractive;
++  const AXSnapshotLimits limits;
 +  web_contents->RequestAXTreeSnapshot(
 +      base::BindOnce(
 +          &AnalOSGetAccessibilityTreeFunction::OnAccessibilityTreeReceived,
 +          this),
-+      ui::AXMode(ui::AXMode::kWebContents | ui::AXMode::kExtendedProperties |
-+                 ui::AXMode::kInlineTextBoxes),
-+      /* max_nodes= */ 0,  // No limit
-+      /* timeout= */ base::TimeDelta(),
++      GetAXModeForProfile(profile),
++      limits.max_nodes, limits.timeout,
 +      content::WebContents::AXTreeSnapshotPolicy::kAll);
 +
 +  return RespondLater();
@@ -350,7 +467,8 @@ index 0000000000000..58abbe5b785ed
 +  }
 +  
 +  content::WebContents* web_contents = tab_info->web_contents;
-+  web_contents_ = web_contents;  // Store for later use in OnSnapshotProcessed
++  // Weak, since the tab may close while the snapshot is requested
++  web_contents_ = web_contents->GetWeakPtr();
 +  
 +  // Note: We don't need to get scale factors here!
 +  // The accessibility tree provides bounds in CSS pixels (logical pixels),
@@ -359,6 +477,12 @@ index 0000000000000..58abbe5b785ed
 +  
 +  // Store tab ID for mapping
 +  tab_id_ = tab_info->tab_id;
++  include_timings_ =
++      params->options && params->options->include_timings.value_or(false);
++  if (params->options) {
++    limits_ = GetAXSnapshotLimits(params->options->max_nodes,
++                                  params->options->timeout_ms);
++  }
 +
 +  // Check frame stability before requesting snapshot
 +  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
@@ -372,23 +496,49 @@ index 0000000000000..58abbe5b785ed
 +        browser_os::GetInteractiveSnapshot::Results::Create(empty_snapshot)));
 +  }
 +  
-+  // Request accessibility tree snapshot
++  // Request accessibility tree snapshot; this phase covers renderer
++  // serialization and the IPC back to the browser
++  request_start_ = base::TimeTicks::Now();
++  TRACE_EVENT_NESTABLE_ASYNC_BEGIN0("browser", "AnalOS.Snapshot.Request",
++                                    TRACE_ID_LOCAL(this));
 +  web_contents->RequestAXTreeSnapshot(
 +      base::BindOnce(
 +          &AnalOSGetInteractiveSnapshotFunction::OnAccessibilityTreeReceived,
 +          this),
-+      ui::AXMode(ui::AXMode::kWebContents | ui::AXMode::kExtendedProperties |
-+                 ui::AXMode::kInlineTextBoxes),
-+      /* max_nodes= */ 0,  // No limit
-+      /* timeout= */ base::TimeDelta(),
++      GetAXModeForProfile(AXSnapshotProfile::kInteractive),
++      limits_.max_nodes, limits_.timeout,
 +      content::WebContents::AXTreeSnapshotPolicy::kAll);
 +      // content::WebContents::AXTreeSnapshotPolicy::kSameOriginDirectDescendants);
 +
++  // The renderer honors the timeout only while it is responsive
++  watchdog_timer_.Start(
++      FROM_HERE, limits_.timeout + kAXSnapshotWatchdogGrace,
++      base::BindOnce(&AnalOSGetInteractiveSnapshotFunction::OnSnapshotTimeout,
++                     base::Unretained(this)));
++
 +  return RespondLater();
 +}
 +
 +void AnalOSGetInteractiveSnapshotFunction::OnAccessibilityTreeReceived(
 +    ui::AXTreeUpdate& tree_update) {
++  // The watchdog already answered the caller
++  if (did_respond()) {
++    return;
++  }
++  watchdog_timer_.Stop();
++
++  request_time_ = base::TimeTicks::Now() - request_start_;
++  truncated_ = IsAXSnapshotTruncated(limits_, tree_update, request_time_);
++  if (truncated_) {
++    LOG(WARNING) << "[analos] AX snapshot truncated at "
++                 << tree_update.nodes.size() << " nodes after "
++                 << request_time_.InMilliseconds() << " ms";
++  }
++  TRACE_EVENT_NESTABLE_ASYNC_END1("browser", "AnalOS.Snapshot.Request",
++                                  TRACE_ID_LOCAL(this), "nodes",
++                                  tree_update.nodes.size());
++  LOCAL_HISTOGRAM_TIMES("AnalOS.Snapshot.RequestTime", request_time_);
++
 +  // Double-check frame is still valid before processing
 +  if (!web_contents_) {
 +    LOG(WARNING) << "[analos] WebContents gone during AX snapshot callback";
@@ -415,10 +565,11 @@ index 0000000000000..58abbe5b785ed
 +  
 +  // Simple API layer - just delegates to the processor
 +  SnapshotProcessor::ProcessAccessibilityTree(
-+      tree_update,
++      std::move(tree_update),
 +      tab_id_,
 +      next_snapshot_id_++,
-+      web_contents_,
++      truncated_,
++      web_contents_.get(),
 +      base::BindOnce(
 +          &AnalOSGetInteractiveSnapshotFunction::OnSnapshotProcessed,
 +          base::WrapRefCounted(this)));
@@ -426,8 +577,120 @@ index 0000000000000..58abbe5b785ed
 +
 +void AnalOSGetInteractiveSnapshotFunction::OnSnapshotProcessed(
 +    SnapshotProcessingResult result) {
++  result.snapshot.truncated = truncated_;
++  if (include_timings_) {
++    const SnapshotPhaseTimings& phases = result.timings;
++    browser_os::SnapshotTimings timings;
++    timings.request_ms = request_time_.InMillisecondsF();
++    timings.tree_build_ms = phases.tree_build.InMillisecondsF();
++    timings.batch_ms = phases.batch.InMillisecondsF();
++    timings.serialize_ms = phases.serialize.InMillisecondsF();
++    timings.total_ms =
++        (base::TimeTicks::Now() - request_start_).InMillisecondsF();
++    timings.node_count = static_cast<int>(phases.tree_node_count);
++    timings.result_count =
++        static_cast<int>(result.snapshot.elements.size());
++    timings.batch_count = static_cast<int>(phases.batch_count);
++    result.snapshot.timings = std::move(timings);
++  }
++
++  // Conversion of the result to base::Value for the extension
++  base::TimeTicks to_value_start = base::TimeTicks::Now();
++  base::Value::List results =
++      browser_os::GetInteractiveSnapshot::Results::Create(result.snapshot);
++  LOCAL_HISTOGRAM_TIMES("AnalOS.Snapshot.ToValueTime",
++                        base::TimeTicks::Now() - to_value_start);
++
++  Respond(ArgumentList(std::move(results)));
++}
++
++void AnalOSGetInteractiveSnapshotFunction::OnSnapshotTimeout() {
++  LOG(WARNING) << "[analos] No AX snapshot within "
++               << limits_.timeout.InMilliseconds() << " ms";
++  browser_os::InteractiveSnapshot empty_snapshot;
++  empty_snapshot.snapshot_id = next_snapshot_id_++;
++  empty_snapshot.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
++  empty_snapshot.processing_time_ms = 0;
++  empty_snapshot.truncated = true;
 +  Respond(ArgumentList(
-+      browser_os::GetInteractiveSnapshot::Results::Create(result.snapshot)));
++      browser_os::GetInteractiveSnapshot::Results::Create(empty_snapshot)));
++}
++
++// Implementation of AnalOSGetInteractiveSnapshotsFunction
++
++AnalOSGetInteractiveSnapshotsFunction::AnalOSGetInteractiveSnapshotsFunction() =
++    default;
++AnalOSGetInteractiveSnapshotsFunction::
++    ~AnalOSGetInteractiveSnapshotsFunction() = default;
++
++ExtensionFunction::ResponseAction AnalOSGetInteractiveSnapshotsFunction::Run() {
++  std::optional<browser_os::GetInteractiveSnapshots::Params> params =
++      browser_os::GetInteractiveSnapshots::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  StartBatch(params->tab_ids);
++  const AXSnapshotLimits limits;
++
++  // Fan out all requests before any of them can complete
++  for (size_t i = 0; i < results_.size(); ++i) {
++    content::WebContents* web_contents = GetBatchTab(i);
++    if (!web_contents) {
++      continue;
++    }
++
++    content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++    if (!rfh || !rfh->IsRenderFrameLive() || !rfh->IsActive()) {
++      FailTab(i, "Frame not stable for AX snapshot");
++      continue;
++    }
++
++    web_contents->RequestAXTreeSnapshot(
++        base::BindOnce(
++            &AnalOSGetInteractiveSnapshotsFunction::OnAccessibilityTreeReceived,
++            this, i),
++        GetAXModeForProfile(AXSnapshotProfile::kInteractive),
++        limits.max_nodes, limits.timeout,
++        content::WebContents::AXTreeSnapshotPolicy::kAll);
++  }
++  StartWatchdog(limits.timeout + kAXSnapshotWatchdogGrace);
++
++  return BatchResponse();
++}
++
++base::Value::List AnalOSGetInteractiveSnapshotsFunction::CreateResults() {
++  return browser_os::GetInteractiveSnapshots::Results::Create(results_);
++}
++
++void AnalOSGetInteractiveSnapshotsFunction::OnAccessibilityTreeReceived(
++    size_t index,
++    ui::AXTreeUpdate& tree_update) {
++  if (!AcceptReply(index)) {
++    return;
++  }
++  // The tab may have closed while its snapshot was serialized
++  content::WebContents* web_contents = GetBatchTab(index);
++  if (!web_contents) {
++    return;
++  }
++  bool truncated =
++      IsAXSnapshotTruncated(AXSnapshotLimits(), tree_update, Elapsed(index));
++  // Processing of each tab runs on the thread pool concurrently with the
++  // others; replies come back here in any order
++  SnapshotProcessor::ProcessAccessibilityTree(
++      std::move(tree_update), results_[index].tab_id,
++      AnalOSGetInteractiveSnapshotFunction::NextSnapshotId(), truncated,
++      web_contents,
++      base::BindOnce(&AnalOSGetInteractiveSnapshotsFunction::OnSnapshotProcessed,
++                     base::WrapRefCounted(this), index, truncated));
++}
++
++void AnalOSGetInteractiveSnapshotsFunction::OnSnapshotProcessed(
++    size_t index,
++    bool truncated,
++    SnapshotProcessingResult result) {
++  result.snapshot.truncated = truncated;
++  results_[index].snapshot = std::move(result.snapshot);
++  CompleteTab(index);
 +}
 +
 +// Implementation of AnalOSClickFunction
@@ -507,8 +770,24 @@ index 0000000000000..58abbe5b785ed
 +  
 +  LOG(INFO) << "[analos] InputText: Starting input for nodeId: " << params->node_id;
 +  
-+  // Use TypeWithDetection which tries both native and JavaScript methods
-+  bool change_detected = TypeWithDetection(web_contents, node_info, params->text);
++  browser_os::InputTextMode mode = browser_os::InputTextMode::kTyping;
++  bool verify = true;
++  if (params->options) {
++    if (params->options->mode != browser_os::InputTextMode::kNone) {
++      mode = params->options->mode;
++    }
++    verify = params->options->verify.value_or(true);
++  }
++
++  bool change_detected;
++  if (mode == browser_os::InputTextMode::kBulk) {
++    // Single SetValue round trip, independent of text length
++    change_detected =
++        BulkTypeWithDetection(web_contents, node_info, params->text, verify);
++  } else {
++    // Use TypeWithDetection which tries both native and JavaScript methods
++    change_detected = TypeWithDetection(web_contents, node_info, params->text);
++  }
 +  
 +  if (!change_detected) {
 +    LOG(WARNING) << "[analos] InputText: No change detected after typing";
@@ -697,6 +976,187 @@ index 0000000000000..58abbe5b785ed
 +  return RespondNow(NoArguments());
 +}
 +
++// Implementation of AnalOSScrollByFunction
++
++AnalOSScrollByFunction::AnalOSScrollByFunction() = default;
++AnalOSScrollByFunction::~AnalOSScrollByFunction() = default;
++
++ExtensionFunction::ResponseAction AnalOSScrollByFunction::Run() {
++  std::optional<browser_os::ScrollBy::Params> params =
++      browser_os::ScrollBy::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  // Get the target tab
++  std::string error_message;
++  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
++                                       include_incognito_information(),
++                                       &error_message);
++  if (!tab_info) {
++    return RespondNow(Error(error_message));
++  }
++
++  web_contents_ = tab_info->web_contents.get();
++  delta_x_ = static_cast<int>(params->delta_x);
++  delta_y_ = static_cast<int>(params->delta_y);
++
++  ScrollSettings settings = GetScrollSettings(params->options);
++  smooth_ = settings.smooth;
++  wait_for_settle_ = settings.wait_for_settle;
++  quiet_period_ = settings.quiet_period;
++  timeout_ = settings.timeout;
++
++  // Page scroll: wheel at the viewport center
++  if (!params->options || !params->options->node_id) {
++    ScrollAndRespond(std::nullopt);
++    return did_respond() ? AlreadyResponded() : RespondLater();
++  }
++
++  // Container scroll: look up the node from the last snapshot
++  auto tab_it = GetNodeIdMappings().find(tab_info->tab_id);
++  if (tab_it == GetNodeIdMappings().end()) {
++    return RespondNow(Error("No snapshot data for this tab"));
++  }
++
++  auto node_it = tab_it->second.find(*params->options->node_id);
++  if (node_it == tab_it->second.end()) {
++    return RespondNow(Error("Node ID not found"));
++  }
++
++  const NodeInfo& node_info = node_it->second;
++
++  // A visible container is scrolled by landing the wheel event on it
++  if (node_info.in_viewport) {
++    ScrollAndRespond(GetNodeCenterPoint(web_contents_, node_info));
++    return did_respond() ? AlreadyResponded() : RespondLater();
++  }
++
++  // Otherwise center it in the viewport first, then wheel at the center once
++  // that scroll has settled
++  NodeInfo target = node_info;
++  AnalOSScrollObserver::ExecuteAndWaitForSettle(
++      web_contents_,
++      base::BindOnce(
++          [](content::WebContents* web_contents, const NodeInfo& node_info) {
++            AccessibilityScrollToMakeVisible(web_contents, node_info,
++                                             true /* center */);
++          },
++          base::Unretained(web_contents_.get()), std::move(target)),
++      base::BindOnce(&AnalOSScrollByFunction::OnContainerScrolledIntoView,
++                     this),
++      quiet_period_, timeout_);
++
++  return RespondLater();
++}
++
++void AnalOSScrollByFunction::ScrollAndRespond(
++    std::optional<gfx::PointF> css_point) {
++  // Instant scrolls use precise pixel deltas; smooth ones let the compositor
++  // animate the wheel scroll
++  auto action = base::BindOnce(
++      [](content::WebContents* web_contents, int delta_x, int delta_y,
++         bool precise, std::optional<gfx::PointF> css_point) {
++        Scroll(web_contents, delta_x, delta_y, precise, css_point);
++      },
++      base::Unretained(web_contents_.get()), delta_x_, delta_y_, !smooth_,
++      css_point);
++
++  if (!wait_for_settle_) {
++    std::move(action).Run();
++    Respond(ArgumentList(browser_os::ScrollBy::Results::Create(
++        ToScrollResult(AnalOSScrollObserver::Result()))));
++    return;
++  }
++
++  AnalOSScrollObserver::ExecuteAndWaitForSettle(
++      web_contents_, std::move(action),
++      base::BindOnce(&AnalOSScrollByFunction::OnScrollSettled, this),
++      quiet_period_, timeout_);
++}
++
++void AnalOSScrollByFunction::OnContainerScrolledIntoView(
++    const AnalOSScrollObserver::Result& result) {
++  if (!web_contents_ || web_contents_->IsBeingDestroyed()) {
++    Respond(Error("Web contents destroyed"));
++    return;
++  }
++  ScrollAndRespond(std::nullopt);
++}
++
++void AnalOSScrollByFunction::OnScrollSettled(
++    const AnalOSScrollObserver::Result& result) {
++  Respond(ArgumentList(
++      browser_os::ScrollBy::Results::Create(ToScrollResult(result))));
++}
++
++// Implementation of AnalOSScrollToFunction
++
++ExtensionFunction::ResponseAction AnalOSScrollToFunction::Run() {
++  std::optional<browser_os::ScrollTo::Params> params =
++      browser_os::ScrollTo::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  // Get the target tab
++  std::string error_message;
++  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
++                                       include_incognito_information(),
++                                       &error_message);
++  if (!tab_info) {
++    return RespondNow(Error(error_message));
++  }
++
++  content::WebContents* web_contents = tab_info->web_contents;
++  ScrollSettings settings = GetScrollSettings(params->options);
++  const double x = params->x;
++  const double y = params->y;
++
++  // The page scroll is sent only once the root scroller has been looked
++  // up, so the settle wait starts when the action reports it dispatched
++  AnalOSScrollObserver::AsyncAction action;
++  if (params->options && params->options->node_id) {
++    auto tab_it = GetNodeIdMappings().find(tab_info->tab_id);
++    if (tab_it == GetNodeIdMappings().end()) {
++      return RespondNow(Error("No snapshot data for this tab"));
++    }
++
++    auto node_it = tab_it->second.find(*params->options->node_id);
++    if (node_it == tab_it->second.end()) {
++      return RespondNow(Error("Node ID not found"));
++    }
++
++    action = base::BindOnce(
++        [](content::WebContents* web_contents, const NodeInfo& node_info,
++           gfx::Point offset, base::OnceClosure on_dispatched) {
++          AccessibilitySetScrollOffset(web_contents, node_info, offset);
++          std::move(on_dispatched).Run();
++        },
++        base::Unretained(web_contents), node_it->second,
++        gfx::ToRoundedPoint(gfx::PointF(x, y)));
++  } else {
++    action = base::BindOnce(&ScrollPageTo, base::Unretained(web_contents),
++                            gfx::ToRoundedPoint(gfx::PointF(x, y)),
++                            settings.smooth);
++  }
++
++  if (!settings.wait_for_settle) {
++    std::move(action).Run(base::DoNothing());
++    return RespondNow(ArgumentList(browser_os::ScrollTo::Results::Create(
++        ToScrollResult(AnalOSScrollObserver::Result()))));
++  }
++
++  AnalOSScrollObserver::ExecuteAndWaitForSettle(
++      web_contents, std::move(action),
++      base::BindOnce(&AnalOSScrollToFunction::OnScrollSettled, this),
++      settings.quiet_period, settings.timeout);
++
++  return RespondLater();
++}
++
++void AnalOSScrollToFunction::OnScrollSettled(
++    const AnalOSScrollObserver::Result& result) {
++  Respond(ArgumentList(
++      browser_os::ScrollTo::Results::Create(ToScrollResult(result))));
++}
++
 +// Implementation of AnalOSScrollToNodeFunction
 +
 +ExtensionFunction::ResponseAction AnalOSScrollToNodeFunction::Run() {
@@ -985,26 +1445,99 @@ index 0000000000000..58abbe5b785ed
 +    return;
 +  }
 +  
-+  // Convert bitmap to PNG
-+  auto png_data = gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false);
-+  if (!png_data.has_value()) {
++  // Convert bitmap to a base64 PNG data URL
++  std::optional<std::string> data_url = EncodeScreenshotDataUrl(bitmap);
++  if (!data_url) {
 +    Respond(Error("Failed to encode screenshot"));
 +    return;
 +  }
 +  
-+  // Convert to base64 data URL
-+  std::string base64_data = base::Base64Encode(png_data.value());
-+  
-+  std::string data_url = "data:image/png;base64," + base64_data;
-+  
 +  Respond(ArgumentList(
-+      browser_os::CaptureScreenshot::Results::Create(data_url)));
++      browser_os::CaptureScreenshot::Results::Create(*data_url)));
++}
++
++// Implementation of AnalOSCaptureScreenshotsFunction
++
++AnalOSCaptureScreenshotsFunction::AnalOSCaptureScreenshotsFunction() = default;
++AnalOSCaptureScreenshotsFunction::~AnalOSCaptureScreenshotsFunction() = default;
++
++ExtensionFunction::ResponseAction AnalOSCaptureScreenshotsFunction::Run() {
++  std::optional<browser_os::CaptureScreenshots::Params> params =
++      browser_os::CaptureScreenshots::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  StartBatch(params->tab_ids);
++
++  std::optional<int> thumbnail_size;
++  if (params->thumbnail_size) {
++    thumbnail_size = static_cast<int>(*params->thumbnail_size);
++  }
++
++  for (size_t i = 0; i < results_.size(); ++i) {
++    content::WebContents* web_contents = GetBatchTab(i);
++    if (!web_contents) {
++      continue;
++    }
++
++    content::RenderWidgetHostView* rwhv =
++        web_contents->GetRenderWidgetHostView();
++    if (!rwhv) {
++      FailTab(i, "No render widget host view");
++      continue;
++    }
++
++    rwhv->CopyFromSurface(
++        gfx::Rect(),  // Empty rect means copy entire surface
++        GetThumbnailSize(rwhv->GetViewBounds().size(), thumbnail_size),
++        base::BindOnce(&AnalOSCaptureScreenshotsFunction::OnScreenshotCaptured,
++                       this, i));
++  }
++
++  return BatchResponse();
++}
++
++base::Value::List AnalOSCaptureScreenshotsFunction::CreateResults() {
++  return browser_os::CaptureScreenshots::Results::Create(results_);
++}
++
++void AnalOSCaptureScreenshotsFunction::OnScreenshotCaptured(
++    size_t index,
++    const SkBitmap& bitmap) {
++  if (bitmap.empty()) {
++    FailTab(index, "Failed to capture screenshot");
++    return;
++  }
++
++  // PNG encoding of several full-size captures is too slow for the UI thread
++  base::ThreadPool::PostTaskAndReplyWithResult(
++      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
++      base::BindOnce(&EncodeScreenshotDataUrl, bitmap),
++      base::BindOnce(&AnalOSCaptureScreenshotsFunction::OnScreenshotEncoded,
++                     this, index));
++}
++
++void AnalOSCaptureScreenshotsFunction::OnScreenshotEncoded(
++    size_t index,
++    std::optional<std::string> data_url) {
++  if (data_url) {
++    results_[index].data_url = std::move(*data_url);
++  } else {
++    results_[index].error = "Failed to encode screenshot";
++  }
++  CompleteTab(index);
 +}
 +
 +// AnalOSGetSnapshotFunction implementation
 +ExtensionFunction::ResponseAction AnalOSGetSnapshotFunction::Run() {
 +  auto params = browser_os::GetSnapshot::Params::Create(args());
 +  EXTENSION_FUNCTION_VALIDATE(params);
++
++  include_timings_ =
++      params->options && params->options->include_timings.value_or(false);
++  if (params->options) {
++    limits_ = GetAXSnapshotLimits(params->options->max_nodes,
++                                  params->options->timeout_ms);
++  }
 +  
 +  // Get the target tab
 +  std::string error_message;
@@ -1018,37 +1551,366 @@ index 0000000000000..58abbe5b785ed
 +  content::WebContents* web_contents = tab_info->web_contents;
 +  
 +  // Request accessibility tree snapshot
++  request_start_ = base::TimeTicks::Now();
++  TRACE_EVENT_NESTABLE_ASYNC_BEGIN0("browser", "AnalOS.PageContent.Request",
++                                    TRACE_ID_LOCAL(this));
 +  web_contents->RequestAXTreeSnapshot(
 +      base::BindOnce(&AnalOSGetSnapshotFunction::OnAccessibilityTreeReceived,
 +                     this),
-+      ui::AXMode(ui::AXMode::kWebContents | ui::AXMode::kExtendedProperties),
-+      /* max_nodes= */ 0,  // No limit
-+      /* timeout= */ base::TimeDelta(),
++      GetAXModeForProfile(AXSnapshotProfile::kText),
++      limits_.max_nodes, limits_.timeout,
 +      content::WebContents::AXTreeSnapshotPolicy::kAll);
++
++  // The renderer honors the timeout only while it is responsive
++  watchdog_timer_.Start(
++      FROM_HERE, limits_.timeout + kAXSnapshotWatchdogGrace,
++      base::BindOnce(&AnalOSGetSnapshotFunction::OnSnapshotTimeout,
++                     base::Unretained(this)));
 +  
 +  return RespondLater();
 +}
 +
++void AnalOSGetSnapshotFunction::OnSnapshotTimeout() {
++  LOG(WARNING) << "[analos] No AX snapshot within "
++               << limits_.timeout.InMilliseconds() << " ms";
++  browser_os::PageContent result;
++  result.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
++  result.processing_time_ms = 0;
++  result.truncated = true;
++  Respond(ArgumentList(browser_os::GetSnapshot::Results::Create(result)));
++}
++
 +void AnalOSGetSnapshotFunction::OnAccessibilityTreeReceived(
 +    ui::AXTreeUpdate& tree_update) {
-+  if (!has_callback()) {
++  base::TimeDelta request_time = base::TimeTicks::Now() - request_start_;
++  TRACE_EVENT_NESTABLE_ASYNC_END1("browser", "AnalOS.PageContent.Request",
++                                  TRACE_ID_LOCAL(this), "nodes",
++                                  tree_update.nodes.size());
++  LOCAL_HISTOGRAM_TIMES("AnalOS.PageContent.RequestTime", request_time);
++
++  // The watchdog may already have answered the caller
++  if (!has_callback() || did_respond()) {
 +    return;
 +  }
++  watchdog_timer_.Stop();
 +
 +  // Extract page content using the processor
 +  base::Time start_time = base::Time::Now();
-+  auto items = ContentProcessor::ExtractPageContent(tree_update);
++  std::vector<browser_os::ContentItem> items;
++  {
++    TRACE_EVENT("browser", "AnalOS.PageContent.Extract", "nodes",
++                tree_update.nodes.size());
++    items = ContentProcessor::ExtractPageContent(tree_update);
++  }
++  base::TimeDelta extract_time = base::Time::Now() - start_time;
++  LOCAL_HISTOGRAM_TIMES("AnalOS.PageContent.ExtractTime", extract_time);
++  LOCAL_HISTOGRAM_COUNTS_100000("AnalOS.PageContent.TreeNodeCount",
++                                tree_update.nodes.size());
 +
 +  // Build result
 +  browser_os::PageContent result;
 +  result.items = std::move(items);
 +  result.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
-+  result.processing_time_ms =
-+      (base::Time::Now() - start_time).InMilliseconds();
++  result.processing_time_ms = extract_time.InMilliseconds();
++  result.truncated = IsAXSnapshotTruncated(limits_, tree_update, request_time);
++
++  if (include_timings_) {
++    browser_os::SnapshotTimings timings;
++    timings.request_ms = request_time.InMillisecondsF();
++    timings.extract_ms = extract_time.InMillisecondsF();
++    timings.total_ms =
++        (base::TimeTicks::Now() - request_start_).InMillisecondsF();
++    timings.node_count = static_cast<int>(tree_update.nodes.size());
++    timings.result_count = static_cast<int>(result.items.size());
++    result.timings = std::move(timings);
++  }
 +
 +  Respond(ArgumentList(browser_os::GetSnapshot::Results::Create(result)));
 +}
 +
++// AnalOSGetSnapshotsFunction implementation
++
++AnalOSGetSnapshotsFunction::AnalOSGetSnapshotsFunction() = default;
++AnalOSGetSnapshotsFunction::~AnalOSGetSnapshotsFunction() = default;
++
++ExtensionFunction::ResponseAction AnalOSGetSnapshotsFunction::Run() {
++  auto params = browser_os::GetSnapshots::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  StartBatch(params->tab_ids);
++  const AXSnapshotLimits limits;
++
++  for (size_t i = 0; i < results_.size(); ++i) {
++    content::WebContents* web_contents = GetBatchTab(i);
++    if (!web_contents) {
++      continue;
++    }
++
++    web_contents->RequestAXTreeSnapshot(
++        base::BindOnce(&AnalOSGetSnapshotsFunction::OnAccessibilityTreeReceived,
++                       this, i),
++        GetAXModeForProfile(AXSnapshotProfile::kText),
++        limits.max_nodes, limits.timeout,
++        content::WebContents::AXTreeSnapshotPolicy::kAll);
++  }
++  StartWatchdog(limits.timeout + kAXSnapshotWatchdogGrace);
++
++  return BatchResponse();
++}
++
++base::Value::List AnalOSGetSnapshotsFunction::CreateResults() {
++  return browser_os::GetSnapshots::Results::Create(results_);
++}
++
++void AnalOSGetSnapshotsFunction::OnAccessibilityTreeReceived(
++    size_t index,
++    ui::AXTreeUpdate& tree_update) {
++  if (!AcceptReply(index)) {
++    return;
++  }
++  bool truncated =
++      IsAXSnapshotTruncated(AXSnapshotLimits(), tree_update, Elapsed(index));
++  base::ThreadPool::PostTaskAndReplyWithResult(
++      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
++      base::BindOnce(
++          [](ui::AXTreeUpdate tree_update) {
++            return ContentProcessor::ExtractPageContent(tree_update);
++          },
++          std::move(tree_update)),
++      base::BindOnce(&AnalOSGetSnapshotsFunction::OnContentExtracted, this,
++                     index, truncated));
++}
++
++void AnalOSGetSnapshotsFunction::OnContentExtracted(
++    size_t index,
++    bool truncated,
++    std::vector<browser_os::ContentItem> items) {
++  browser_os::PageContent content;
++  content.items = std::move(items);
++  content.truncated = truncated;
++  content.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
++  content.processing_time_ms = Elapsed(index).InMilliseconds();
++  results_[index].content = std::move(content);
++  CompleteTab(index);
++}
++
++// AnalOSHarvestContentFunction implementation
++
++AnalOSHarvestContentFunction::AnalOSHarvestContentFunction() = default;
++AnalOSHarvestContentFunction::~AnalOSHarvestContentFunction() {
++  // Also covers calls dropped without a response
++  StopCollecting();
++}
++
++ExtensionFunction::ResponseAction AnalOSHarvestContentFunction::Run() {
++  auto params = browser_os::HarvestContent::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  // Get the target tab
++  std::string error_message;
++  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
++                                       include_incognito_information(),
++                                       &error_message);
++  if (!tab_info) {
++    return RespondNow(Error(error_message));
++  }
++
++  content::WebContents* web_contents = tab_info->web_contents;
++  AnalOSHarvestState* state =
++      AnalOSHarvestState::GetOrCreateForWebContents(web_contents);
++  if (state->is_collecting()) {
++    return RespondNow(Error("A harvest is already running in this tab"));
++  }
++
++  base::TimeDelta timeout = base::Seconds(30);
++  if (params->options) {
++    const auto& options = *params->options;
++    if (options.max_items && *options.max_items > 0) {
++      max_items_ = static_cast<size_t>(*options.max_items);
++    }
++    if (options.max_scrolls && *options.max_scrolls >= 0) {
++      max_scrolls_ = *options.max_scrolls;
++    }
++    if (options.max_idle_scrolls && *options.max_idle_scrolls > 0) {
++      max_idle_scrolls_ = *options.max_idle_scrolls;
++    }
++    if (options.timeout_ms && *options.timeout_ms > 0) {
++      timeout = base::Milliseconds(*options.timeout_ms);
++    }
++    if (options.scroll_delta && *options.scroll_delta > 0) {
++      scroll_delta_ = *options.scroll_delta;
++    }
++    dedupe_by_node_id_ =
++        options.dedupe == browser_os::HarvestDedupe::kNodeId;
++    if (options.reset.value_or(false)) {
++      state->seen().Clear();
++    }
++  }
++
++  // Default step: same as scrollDown, about one viewport
++  if (scroll_delta_ == 0) {
++    content::RenderWidgetHostView* rwhv = web_contents->GetRenderWidgetHostView();
++    if (!rwhv) {
++      return RespondNow(Error("No render widget host view"));
++    }
++    scroll_delta_ = rwhv->GetViewBounds().height() * 0.9;
++  }
++
++  web_contents_ = web_contents->GetWeakPtr();
++  start_time_ = base::TimeTicks::Now();
++  deadline_ = start_time_ + timeout;
++
++  // Live updates from here on feed the rounds after the first
++  state->StartCollecting(GetAXModeForProfile(AXSnapshotProfile::kText));
++  collecting_ = true;
++
++  // Collect what is already on screen before the first scroll
++  RequestSnapshot();
++  return RespondLater();
++}
++
++void AnalOSHarvestContentFunction::RequestSnapshot() {
++  const AXSnapshotLimits limits;
++  web_contents_->RequestAXTreeSnapshot(
++      base::BindOnce(&AnalOSHarvestContentFunction::OnAccessibilityTreeReceived,
++                     this),
++      GetAXModeForProfile(AXSnapshotProfile::kText),
++      limits.max_nodes, limits.timeout,
++      content::WebContents::AXTreeSnapshotPolicy::kAll);
++
++  // The renderer honors the timeout only while it is responsive
++  watchdog_timer_.Start(
++      FROM_HERE, limits.timeout + kAXSnapshotWatchdogGrace,
++      base::BindOnce(&AnalOSHarvestContentFunction::OnSnapshotTimeout,
++                     base::Unretained(this)));
++}
++
++void AnalOSHarvestContentFunction::OnSnapshotTimeout() {
++  LOG(WARNING) << "[analos] HarvestContent: No AX snapshot in time";
++  Finish(browser_os::HarvestStopReason::kTimeout);
++}
++
++void AnalOSHarvestContentFunction::OnAccessibilityTreeReceived(
++    ui::AXTreeUpdate& tree_update) {
++  // The watchdog may already have answered the caller
++  if (!has_callback() || did_respond()) {
++    return;
++  }
++  watchdog_timer_.Stop();
++  if (!web_contents_) {
++    Respond(Error("Web contents destroyed"));
++    return;
++  }
++
++  // Only items not returned by this or earlier calls are kept
++  ProcessNewItems(
++      ContentProcessor::ExtractNewPageContent(
++          tree_update, dedupe_by_node_id_, max_items_ - items_.size(),
++          AnalOSHarvestState::FromWebContents(web_contents_.get())->seen()),
++      /*moved=*/true);
++}
++
++void AnalOSHarvestContentFunction::ScrollOnce() {
++  scroll_count_++;
++
++  // Wait for lazy loading triggered by the scroll to finish, bounded by the
++  // remaining time budget
++  base::TimeDelta remaining = deadline_ - base::TimeTicks::Now();
++  AnalOSScrollObserver::ExecuteAndWaitForSettle(
++      web_contents_.get(),
++      base::BindOnce(
++          [](content::WebContents* web_contents, int delta_y) {
++            Scroll(web_contents, 0, delta_y, true);
++          },
++          base::Unretained(web_contents_.get()), scroll_delta_),
++      base::BindOnce(&AnalOSHarvestContentFunction::OnScrollSettled, this),
++      base::Milliseconds(300), std::min(remaining, base::Seconds(5)));
++}
++
++void AnalOSHarvestContentFunction::OnScrollSettled(
++    const AnalOSScrollObserver::Result& result) {
++  if (did_respond()) {
++    return;
++  }
++  if (!web_contents_ || web_contents_->IsBeingDestroyed()) {
++    Respond(Error("Web contents destroyed"));
++    return;
++  }
++
++  // Only the subtrees the page reserialized since the last round are
++  // visited, so a round costs what the scroll revealed, not the page size
++  AnalOSHarvestState* state =
++      AnalOSHarvestState::FromWebContents(web_contents_.get());
++  ProcessNewItems(ContentProcessor::ExtractNewContentFromUpdates(
++                      state->TakeUpdates(), dedupe_by_node_id_,
++                      max_items_ - items_.size(), state->seen()),
++                  result.scrolled);
++}
++
++void AnalOSHarvestContentFunction::ProcessNewItems(
++    std::vector<browser_os::ContentItem> new_items,
++    bool moved) {
++  // A scroll that neither moved the page nor revealed anything means we hit
++  // the bottom; lazy feeds that are still loading get a few more tries
++  if (scroll_count_ > 0) {
++    idle_scrolls_ = new_items.empty() ? idle_scrolls_ + 1 : 0;
++  }
++
++  // Extraction already stopped at the remaining budget
++  bool found_new = !new_items.empty();
++  std::move(new_items.begin(), new_items.end(), std::back_inserter(items_));
++
++  if (items_.size() >= max_items_) {
++    Finish(browser_os::HarvestStopReason::kMaxItems);
++    return;
++  }
++  if (scroll_count_ > 0 && !found_new &&
++      (!moved || idle_scrolls_ >= max_idle_scrolls_)) {
++    Finish(browser_os::HarvestStopReason::kEndOfFeed);
++    return;
++  }
++  if (scroll_count_ >= max_scrolls_) {
++    Finish(browser_os::HarvestStopReason::kMaxScrolls);
++    return;
++  }
++  if (base::TimeTicks::Now() >= deadline_) {
++    Finish(browser_os::HarvestStopReason::kTimeout);
++    return;
++  }
++
++  ScrollOnce();
++}
++
++void AnalOSHarvestContentFunction::Finish(
++    browser_os::HarvestStopReason reason) {
++  VLOG(1) << "[analos] HarvestContent: " << items_.size() << " new items after "
++          << scroll_count_ << " scrolls, stopped on "
++          << browser_os::ToString(reason);
++
++  StopCollecting();
++
++  browser_os::HarvestResult result;
++  result.items = std::move(items_);
++  result.scroll_count = scroll_count_;
++  result.end_of_feed = reason == browser_os::HarvestStopReason::kEndOfFeed;
++  result.stop_reason = reason;
++  result.processing_time_ms =
++      (base::TimeTicks::Now() - start_time_).InMilliseconds();
++
++  Respond(ArgumentList(browser_os::HarvestContent::Results::Create(result)));
++}
++
++void AnalOSHarvestContentFunction::StopCollecting() {
++  if (!collecting_) {
++    return;
++  }
++  collecting_ = false;
++  // The state goes away with the tab
++  if (web_contents_) {
++    AnalOSHarvestState::FromWebContents(web_contents_.get())->StopCollecting();
++  }
++}
++
 +// AnalOSGetPrefFunction
 +ExtensionFunction::ResponseAction AnalOSGetPrefFunction::Run() {
 +  std::optional<browser_os::GetPref::Params> params =
@@ -1192,7 +2054,46 @@ index 0000000000000..58abbe5b785ed
 +      browser_os::GetAnalosVersionNumber::Results::Create(version)));
 +}
 +
++// AnalOSGetServerStatsFunction
++ExtensionFunction::ResponseAction AnalOSGetServerStatsFunction::Run() {
++  analos::AnalOSServerManager::ServerStats stats =
++      analos::AnalOSServerManager::GetInstance()->GetServerStats();
++
++  browser_os::ServerStats result;
++  result.running = stats.running;
++  if (stats.running) {
++    result.pid = static_cast<int>(stats.pid);
++    result.uptime_ms = stats.uptime.InMillisecondsF();
++  }
++  result.restart_count = stats.restart_count;
++  if (stats.process.resident_set_bytes) {
++    result.resident_set_bytes =
++        static_cast<double>(*stats.process.resident_set_bytes);
++  }
++  if (stats.process.cpu_time) {
++    result.cpu_time_ms = stats.process.cpu_time->InMillisecondsF();
++  }
++  result.open_fd_count = stats.process.open_fd_count;
++  result.health_check_count = static_cast<int>(stats.health_check_count);
++  if (stats.health_check_count > 0) {
++    result.health_check_latency_median_ms =
++        stats.health_check_latency_median.InMillisecondsF();
++    result.health_check_latency_p95_ms =
++        stats.health_check_latency_p95.InMillisecondsF();
++    result.health_check_latency_max_ms =
++        stats.health_check_latency_max.InMillisecondsF();
++  }
++  result.health_check_failures = stats.health_check_failures;
++
++  return RespondNow(
++      ArgumentList(browser_os::GetServerStats::Results::Create(result)));
++}
++
 +// AnalOSExecuteJavaScriptFunction
++
++AnalOSExecuteJavaScriptFunction::AnalOSExecuteJavaScriptFunction() = default;
++AnalOSExecuteJavaScriptFunction::~AnalOSExecuteJavaScriptFunction() = default;
++
 +ExtensionFunction::ResponseAction AnalOSExecuteJavaScriptFunction::Run() {
 +  std::optional<browser_os::ExecuteJavaScript::Params> params =
 +      browser_os::ExecuteJavaScript::Params::Create(args());
@@ -1206,32 +2107,153 @@ index 0000000000000..58abbe5b785ed
 +  if (!tab_info) {
 +    return RespondNow(Error(error_message));
 +  }
-+  
-+  content::WebContents* web_contents = tab_info->web_contents;
-+  
-+  // Get the primary main frame
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++
++  if (!PrepareExecution(tab_info->web_contents, params->options,
++                        /*isolated_by_default=*/false, &error_message)) {
++    return RespondNow(Error(error_message));
++  }
++
++  LOG(INFO) << "[analos] ExecuteJavaScript: Executing code in tab " << tab_info->tab_id
++            << (isolated_world_ ? " (isolated world)" : "");
++
++  Execute(LimitScriptResult(params->code));
++  return did_respond() ? AlreadyResponded() : RespondLater();
++}
++
++bool AnalOSExecuteJavaScriptFunction::PrepareExecution(
++    content::WebContents* web_contents,
++    const std::optional<browser_os::ExecuteJavaScriptOptions>& options,
++    bool isolated_by_default,
++    std::string* error) {
++  std::optional<int> frame_id;
++  base::TimeDelta timeout = base::Seconds(30);
++  max_result_bytes_ = 4 * 1024 * 1024;
++  isolated_world_ = isolated_by_default;
++  if (options) {
++    isolated_world_ =
++        options->isolated_world.value_or(isolated_by_default);
++    frame_id = options->frame_id;
++    if (options->timeout_ms && *options->timeout_ms > 0) {
++      timeout = base::Milliseconds(*options->timeout_ms);
++    }
++    if (options->max_result_bytes && *options->max_result_bytes > 0) {
++      max_result_bytes_ = static_cast<size_t>(*options->max_result_bytes);
++    }
++  }
++
++  // Resolve the target frame; defaults to the primary main frame
++  content::RenderFrameHost* rfh =
++      frame_id ? ExtensionApiFrameIdMap::GetRenderFrameHostById(web_contents,
++                                                                *frame_id)
++               : web_contents->GetPrimaryMainFrame();
 +  if (!rfh) {
-+    return RespondNow(Error("No render frame"));
++    *error = frame_id ? "Frame not found" : "No render frame";
++    return false;
 +  }
-+  
-+  LOG(INFO) << "[analos] ExecuteJavaScript: Executing code in tab " << tab_info->tab_id;
-+  
-+  // Convert JavaScript code string to UTF16
-+  std::u16string js_code = base::UTF8ToUTF16(params->code);
-+  
-+  // Execute the JavaScript code using ExecuteJavaScriptForTests
-+  // This will return the result of the execution
-+  rfh->ExecuteJavaScriptForTests(
-+      js_code,
-+      base::BindOnce(&AnalOSExecuteJavaScriptFunction::OnJavaScriptExecuted,
-+                     this),
-+      /*honor_js_content_settings=*/false);
-+  
-+  return RespondLater();
++  frame_id_ = rfh->GetGlobalId();
++
++  timeout_timer_.Start(
++      FROM_HERE, timeout,
++      base::BindOnce(&AnalOSExecuteJavaScriptFunction::OnTimeout, this));
++  return true;
++}
++
++void AnalOSExecuteJavaScriptFunction::Execute(const std::string& code) {
++  content::RenderFrameHost* rfh = content::RenderFrameHost::FromID(frame_id_);
++  if (!rfh) {
++    timeout_timer_.Stop();
++    Respond(Error("Frame was destroyed"));
++    return;
++  }
++
++  content::WebContents* web_contents =
++      content::WebContents::FromRenderFrameHost(rfh);
++  TabHelper* tab_helper = TabHelper::FromWebContents(web_contents);
++  if (!tab_helper) {
++    timeout_timer_.Stop();
++    Respond(Error("Cannot run scripts in this tab"));
++    return;
++  }
++
++  // Injected the way chrome.scripting does it, waiting for a returned
++  // promise to settle before reporting the result
++  std::vector<mojom::JSSourcePtr> sources;
++  sources.push_back(mojom::JSSource::New(code, GURL()));
++  tab_helper->script_executor()->ExecuteScript(
++      mojom::HostID(mojom::HostID::HostType::kExtensions, extension_id()),
++      mojom::CodeInjection::NewJs(mojom::JSInjection::New(
++          std::move(sources),
++          isolated_world_ ? mojom::ExecutionWorld::kIsolated
++                          : mojom::ExecutionWorld::kMain,
++          /*world_id=*/std::nullopt,
++          blink::mojom::WantResultOption::kWantResult,
++          blink::mojom::UserActivationOption::kDoNotActivate,
++          blink::mojom::PromiseResultOption::kAwait)),
++      ScriptExecutor::SPECIFIED_FRAMES,
++      {ExtensionApiFrameIdMap::GetFrameId(rfh)},
++      mojom::MatchOriginAsFallbackBehavior::kMatchForAboutSchemeAndClimbTree,
++      mojom::RunLocation::kDocumentStart, ScriptExecutor::DEFAULT_PROCESS,
++      /*webview_src=*/GURL(),
++      base::BindOnce(&AnalOSExecuteJavaScriptFunction::OnScriptFinished,
++                     this));
++}
++
++void AnalOSExecuteJavaScriptFunction::OnScriptFinished(
++    std::vector<ScriptExecutor::FrameResult> results) {
++  if (did_respond()) {
++    return;
++  }
++  if (results.empty() || !results[0].error.empty()) {
++    timeout_timer_.Stop();
++    Respond(Error(results.empty() ? "Frame was destroyed" : results[0].error));
++    return;
++  }
++  OnJavaScriptExecuted(std::move(results[0].value));
++}
++
++std::string AnalOSExecuteJavaScriptFunction::LimitScriptResult(
++    const std::string& code) const {
++  // An indirect eval runs |code| as a global script and yields its
++  // completion value, as injecting it directly would. An empty eval probes
++  // first whether the page's CSP allows it, so the script's own errors are
++  // not mistaken for a blocked eval.
++  return BuildResultLimitSource(
++      base::StrCat({"() => { try { (0, eval)(''); } catch { return {",
++                    kEvalBlockedKey, ": true}; } return (0, eval)(",
++                    base::GetQuotedJSONString(code), "); }"}),
++      max_result_bytes_);
++}
++
++std::string AnalOSExecuteJavaScriptFunction::LimitExpressionResult(
++    const std::string& expression) const {
++  return BuildResultLimitSource("() => (" + expression + ")",
++                                max_result_bytes_);
 +}
 +
 +void AnalOSExecuteJavaScriptFunction::OnJavaScriptExecuted(base::Value result) {
++  if (did_respond()) {
++    return;
++  }
++
++  // Running the script unwrapped would skip the page-side size limit
++  if (result.is_dict() &&
++      result.GetDict().FindBool(kEvalBlockedKey).value_or(false)) {
++    timeout_timer_.Stop();
++    Respond(Error("Content Security Policy blocks eval, which "
++                  "executeJavaScript needs to enforce maxResultBytes; use "
++                  "registerScript and runScript instead"));
++    return;
++  }
++  RespondWithResult(std::move(result));
++}
++
++void AnalOSExecuteJavaScriptFunction::RespondWithResult(base::Value result) {
++  // The timeout already answered the caller
++  if (did_respond()) {
++    return;
++  }
++  timeout_timer_.Stop();
++
 +  LOG(INFO) << "[analos] ExecuteJavaScript: Execution completed";
 +
 +  if (result.is_none()) {
@@ -1239,12 +2261,112 @@ index 0000000000000..58abbe5b785ed
 +      // Return an empty object instead of NONE to satisfy the validator
 +      result = base::Value(base::Value::Type::DICT);
 +  }
++
++  // The page already measured the result and dropped it
++  if (std::optional<double> size =
++          result.is_dict() ? result.GetDict().FindDouble(kResultTooLargeKey)
++                           : std::nullopt) {
++    Respond(Error("Result exceeds maxResultBytes (" +
++                  base::NumberToString(static_cast<int64_t>(*size)) + " > " +
++                  base::NumberToString(max_result_bytes_) + " bytes)"));
++    return;
++  }
++
++  // Refuse oversized results instead of handing them to the extension
++  std::optional<std::string> json = base::WriteJson(result);
++  if (!json || json->size() > max_result_bytes_) {
++    Respond(Error("Result exceeds maxResultBytes (" +
++                  base::NumberToString(json ? json->size() : 0) + " > " +
++                  base::NumberToString(max_result_bytes_) + " bytes)"));
++    return;
++  }
 +  
 +  // Return the result directly
 +  Respond(ArgumentList(
 +      browser_os::ExecuteJavaScript::Results::Create(result)));
 +}
 +
++void AnalOSExecuteJavaScriptFunction::OnTimeout() {
++  LOG(WARNING) << "[analos] ExecuteJavaScript: Timed out";
++  Respond(Error("Script execution timed out"));
++}
++
++// AnalOSRegisterScriptFunction
++ExtensionFunction::ResponseAction AnalOSRegisterScriptFunction::Run() {
++  std::optional<browser_os::RegisterScript::Params> params =
++      browser_os::RegisterScript::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  if (params->name.empty()) {
++    return RespondNow(Error("Script name must not be empty"));
++  }
++
++  AnalOSScriptRegistry::Get(browser_context())
++      ->Register(params->name, std::move(params->code));
++
++  return RespondNow(NoArguments());
++}
++
++// AnalOSRunScriptFunction
++
++AnalOSRunScriptFunction::AnalOSRunScriptFunction() = default;
++AnalOSRunScriptFunction::~AnalOSRunScriptFunction() = default;
++
++ExtensionFunction::ResponseAction AnalOSRunScriptFunction::Run() {
++  std::optional<browser_os::RunScript::Params> params =
++      browser_os::RunScript::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  const AnalOSScriptRegistry::Script* script =
++      AnalOSScriptRegistry::Get(browser_context())->Find(params->name);
++  if (!script) {
++    return RespondNow(Error("Script not registered: " + params->name));
++  }
++
++  // Get the target tab
++  std::string error_message;
++  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
++                                       include_incognito_information(),
++                                       &error_message);
++  if (!tab_info) {
++    return RespondNow(Error(error_message));
++  }
++
++  // Installed helpers stay out of reach of page scripts unless the caller
++  // asks for the main world
++  if (!PrepareExecution(tab_info->web_contents, params->options,
++                        /*isolated_by_default=*/true, &error_message)) {
++    return RespondNow(Error(error_message));
++  }
++
++  base::Value script_args =
++      params->args ? std::move(*params->args) : base::Value();
++  install_source_ = LimitExpressionResult(
++      AnalOSScriptRegistry::BuildInstallSource(params->name, *script,
++                                               script_args));
++
++  // Try the installed copy first; only the call expression is sent
++  Execute(LimitExpressionResult(AnalOSScriptRegistry::BuildCallSource(
++      params->name, *script, script_args)));
++  return did_respond() ? AlreadyResponded() : RespondLater();
++}
++
++void AnalOSRunScriptFunction::OnJavaScriptExecuted(base::Value result) {
++  if (did_respond()) {
++    return;
++  }
++
++  // First run in this document (or a newer version was registered):
++  // install the function and run it in the same round trip
++  if (!install_source_.empty() &&
++      AnalOSScriptRegistry::IsNotInstalledResult(result)) {
++    VLOG(1) << "[analos] RunScript: Installing script in frame";
++    Execute(std::exchange(install_source_, std::string()));
++    return;
++  }
++  RespondWithResult(std::move(result));
++}
++
 +// Implementation of AnalOSClickCoordinatesFunction
 +ExtensionFunction::ResponseAction AnalOSClickCoordinatesFunction::Run() {
 +  std::optional<browser_os::ClickCoordinates::Params> params =
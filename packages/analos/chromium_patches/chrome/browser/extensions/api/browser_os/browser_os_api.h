@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api.h b/chrome/browser/extensions/api/browser_os/browser_os_api.h
 new file mode 100644
-index 0000000000000..5f4276cf89432
+index 0000000000000..8e04a5f3eb113
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api.h
-@@ -0,0 +1,344 @@
+@@ -0,0 +1,746 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -12,14 +12,25 @@ index 0000000000000..5f4276cf89432
 +#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_API_H_
 +
 +#include <cstdint>
++#include <optional>
++#include <string>
++#include <vector>
 +
++#include "base/functional/bind.h"
 +#include "base/memory/raw_ptr.h"
++#include "base/memory/weak_ptr.h"
++#include "base/time/time.h"
++#include "base/timer/timer.h"
 +#include "base/values.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_content_processor.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_scroll_observer.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h"
++#include "content/public/browser/global_routing_id.h"
 +#include "extensions/browser/extension_function.h"
++#include "extensions/browser/script_executor.h"
 +#include "third_party/skia/include/core/SkBitmap.h"
++#include "ui/gfx/geometry/point_f.h"
 +
 +namespace content {
 +class WebContents;
@@ -57,6 +68,9 @@ index 0000000000000..5f4276cf89432
 +
 +  AnalOSGetInteractiveSnapshotFunction();
 +
++  // Snapshot IDs are shared with the batch variant
++  static uint32_t NextSnapshotId() { return next_snapshot_id_++; }
++
 + protected:
 +  ~AnalOSGetInteractiveSnapshotFunction() override;
 +
@@ -66,6 +80,8 @@ index 0000000000000..5f4276cf89432
 + private:
 +  void OnAccessibilityTreeReceived(ui::AXTreeUpdate& tree_update);
 +  void OnSnapshotProcessed(SnapshotProcessingResult result);
++  // Answers with an empty, truncated snapshot if the renderer never replied
++  void OnSnapshotTimeout();
 +  
 +  // Counter for snapshot IDs
 +  static uint32_t next_snapshot_id_;
@@ -73,8 +89,157 @@ index 0000000000000..5f4276cf89432
 +  // Tab ID for storing mappings
 +  int tab_id_ = -1;
 +  
-+  // Web contents for processing and drawing
-+  raw_ptr<content::WebContents> web_contents_ = nullptr;
++  // Web contents for processing and drawing; null once the tab is closed
++  base::WeakPtr<content::WebContents> web_contents_;
++
++  // Phase timing, reported in the result if requested
++  bool include_timings_ = false;
++  base::TimeTicks request_start_;
++  base::TimeDelta request_time_;
++
++  AXSnapshotLimits limits_;
++  bool truncated_ = false;
++  base::OneShotTimer watchdog_timer_;
++};
++
++// Fan-out bookkeeping shared by the batch functions: one result per
++// requested tab, completed in any order, and a single response once the
++// last one is done
++template <typename TabResult>
++class AnalOSBatchTabFunction : public ExtensionFunction {
++ protected:
++  ~AnalOSBatchTabFunction() override = default;
++
++  // Results of the finished batch, in request order
++  virtual base::Value::List CreateResults() = 0;
++
++  // Sets up one result per entry of |tab_ids|, timed from now
++  void StartBatch(const std::vector<int>& tab_ids) {
++    results_.resize(tab_ids.size());
++    start_times_.assign(tab_ids.size(), base::TimeTicks::Now());
++    replied_.assign(tab_ids.size(), false);
++    done_.assign(tab_ids.size(), false);
++    pending_ = tab_ids.size();
++    for (size_t i = 0; i < tab_ids.size(); ++i) {
++      results_[i].tab_id = tab_ids[i];
++    }
++  }
++
++  // Looks up the tab of result |index|, failing the result if it does not
++  // exist (anymore). Asynchronous steps call this again instead of holding
++  // on to the WebContents.
++  content::WebContents* GetBatchTab(size_t index) {
++    std::string error_message;
++    auto tab_info = GetTabFromOptionalId(results_[index].tab_id,
++                                         browser_context(),
++                                         include_incognito_information(),
++                                         &error_message);
++    if (!tab_info) {
++      FailTab(index, std::move(error_message));
++      return nullptr;
++    }
++    return tab_info->web_contents;
++  }
++
++  void FailTab(size_t index, std::string error) {
++    results_[index].error = std::move(error);
++    CompleteTab(index);
++  }
++
++  // Records the elapsed time of result |index| and responds once it was the
++  // last outstanding one
++  void CompleteTab(size_t index) {
++    if (done_[index]) {
++      return;
++    }
++    done_[index] = true;
++    results_[index].elapsed_ms = Elapsed(index).InMilliseconds();
++    if (--pending_ > 0) {
++      return;
++    }
++    watchdog_timer_.Stop();
++    Respond(ArgumentList(CreateResults()));
++  }
++
++  // Fails the tabs whose renderer has not replied within |timeout|. The
++  // renderer honors the snapshot timeout only while it is responsive.
++  void StartWatchdog(base::TimeDelta timeout) {
++    if (pending_ == 0) {
++      return;
++    }
++    watchdog_timer_.Start(
++        FROM_HERE, timeout,
++        base::BindOnce(&AnalOSBatchTabFunction::OnWatchdogTimeout,
++                       base::Unretained(this)));
++  }
++
++  // Marks the renderer reply for result |index| as received. Returns false
++  // if the watchdog already failed the tab, in which case the reply is
++  // dropped.
++  bool AcceptReply(size_t index) {
++    if (done_[index]) {
++      return false;
++    }
++    replied_[index] = true;
++    return true;
++  }
++
++  // What Run() returns once all requests are sent
++  ResponseAction BatchResponse() {
++    if (results_.empty()) {
++      return RespondNow(ArgumentList(CreateResults()));
++    }
++    return did_respond() ? AlreadyResponded() : RespondLater();
++  }
++
++  base::TimeDelta Elapsed(size_t index) const {
++    return base::TimeTicks::Now() - start_times_[index];
++  }
++
++  std::vector<TabResult> results_;
++  std::vector<base::TimeTicks> start_times_;
++  size_t pending_ = 0;
++
++ private:
++  void OnWatchdogTimeout() {
++    for (size_t i = 0; i < results_.size(); ++i) {
++      if (!replied_[i] && !done_[i]) {
++        FailTab(i, "No response from the renderer in time");
++      }
++    }
++  }
++
++  std::vector<bool> replied_;
++  std::vector<bool> done_;
++  base::OneShotTimer watchdog_timer_;
++};
++
++// Batch variant of getInteractiveSnapshot: requests all tabs at once and
++// responds when the slowest one is done
++class AnalOSGetInteractiveSnapshotsFunction
++    : public AnalOSBatchTabFunction<
++          browser_os::TabInteractiveSnapshotResult> {
++ public:
++  DECLARE_EXTENSION_FUNCTION("analOS.getInteractiveSnapshots",
++                             BROWSER_OS_GETINTERACTIVESNAPSHOTS)
++
++  AnalOSGetInteractiveSnapshotsFunction();
++
++ protected:
++  ~AnalOSGetInteractiveSnapshotsFunction() override;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++  // AnalOSBatchTabFunction:
++  base::Value::List CreateResults() override;
++
++ private:
++  void OnAccessibilityTreeReceived(size_t index,
++                                   ui::AXTreeUpdate& tree_update);
++  void OnSnapshotProcessed(size_t index,
++                           bool truncated,
++                           SnapshotProcessingResult result);
 +};
 +
 +class AnalOSClickFunction : public ExtensionFunction {
@@ -156,6 +321,49 @@ index 0000000000000..5f4276cf89432
 +  ResponseAction Run() override;
 +};
 +
++class AnalOSScrollByFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("analOS.scrollBy", BROWSER_OS_SCROLLBY)
++
++  AnalOSScrollByFunction();
++
++ protected:
++  ~AnalOSScrollByFunction() override;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++ private:
++  // Sends the wheel scroll, optionally waiting for the page to settle
++  void ScrollAndRespond(std::optional<gfx::PointF> css_point);
++  void OnContainerScrolledIntoView(const AnalOSScrollObserver::Result& result);
++  void OnScrollSettled(const AnalOSScrollObserver::Result& result);
++
++  raw_ptr<content::WebContents> web_contents_ = nullptr;
++  int delta_x_ = 0;
++  int delta_y_ = 0;
++  bool smooth_ = false;
++  bool wait_for_settle_ = true;
++  base::TimeDelta quiet_period_;
++  base::TimeDelta timeout_;
++};
++
++class AnalOSScrollToFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("analOS.scrollTo", BROWSER_OS_SCROLLTO)
++
++  AnalOSScrollToFunction() = default;
++
++ protected:
++  ~AnalOSScrollToFunction() override = default;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++ private:
++  void OnScrollSettled(const AnalOSScrollObserver::Result& result);
++};
++
 +class AnalOSScrollToNodeFunction : public ExtensionFunction {
 + public:
 +  DECLARE_EXTENSION_FUNCTION("analOS.scrollToNode", BROWSER_OS_SCROLLTONODE)
@@ -221,6 +429,116 @@ index 0000000000000..5f4276cf89432
 +
 + private:
 +  void OnAccessibilityTreeReceived(ui::AXTreeUpdate& tree_update);
++  // Answers with empty, truncated content if the renderer never replied
++  void OnSnapshotTimeout();
++
++  // Phase timing, reported in the result if requested
++  bool include_timings_ = false;
++  base::TimeTicks request_start_;
++
++  AXSnapshotLimits limits_;
++  base::OneShotTimer watchdog_timer_;
++};
++
++class AnalOSHarvestContentFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("analOS.harvestContent",
++                             BROWSER_OS_HARVESTCONTENT)
++
++  AnalOSHarvestContentFunction();
++
++ protected:
++  ~AnalOSHarvestContentFunction() override;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++ private:
++  // The first round reads a full snapshot; later rounds only read the
++  // accessibility updates that arrived while scrolling
++  void RequestSnapshot();
++  void OnAccessibilityTreeReceived(ui::AXTreeUpdate& tree_update);
++  void ScrollOnce();
++  void OnScrollSettled(const AnalOSScrollObserver::Result& result);
++
++  // Appends |new_items| within budget, then scrolls again or finishes.
++  // |moved| is whether the last scroll changed a scroll offset.
++  void ProcessNewItems(std::vector<browser_os::ContentItem> new_items,
++                       bool moved);
++  void Finish(browser_os::HarvestStopReason reason);
++  // Ends the harvest with what it has if the renderer never replied
++  void OnSnapshotTimeout();
++
++  // Ends the update collection started by Run(), if still running
++  void StopCollecting();
++
++  // Null once the tab is closed
++  base::WeakPtr<content::WebContents> web_contents_;
++  bool collecting_ = false;
++
++  // Budgets
++  size_t max_items_ = 500;
++  int max_scrolls_ = 20;
++  int max_idle_scrolls_ = 2;
++  int scroll_delta_ = 0;
++  bool dedupe_by_node_id_ = false;
++  base::TimeTicks deadline_;
++  base::TimeTicks start_time_;
++
++  // Progress
++  std::vector<browser_os::ContentItem> items_;
++  int scroll_count_ = 0;
++  int idle_scrolls_ = 0;
++
++  base::OneShotTimer watchdog_timer_;
++};
++
++// Batch variant of getSnapshot; content extraction runs on the thread pool
++class AnalOSGetSnapshotsFunction
++    : public AnalOSBatchTabFunction<browser_os::TabPageContentResult> {
++ public:
++  DECLARE_EXTENSION_FUNCTION("analOS.getSnapshots", BROWSER_OS_GETSNAPSHOTS)
++
++  AnalOSGetSnapshotsFunction();
++
++ protected:
++  ~AnalOSGetSnapshotsFunction() override;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++  // AnalOSBatchTabFunction:
++  base::Value::List CreateResults() override;
++
++ private:
++  void OnAccessibilityTreeReceived(size_t index, ui::AXTreeUpdate& tree_update);
++  void OnContentExtracted(size_t index,
++                          bool truncated,
++                          std::vector<browser_os::ContentItem> items);
++};
++
++// Batch variant of captureScreenshot (without highlights); PNG encoding
++// runs on the thread pool
++class AnalOSCaptureScreenshotsFunction
++    : public AnalOSBatchTabFunction<browser_os::TabScreenshotResult> {
++ public:
++  DECLARE_EXTENSION_FUNCTION("analOS.captureScreenshots",
++                             BROWSER_OS_CAPTURESCREENSHOTS)
++
++  AnalOSCaptureScreenshotsFunction();
++
++ protected:
++  ~AnalOSCaptureScreenshotsFunction() override;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++  // AnalOSBatchTabFunction:
++  base::Value::List CreateResults() override;
++
++ private:
++  void OnScreenshotCaptured(size_t index, const SkBitmap& bitmap);
++  void OnScreenshotEncoded(size_t index, std::optional<std::string> data_url);
 +};
 +
 +// Settings API functions
@@ -302,20 +620,104 @@ index 0000000000000..5f4276cf89432
 +  ResponseAction Run() override;
 +};
 +
++class AnalOSGetServerStatsFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("analOS.getServerStats", BROWSER_OS_GETSERVERSTATS)
++
++  AnalOSGetServerStatsFunction() = default;
++
++ protected:
++  ~AnalOSGetServerStatsFunction() override = default;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++};
++
 +class AnalOSExecuteJavaScriptFunction : public ExtensionFunction {
 + public:
 +  DECLARE_EXTENSION_FUNCTION("analOS.executeJavaScript", BROWSER_OS_EXECUTEJAVASCRIPT)
 +
-+  AnalOSExecuteJavaScriptFunction() = default;
++  AnalOSExecuteJavaScriptFunction();
 +
 + protected:
-+  ~AnalOSExecuteJavaScriptFunction() override = default;
++  ~AnalOSExecuteJavaScriptFunction() override;
 +
 +  // ExtensionFunction:
 +  ResponseAction Run() override;
-+  
++
++  // Applies |options| (frame, world, limits) and arms the timeout. The
++  // isolated world is used unless |options| says otherwise and
++  // |isolated_by_default| is true. Returns false with |error| set if the
++  // target frame does not exist.
++  bool PrepareExecution(
++      content::WebContents* web_contents,
++      const std::optional<browser_os::ExecuteJavaScriptOptions>& options,
++      bool isolated_by_default,
++      std::string* error);
++
++  // Runs |code| in the prepared frame through the tab's ScriptExecutor.
++  // Responds with an error if the frame went away since PrepareExecution().
++  void Execute(const std::string& code);
++
++  // Wrap |code| (a script) or |expression| so the page awaits the result
++  // and, if its JSON exceeds the size limit, returns a small marker instead.
++  // Oversized values are then never converted and sent to the browser. A
++  // script is run through eval; if CSP blocks it the call fails rather than
++  // going without the limit.
++  std::string LimitScriptResult(const std::string& code) const;
++  std::string LimitExpressionResult(const std::string& expression) const;
++
++  // Called with the (promise-resolved) script result
++  virtual void OnJavaScriptExecuted(base::Value result);
++
++  // Checks the size limit and responds with |result|
++  void RespondWithResult(base::Value result);
++
++ private:
++  void OnScriptFinished(std::vector<ScriptExecutor::FrameResult> results);
++  void OnTimeout();
++
++  content::GlobalRenderFrameHostId frame_id_;
++  bool isolated_world_ = false;
++  size_t max_result_bytes_ = 0;
++  base::OneShotTimer timeout_timer_;
++};
++
++class AnalOSRegisterScriptFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("analOS.registerScript",
++                             BROWSER_OS_REGISTERSCRIPT)
++
++  AnalOSRegisterScriptFunction() = default;
++
++ protected:
++  ~AnalOSRegisterScriptFunction() override = default;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++};
++
++// Runs a script stored by registerScript. Shares frame, world and limit
++// handling with executeJavaScript.
++class AnalOSRunScriptFunction : public AnalOSExecuteJavaScriptFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("analOS.runScript", BROWSER_OS_RUNSCRIPT)
++
++  AnalOSRunScriptFunction();
++
++ protected:
++  ~AnalOSRunScriptFunction() override;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++  // AnalOSExecuteJavaScriptFunction:
++  void OnJavaScriptExecuted(base::Value result) override;
++
 + private:
-+  void OnJavaScriptExecuted(base::Value result);
++  // Source that installs the script in the frame, sent only if the cheap
++  // call reports the script missing
++  std::string install_source_;
 +};
 +
 +class AnalOSClickCoordinatesFunction : public ExtensionFunction {
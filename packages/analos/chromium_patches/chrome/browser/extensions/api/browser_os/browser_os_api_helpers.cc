@@ -1,15 +1,19 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.cc b/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.cc
 new file mode 100644
-index 0000000000000..f40a2424641e1
+index 0000000000000..4394793bad6c7
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.cc
-@@ -0,0 +1,1073 @@
+@@ -0,0 +1,1203 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
 +
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h"
 +
++#include "base/functional/callback_helpers.h"
++#include "base/json/json_reader.h"
++#include "base/json/json_writer.h"
++#include "base/memory/weak_ptr.h"
 +#include "base/strings/string_number_conversions.h"
 +#include "base/strings/stringprintf.h"
 +#include "base/strings/utf_string_conversions.h"
@@ -17,6 +21,10 @@ index 0000000000000..f40a2424641e1
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_change_detector.h"
 +#include "components/input/native_web_keyboard_event.h"
++#include "content/browser/devtools/render_frame_devtools_agent_host.h"
++#include "content/browser/renderer_host/render_frame_host_impl.h"
++#include "content/public/browser/devtools_agent_host.h"
++#include "content/public/browser/devtools_agent_host_client.h"
 +#include "content/public/browser/render_frame_host.h"
 +#include "content/browser/renderer_host/render_widget_host_impl.h"
 +#include "content/public/browser/render_widget_host.h"
@@ -38,10 +46,131 @@ index 0000000000000..f40a2424641e1
 +#include "ui/gfx/range/range.h"
 +#include "ui/accessibility/ax_action_data.h"
 +#include "ui/accessibility/ax_enums.mojom.h"
++#include "ui/accessibility/ax_mode.h"
++#include "ui/accessibility/ax_tree_update.h"
 +
 +namespace extensions {
 +namespace api {
 +
++namespace {
++
++// Bound on the snapshot that finds the root scroller for ScrollPageTo
++constexpr base::TimeDelta kRootScrollerLookupTimeout = base::Seconds(1);
++
++// Calls a JavaScript function with |this| bound to the DOM node behind a
++// snapshot node. The node is resolved over the DevTools protocol from its
++// DOM node ID, which is the backend node ID, in the session of the frame
++// that owns it; no selector is involved. Owns itself until the call was
++// answered or the frame went away.
++class DomNodeFunctionCall : public content::DevToolsAgentHostClient {
++ public:
++  static void Start(content::RenderFrameHost* rfh,
++                    int32_t dom_node_id,
++                    std::string function) {
++    auto* call = new DomNodeFunctionCall(std::move(function));
++    call->host_ = content::RenderFrameDevToolsAgentHost::GetOrCreateFor(
++        static_cast<content::RenderFrameHostImpl*>(rfh)->frame_tree_node());
++    if (!call->host_ || !call->host_->AttachClient(call)) {
++      LOG(WARNING) << "[analos] Cannot attach to frame for DOM node call";
++      call->host_ = nullptr;
++      call->Finish();
++      return;
++    }
++    base::Value::Dict params;
++    params.Set("backendNodeId", dom_node_id);
++    call->Send(kResolveNodeRequest, "DOM.resolveNode", std::move(params));
++  }
++
++  DomNodeFunctionCall(const DomNodeFunctionCall&) = delete;
++  DomNodeFunctionCall& operator=(const DomNodeFunctionCall&) = delete;
++
++  // content::DevToolsAgentHostClient:
++  void DispatchProtocolMessage(content::DevToolsAgentHost* host,
++                               base::span<const uint8_t> message) override {
++    std::optional<base::Value::Dict> reply = base::JSONReader::ReadDict(
++        std::string_view(reinterpret_cast<const char*>(message.data()),
++                         message.size()));
++    std::optional<int> id = reply ? reply->FindInt("id") : std::nullopt;
++    if (!id) {
++      return;  // An event
++    }
++
++    if (const base::Value::Dict* error = reply->FindDict("error")) {
++      const std::string* text = error->FindString("message");
++      LOG(WARNING) << "[analos] DOM node call failed: "
++                   << (text ? *text : "unknown error");
++      Finish();
++      return;
++    }
++
++    if (*id == kResolveNodeRequest) {
++      const std::string* object_id =
++          reply->FindStringByDottedPath("result.object.objectId");
++      if (!object_id) {
++        Finish();
++        return;
++      }
++      base::Value::Dict params;
++      params.Set("objectId", *object_id);
++      params.Set("functionDeclaration", function_);
++      params.Set("userGesture", true);
++      Send(kCallFunctionRequest, "Runtime.callFunctionOn", std::move(params));
++      return;
++    }
++    Finish();
++  }
++
++  void AgentHostClosed(content::DevToolsAgentHost* host) override {
++    host_ = nullptr;
++    Finish();
++  }
++
++ private:
++  static constexpr int kResolveNodeRequest = 1;
++  static constexpr int kCallFunctionRequest = 2;
++
++  explicit DomNodeFunctionCall(std::string function)
++      : function_(std::move(function)) {}
++  ~DomNodeFunctionCall() override = default;
++
++  void Send(int id, std::string_view method, base::Value::Dict params) {
++    base::Value::Dict message;
++    message.Set("id", id);
++    message.Set("method", method);
++    message.Set("params", std::move(params));
++    std::string json = base::WriteJson(message).value_or(std::string());
++    host_->DispatchProtocolMessage(this, base::as_byte_span(json));
++  }
++
++  // Detaching releases the resolved object with the session
++  void Finish() {
++    if (host_) {
++      host_->DetachClient(this);
++    }
++    delete this;
++  }
++
++  scoped_refptr<content::DevToolsAgentHost> host_;
++  const std::string function_;
++};
++
++// Runs |function| on the node's DOM element in the frame that owns it.
++// Returns false if the snapshot did not record a DOM node.
++bool CallFunctionOnNode(content::WebContents* web_contents,
++                        const NodeInfo& node_info,
++                        std::string function) {
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
++  if (!rfh || !node_info.dom_node_id) {
++    LOG(WARNING) << "[analos] No DOM node for AX node "
++                 << node_info.ax_node_id;
++    return false;
++  }
++  DomNodeFunctionCall::Start(rfh, node_info.dom_node_id, std::move(function));
++  return true;
++}
++
++}  // namespace
++
 +// Compute CSS->widget scale matching DevTools InputHandler::ScaleFactor.
 +// We intentionally exclude device scale factor (DSF). Widget coordinates
 +// used by input are in DIPs; DSF is handled by the compositor. We also set
@@ -82,6 +211,18 @@ index 0000000000000..f40a2424641e1
 +      node_info.bounds.y() + node_info.bounds.height() / 2.0f);
 +}
 +
++// Returns the frame that owns the node's accessibility tree, falling back to
++// the primary main frame when the tree ID is unknown or no longer live.
++content::RenderFrameHost* GetFrameForNode(content::WebContents* web_contents,
++                                          const NodeInfo& node_info) {
++  if (content::RenderFrameHost* rfh =
++          content::RenderFrameHost::FromAXTreeID(node_info.ax_tree_id)) {
++    if (content::WebContents::FromRenderFrameHost(rfh) == web_contents) {
++      return rfh;
++    }
++  }
++  return web_contents->GetPrimaryMainFrame();
++}
 +
 +// Helper to create and dispatch mouse events for clicking
 +void PointClick(content::WebContents* web_contents, 
@@ -130,142 +271,31 @@ index 0000000000000..f40a2424641e1
 +  rwh->ForwardMouseEvent(mouse_up);
 +}
 +
-+// Helper to perform HTML-based click using JS (uses ID, class, or tag)
++// Helper to call click() on the exact DOM node from the snapshot. Unlike
++// AccessibilityDoDefault this goes through the DOM, so it still works where
++// the node's default action is not a click.
 +void HtmlClick(content::WebContents* web_contents,
 +                      const NodeInfo& node_info) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+  if (!rfh)
-+    return;
-+    
-+  // Build the JavaScript to find and click the element
-+  std::u16string js_code = u"(function() {";
-+  
-+  // Try to find element by ID first
-+  auto id_it = node_info.attributes.find("id");
-+  if (id_it != node_info.attributes.end() && !id_it->second.empty()) {
-+    js_code += u"  var element = document.getElementById('" + 
-+               base::UTF8ToUTF16(id_it->second) + u"');";
-+    js_code += u"  if (element) {";
-+    js_code += u"    element.click();";
-+    js_code += u"    return 'clicked by id';";
-+    js_code += u"  }";
-+  }
-+  
-+  // Try to find by class and tag combination
-+  auto class_it = node_info.attributes.find("class");
-+  auto tag_it = node_info.attributes.find("html-tag");
-+  
-+  if (class_it != node_info.attributes.end() && !class_it->second.empty() &&
-+      tag_it != node_info.attributes.end() && !tag_it->second.empty()) {
-+    // Split class names and create selector
-+    std::string class_selector = "." + class_it->second;
-+    // Replace spaces with dots for multiple classes
-+    for (size_t i = 0; i < class_selector.length(); ++i) {
-+      if (class_selector[i] == ' ') {
-+        class_selector[i] = '.';
-+      }
-+    }
-+    
-+    js_code += u"  var elements = document.querySelectorAll('" + 
-+               base::UTF8ToUTF16(tag_it->second + class_selector) + u"');";
-+    js_code += u"  if (elements.length > 0) {";
-+    js_code += u"    elements[0].click();";
-+    js_code += u"    return 'clicked by class and tag';";
-+    js_code += u"  }";
-+  }
-+  
-+  // Fallback: try just by tag name if available
-+  if (tag_it != node_info.attributes.end() && !tag_it->second.empty()) {
-+    js_code += u"  var elements = document.getElementsByTagName('" + 
-+               base::UTF8ToUTF16(tag_it->second) + u"');";
-+    js_code += u"  if (elements.length > 0) {";
-+    js_code += u"    elements[0].click();";
-+    js_code += u"    return 'clicked by tag';";
-+    js_code += u"  }";
-+  }
-+  
-+  js_code += u"  return 'no element found';";
-+  js_code += u"})();";
-+  
-+  // Execute the JavaScript
-+  rfh->ExecuteJavaScriptForTests(
-+      js_code,
-+      base::NullCallback(),
-+      /*honor_js_content_settings=*/false);
++  VLOG(1) << "[analos] HtmlClick on AX node " << node_info.ax_node_id;
++  CallFunctionOnNode(web_contents, node_info, "function() { this.click(); }");
 +}
 +
-+// Helper to perform HTML-based focus using JS (uses ID, class, or tag)
++// Helper to call focus() on the exact DOM node from the snapshot and select
++// its text where it has any (see HtmlClick)
 +void HtmlFocus(content::WebContents* web_contents,
 +                      const NodeInfo& node_info) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+  if (!rfh)
-+    return;
-+    
-+  // Build the JavaScript to find and focus the element
-+  std::u16string js_code = u"(function() {";
-+  
-+  // Try to find element by ID first
-+  auto id_it = node_info.attributes.find("id");
-+  if (id_it != node_info.attributes.end() && !id_it->second.empty()) {
-+    js_code += u"  var element = document.getElementById('" + 
-+               base::UTF8ToUTF16(id_it->second) + u"');";
-+    js_code += u"  if (element) {";
-+    js_code += u"    element.focus();";
-+    js_code += u"    if (element.select) element.select();";  // Select text if possible
-+    js_code += u"    return 'focused by id';";
-+    js_code += u"  }";
-+  }
-+  
-+  // Try to find by class and tag combination
-+  auto class_it = node_info.attributes.find("class");
-+  auto tag_it = node_info.attributes.find("html-tag");
-+  
-+  if (class_it != node_info.attributes.end() && !class_it->second.empty() &&
-+      tag_it != node_info.attributes.end() && !tag_it->second.empty()) {
-+    // Split class names and create selector
-+    std::string class_selector = "." + class_it->second;
-+    // Replace spaces with dots for multiple classes
-+    for (size_t i = 0; i < class_selector.length(); ++i) {
-+      if (class_selector[i] == ' ') {
-+        class_selector[i] = '.';
-+      }
-+    }
-+    
-+    js_code += u"  var elements = document.querySelectorAll('" + 
-+               base::UTF8ToUTF16(tag_it->second + class_selector) + u"');";
-+    js_code += u"  if (elements.length > 0) {";
-+    js_code += u"    elements[0].focus();";
-+    js_code += u"    if (elements[0].select) elements[0].select();";
-+    js_code += u"    return 'focused by class and tag';";
-+    js_code += u"  }";
-+  }
-+  
-+  // Fallback: try just by tag name if available
-+  if (tag_it != node_info.attributes.end() && !tag_it->second.empty()) {
-+    js_code += u"  var elements = document.getElementsByTagName('" + 
-+               base::UTF8ToUTF16(tag_it->second) + u"');";
-+    js_code += u"  if (elements.length > 0) {";
-+    js_code += u"    elements[0].focus();";
-+    js_code += u"    if (elements[0].select) elements[0].select();";
-+    js_code += u"    return 'focused by tag';";
-+    js_code += u"  }";
-+  }
-+  
-+  js_code += u"  return 'no element found';";
-+  js_code += u"})();";
-+  
-+  // Execute the JavaScript
-+  rfh->ExecuteJavaScriptForTests(
-+      js_code,
-+      base::NullCallback(),
-+      /*honor_js_content_settings=*/false);
++  VLOG(1) << "[analos] HtmlFocus on AX node " << node_info.ax_node_id;
++  CallFunctionOnNode(
++      web_contents, node_info,
++      "function() { this.focus(); if (this.select) this.select(); }");
 +}
 +
 +// Helper to perform scroll actions using mouse wheel events
 +void Scroll(content::WebContents* web_contents,
 +                   int delta_x,
 +                   int delta_y,
-+                   bool precise) {
++                   bool precise,
++                   std::optional<gfx::PointF> css_point) {
 +  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
 +  if (!rfh)
 +    return;
@@ -282,6 +312,12 @@ index 0000000000000..f40a2424641e1
 +  gfx::Rect viewport_bounds = rwhv->GetViewBounds();
 +  gfx::PointF center_point(viewport_bounds.width() / 2.0f,
 +                          viewport_bounds.height() / 2.0f);
++
++  // Target a specific scroll container by landing the wheel event on it
++  if (css_point) {
++    const float scale = CssToWidgetScale(web_contents, rwh);
++    center_point = gfx::PointF(css_point->x() * scale, css_point->y() * scale);
++  }
 +  
 +  // Create mouse wheel event
 +  blink::WebMouseWheelEvent wheel_event;
@@ -323,6 +359,82 @@ index 0000000000000..f40a2424641e1
 +  rwh->ForwardWheelEvent(wheel_event);
 +}
 +
++// Helper to perform accessibility action: SetScrollOffset
++bool AccessibilitySetScrollOffset(content::WebContents* web_contents,
++                                  const NodeInfo& node_info,
++                                  const gfx::Point& offset) {
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
++  if (!rfh) {
++    LOG(WARNING) << "[analos] No RenderFrameHost for AccessibilitySetScrollOffset";
++    return false;
++  }
++
++  ui::AXActionData action_data;
++  action_data.action = ax::mojom::Action::kSetScrollOffset;
++  action_data.target_node_id = node_info.ax_node_id;
++  action_data.target_tree_id = node_info.ax_tree_id;
++  action_data.target_point = offset;
++
++  LOG(INFO) << "[analos] Performing AccessibilitySetScrollOffset on node "
++            << node_info.ax_node_id << " to " << offset.ToString();
++
++  rfh->AccessibilityPerformAction(action_data);
++  return true;
++}
++
++// Helper to scroll the page's root scroller to an absolute offset
++void ScrollPageTo(content::WebContents* web_contents,
++                  const gfx::Point& offset,
++                  bool smooth,
++                  base::OnceClosure on_dispatched) {
++  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  if (!rfh) {
++    std::move(on_dispatched).Run();
++    return;
++  }
++
++  // The root scroller is the main frame's document node. A one-node
++  // snapshot names it and holds its current offset, so the scroll goes
++  // through the same paths as container scrolls and scrollBy instead of
++  // injected script.
++  web_contents->RequestAXTreeSnapshot(
++      base::BindOnce(
++          [](base::WeakPtr<content::WebContents> web_contents,
++             gfx::Point offset, bool smooth, base::OnceClosure on_dispatched,
++             ui::AXTreeUpdate& tree_update) {
++            base::ScopedClosureRunner dispatched(std::move(on_dispatched));
++            if (!web_contents || tree_update.nodes.empty()) {
++              LOG(WARNING) << "[analos] No root scroller to scroll";
++              return;
++            }
++            content::RenderFrameHost* rfh =
++                web_contents->GetPrimaryMainFrame();
++            if (!rfh)
++              return;
++
++            // SetScrollOffset has no animated variant
++            if (smooth) {
++              const ui::AXNodeData& root = tree_update.nodes[0];
++              Scroll(web_contents.get(),
++                     offset.x() - root.GetIntAttribute(
++                                      ax::mojom::IntAttribute::kScrollX),
++                     offset.y() - root.GetIntAttribute(
++                                      ax::mojom::IntAttribute::kScrollY),
++                     /*precise=*/false);
++              return;
++            }
++
++            NodeInfo root;
++            root.ax_node_id = tree_update.root_id;
++            root.ax_tree_id = rfh->GetAXTreeID();
++            AccessibilitySetScrollOffset(web_contents.get(), root, offset);
++          },
++          web_contents->GetWeakPtr(), offset, smooth,
++          std::move(on_dispatched)),
++      ui::kAXModeBasic, /*max_nodes=*/1, kRootScrollerLookupTimeout,
++      content::WebContents::AXTreeSnapshotPolicy::kAll);
++}
++
 +// Helper to send special key events
 +void KeyPress(content::WebContents* web_contents,
 +                    const std::string& key) {
@@ -546,7 +658,7 @@ index 0000000000000..f40a2424641e1
 +// Helper to perform accessibility action: DoDefault (click)
 +bool AccessibilityDoDefault(content::WebContents* web_contents,
 +                            const NodeInfo& node_info) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
 +  if (!rfh) {
 +    LOG(WARNING) << "[analos] No RenderFrameHost for AccessibilityDoDefault";
 +    return false;
@@ -567,7 +679,7 @@ index 0000000000000..f40a2424641e1
 +// Helper to perform accessibility action: Focus
 +bool AccessibilityFocus(content::WebContents* web_contents,
 +                       const NodeInfo& node_info) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
 +  if (!rfh) {
 +    LOG(WARNING) << "[analos] No RenderFrameHost for AccessibilityFocus";
 +    return false;
@@ -589,7 +701,7 @@ index 0000000000000..f40a2424641e1
 +bool AccessibilityScrollToMakeVisible(content::WebContents* web_contents,
 +                                      const NodeInfo& node_info,
 +                                      bool center_in_viewport) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
 +  if (!rfh) {
 +    LOG(WARNING) << "[analos] No RenderFrameHost for AccessibilityScrollToMakeVisible";
 +    return false;
@@ -650,7 +762,7 @@ index 0000000000000..f40a2424641e1
 +    if (!changed) {
 +      // Skip coordinate click for out-of-viewport nodes (coordinates unreliable)
 +      // Go straight to HTML click
-+      LOG(INFO) << "[analos] No change from accessibility click, trying HTML click";
++      LOG(INFO) << "[analos] No change from coordinate click, trying HTML click";
 +      changed = AnalOSChangeDetector::ExecuteWithDetection(
 +          web_contents,
 +          [&]() { HtmlClick(web_contents, node_info); },
@@ -672,7 +784,7 @@ index 0000000000000..f40a2424641e1
 +  
 +  // If still no change, try HTML click as final fallback
 +  if (!changed) {
-+      LOG(INFO) << "[analos] No change from accessibility click, trying HTML click";
++      LOG(INFO) << "[analos] No change from coordinate click, trying HTML click";
 +      changed = AnalOSChangeDetector::ExecuteWithDetection(
 +          web_contents,
 +          [&]() { HtmlClick(web_contents, node_info); },
@@ -687,7 +799,7 @@ index 0000000000000..f40a2424641e1
 +bool AccessibilitySetValue(content::WebContents* web_contents,
 +                           const NodeInfo& node_info,
 +                           const std::string& text) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
 +  if (!rfh) {
 +    LOG(WARNING) << "[analos] No RenderFrameHost for AccessibilitySetValue";
 +    return false;
@@ -700,7 +812,7 @@ index 0000000000000..f40a2424641e1
 +  action_data.value = text;
 +  
 +  LOG(INFO) << "[analos] Performing AccessibilitySetValue on node " 
-+            << node_info.ax_node_id << " with text: " << text;
++            << node_info.ax_node_id << " (" << text.size() << " bytes)";
 +  
 +  rfh->AccessibilityPerformAction(action_data);
 +  return true;
@@ -761,36 +873,54 @@ index 0000000000000..f40a2424641e1
 +  return changed;
 +}
 +
++// Helper to replace an element's value in a single operation
++bool BulkTypeWithDetection(content::WebContents* web_contents,
++                           const NodeInfo& node_info,
++                           const std::string& text,
++                           bool verify) {
++  // SetValue is resolved to the exact node in the renderer, which assigns the
++  // value and dispatches one input/change pair. No focus, scrolling or
++  // per-character events are needed, so cost does not grow with text length.
++  LOG(INFO) << "[analos] Bulk inserting " << text.size() << " bytes into node "
++            << node_info.ax_node_id;
++
++  bool changed;
++  if (verify) {
++    changed = AnalOSChangeDetector::ExecuteWithValueVerification(
++        web_contents, node_info.ax_node_id, node_info.ax_tree_id, text,
++        [&]() { AccessibilitySetValue(web_contents, node_info, text); });
++  } else {
++    changed = AnalOSChangeDetector::ExecuteWithDetection(
++        web_contents,
++        [&]() { AccessibilitySetValue(web_contents, node_info, text); },
++        base::Milliseconds(300));
++  }
++
++  LOG(INFO) << "[analos] Bulk type result: "
++            << (changed ? (verify ? "verified" : "changed")
++                        : (verify ? "value not read back" : "no change"));
++  return changed;
++}
++
 +// Helper to clear an input field with change detection
 +bool ClearWithDetection(content::WebContents* web_contents,
 +                       const NodeInfo& node_info) {
-+  // Use change detection with JavaScript clear
++  // Clear the node itself rather than whatever the main frame has focused
 +  bool changed = AnalOSChangeDetector::ExecuteWithDetection(
 +      web_contents,
 +      [&]() {
-+        content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+        if (!rfh) return;
-+        
-+        // First focus the element
-+        HtmlFocus(web_contents, node_info);
-+        
-+        // Then clear using JavaScript
-+        rfh->ExecuteJavaScriptForTests(
-+            u"(function() {"
-+            u"  var activeElement = document.activeElement;"
-+            u"  if (activeElement) {"
-+            u"    if (activeElement.value !== undefined) {"
-+            u"      activeElement.value = '';"
-+            u"    }"
-+            u"    if (activeElement.textContent !== undefined && activeElement.isContentEditable) {"
-+            u"      activeElement.textContent = '';"
-+            u"    }"
-+            u"    activeElement.dispatchEvent(new Event('input', {bubbles: true}));"
-+            u"    activeElement.dispatchEvent(new Event('change', {bubbles: true}));"
-+            u"  }"
-+            u"})();",
-+            base::NullCallback(),
-+            /*honor_js_content_settings=*/false);
++        CallFunctionOnNode(
++            web_contents, node_info,
++            "function() {"
++            "  this.focus();"
++            "  if (this.value !== undefined) {"
++            "    this.value = '';"
++            "  } else if (this.isContentEditable) {"
++            "    this.textContent = '';"
++            "  }"
++            "  this.dispatchEvent(new Event('input', {bubbles: true}));"
++            "  this.dispatchEvent(new Event('change', {bubbles: true}));"
++            "}");
 +      },
 +      base::Milliseconds(200));
 +  
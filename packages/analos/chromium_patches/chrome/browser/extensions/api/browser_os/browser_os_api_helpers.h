@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h b/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h
 new file mode 100644
-index 0000000000000..2000fa3235290
+index 0000000000000..9cd45e9c99261
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h
-@@ -0,0 +1,137 @@
+@@ -0,0 +1,177 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -11,15 +11,18 @@ index 0000000000000..2000fa3235290
 +#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_API_HELPERS_H_
 +#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_API_HELPERS_H_
 +
++#include <optional>
 +#include <string>
 +#include <unordered_map>
 +
 +#include "base/functional/callback.h"
++#include "ui/gfx/geometry/point.h"
 +#include "ui/gfx/geometry/point_f.h"
 +
 +namespace content {
-+class WebContents;
++class RenderFrameHost;
 +class RenderWidgetHost;
++class WebContents;
 +}  // namespace content
 +
 +namespace extensions {
@@ -40,15 +43,22 @@ index 0000000000000..2000fa3235290
 +gfx::PointF GetNodeCenterPoint(content::WebContents* web_contents,
 +                               const NodeInfo& node_info);
 +
++// Returns the frame that owns the node's accessibility tree, falling back to
++// the primary main frame when the tree ID no longer resolves.
++content::RenderFrameHost* GetFrameForNode(content::WebContents* web_contents,
++                                          const NodeInfo& node_info);
++
 +// Helper to create and dispatch mouse events for clicking
 +void PointClick(content::WebContents* web_contents, 
 +                  const gfx::PointF& point);
 +
-+// Helper to perform HTML-based click using JS (uses ID, class, or tag)
++// Helper to perform a DOM click() on the exact node, resolved from its DOM
++// node ID in the frame that owns it (no selector guessing)
 +void HtmlClick(content::WebContents* web_contents,
 +                      const NodeInfo& node_info);
 +
-+// Helper to perform HTML-based focus using JS (uses ID, class, or tag)
++// Helper to perform a DOM focus() and, for text fields, select() on the
++// exact node, resolved the same way as HtmlClick
 +void HtmlFocus(content::WebContents* web_contents,
 +                      const NodeInfo& node_info);
 +
@@ -77,10 +87,31 @@ index 0000000000000..2000fa3235290
 +                           const std::string& text);
 +
 +// Helper to perform scroll actions using mouse wheel events
++// precise: pixel-exact, unanimated scroll; otherwise the compositor animates
++// css_point: where the wheel event lands (CSS pixels), selecting the scroll
++// container under it; defaults to the viewport center
 +void Scroll(content::WebContents* web_contents,
 +                   int delta_x,
 +                   int delta_y,
-+                   bool precise = false);
++                   bool precise = false,
++                   std::optional<gfx::PointF> css_point = std::nullopt);
++
++// Helper to perform accessibility action: SetScrollOffset
++// Scrolls the node's own scroll container to |offset| (instant)
++// Returns true if action was sent successfully
++bool AccessibilitySetScrollOffset(content::WebContents* web_contents,
++                                  const NodeInfo& node_info,
++                                  const gfx::Point& offset);
++
++// Helper to scroll the page's root scroller to an absolute offset
++// (CSS pixels). An instant scroll uses the accessibility SetScrollOffset
++// action; a smooth one wheels by the distance from the current offset, like
++// a smooth scrollBy. The root node is looked up first, so the scroll happens
++// asynchronously; |on_dispatched| runs once it has been sent (or given up).
++void ScrollPageTo(content::WebContents* web_contents,
++                  const gfx::Point& offset,
++                  bool smooth,
++                  base::OnceClosure on_dispatched);
 +
 +// Helper to send special key events
 +void KeyPress(content::WebContents* web_contents,
@@ -106,6 +137,15 @@ index 0000000000000..2000fa3235290
 +                      const NodeInfo& node_info,
 +                      const std::string& text);
 +
++// Helper to replace an element's value in one SetValue operation (a single
++// input/change event pair). When |verify| is true, waits for the AX tree to
++// report the new value for the node instead of any page change.
++// Returns true if the value was set (and read back, when verifying)
++bool BulkTypeWithDetection(content::WebContents* web_contents,
++                           const NodeInfo& node_info,
++                           const std::string& text,
++                           bool verify);
++
 +// Helper to clear an input field with change detection
 +// Returns true if the clear caused a change in the page
 +bool ClearWithDetection(content::WebContents* web_contents,
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api_utils.cc b/chrome/browser/extensions/api/browser_os/browser_os_api_utils.cc
 new file mode 100644
-index 0000000000000..0c3a060fc70de
+index 0000000000000..0f091b4368f69
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api_utils.cc
-@@ -0,0 +1,167 @@
+@@ -0,0 +1,302 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -11,6 +11,7 @@ index 0000000000000..0c3a060fc70de
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +
 +#include "base/hash/hash.h"
++#include "base/logging.h"
 +#include "base/no_destructor.h"
 +#include "base/strings/string_number_conversions.h"
 +#include "base/strings/utf_string_conversions.h"
@@ -20,13 +21,51 @@ index 0000000000000..0c3a060fc70de
 +#include "chrome/browser/ui/browser_finder.h"
 +#include "chrome/browser/ui/tabs/tab_strip_model.h"
 +#include "content/public/browser/web_contents.h"
++#include "content/public/browser/web_contents_observer.h"
++#include "content/public/browser/web_contents_user_data.h"
 +#include "ui/accessibility/ax_role_properties.h"
 +
 +namespace extensions {
 +namespace api {
 +
++namespace {
++
++// Owns the node ID state of the tab it is attached to and drops it when the
++// tab's WebContents goes away
++class NodeIdMappingsCleaner
++    : public content::WebContentsObserver,
++      public content::WebContentsUserData<NodeIdMappingsCleaner> {
++ public:
++  NodeIdMappingsCleaner(const NodeIdMappingsCleaner&) = delete;
++  NodeIdMappingsCleaner& operator=(const NodeIdMappingsCleaner&) = delete;
++  ~NodeIdMappingsCleaner() override = default;
++
++ private:
++  friend class content::WebContentsUserData<NodeIdMappingsCleaner>;
++
++  NodeIdMappingsCleaner(content::WebContents* web_contents, int tab_id)
++      : content::WebContentsObserver(web_contents),
++        content::WebContentsUserData<NodeIdMappingsCleaner>(*web_contents),
++        tab_id_(tab_id) {}
++
++  // WebContentsObserver overrides
++  void WebContentsDestroyed() override {
++    GetNodeIdMappings().erase(tab_id_);
++    GetTabNodeIdStates().erase(tab_id_);
++    VLOG(2) << "[analos] Dropped node IDs of closed tab " << tab_id_;
++  }
++
++  const int tab_id_;
++
++  WEB_CONTENTS_USER_DATA_KEY_DECL();
++};
++
++WEB_CONTENTS_USER_DATA_KEY_IMPL(NodeIdMappingsCleaner);
++
++}  // namespace
++
 +// NodeInfo implementation
-+NodeInfo::NodeInfo() : ax_node_id(0), ax_tree_id(), node_type(browser_os::InteractiveNodeType::kOther), in_viewport(false) {}
++NodeInfo::NodeInfo() : ax_node_id(0), ax_tree_id(), dom_node_id(0), node_type(browser_os::InteractiveNodeType::kOther), in_viewport(false), generation(0) {}
 +NodeInfo::~NodeInfo() = default;
 +NodeInfo::NodeInfo(const NodeInfo&) = default;
 +NodeInfo& NodeInfo::operator=(const NodeInfo&) = default;
@@ -42,6 +81,102 @@ index 0000000000000..0c3a060fc70de
 +  return *g_node_id_mappings;
 +}
 +
++TabNodeIdState::TabNodeIdState() = default;
++TabNodeIdState::~TabNodeIdState() = default;
++
++std::unordered_map<int, TabNodeIdState>& GetTabNodeIdStates() {
++  static base::NoDestructor<std::unordered_map<int, TabNodeIdState>>
++      g_tab_node_id_states;
++  return *g_tab_node_id_states;
++}
++
++uint32_t GetOrAssignStableNodeId(TabNodeIdState& state,
++                                 const ui::AXTreeID& ax_tree_id,
++                                 int32_t ax_node_id) {
++  auto [it, inserted] =
++      state.ids.try_emplace(std::make_pair(ax_tree_id, ax_node_id), 0u);
++  if (inserted) {
++    it->second = state.next_id++;
++  }
++  return it->second;
++}
++
++void PruneNodeIdMappings(int tab_id, uint32_t generation) {
++  // Nothing to prune once the tab is closed
++  auto state_it = GetTabNodeIdStates().find(tab_id);
++  if (state_it == GetTabNodeIdStates().end()) {
++    return;
++  }
++  auto& mappings = GetNodeIdMappings()[tab_id];
++  TabNodeIdState& state = state_it->second;
++
++  size_t pruned = 0;
++  for (auto it = mappings.begin(); it != mappings.end();) {
++    if (it->second.generation == generation) {
++      ++it;
++      continue;
++    }
++    state.ids.erase(
++        std::make_pair(it->second.ax_tree_id, it->second.ax_node_id));
++    it = mappings.erase(it);
++    ++pruned;
++  }
++
++  // IDs assigned to nodes that were filtered out before reaching the mapping
++  // table would otherwise accumulate
++  if (state.ids.size() > mappings.size()) {
++    std::erase_if(state.ids, [&mappings](const auto& entry) {
++      return !mappings.contains(entry.second);
++    });
++  }
++
++  VLOG(2) << "[analos] Pruned " << pruned << " stale node IDs for tab "
++          << tab_id << " (" << mappings.size() << " remain)";
++}
++
++void ClearNodeIdMappingsOnDestruction(content::WebContents* web_contents,
++                                      int tab_id) {
++  // No-op if the tab is already watched
++  NodeIdMappingsCleaner::CreateForWebContents(web_contents, tab_id);
++}
++
++ui::AXMode GetAXModeForProfile(AXSnapshotProfile profile) {
++  switch (profile) {
++    case AXSnapshotProfile::kInteractive:
++      return ui::AXMode(ui::AXMode::kWebContents |
++                        ui::AXMode::kExtendedProperties);
++    case AXSnapshotProfile::kText:
++      // Extended properties carry heading levels
++      return ui::AXMode(ui::AXMode::kWebContents |
++                        ui::AXMode::kExtendedProperties);
++    case AXSnapshotProfile::kFull:
++      return ui::AXMode(ui::AXMode::kWebContents |
++                        ui::AXMode::kExtendedProperties |
++                        ui::AXMode::kInlineTextBoxes);
++  }
++}
++
++AXSnapshotLimits GetAXSnapshotLimits(std::optional<int> max_nodes,
++                                     std::optional<int> timeout_ms) {
++  AXSnapshotLimits limits;
++  if (max_nodes && *max_nodes > 0) {
++    limits.max_nodes = static_cast<size_t>(*max_nodes);
++  }
++  if (timeout_ms && *timeout_ms > 0) {
++    limits.timeout = base::Milliseconds(*timeout_ms);
++  }
++  return limits;
++}
++
++bool IsAXSnapshotTruncated(const AXSnapshotLimits& limits,
++                           const ui::AXTreeUpdate& tree_update,
++                           base::TimeDelta elapsed) {
++  // The update does not say why serialization stopped, so infer it from
++  // having reached either limit
++  return tree_update.nodes.size() >= limits.max_nodes ||
++         elapsed >= limits.timeout;
++}
++
 +std::optional<TabInfo> GetTabFromOptionalId(
 +    std::optional<int> tab_id_param,
 +    content::BrowserContext* browser_context,
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api_utils.h b/chrome/browser/extensions/api/browser_os/browser_os_api_utils.h
 new file mode 100644
-index 0000000000000..f4fdcb73186cd
+index 0000000000000..bd073d8eab887
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api_utils.h
-@@ -0,0 +1,80 @@
+@@ -0,0 +1,153 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -11,15 +11,21 @@ index 0000000000000..f4fdcb73186cd
 +#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_API_UTILS_H_
 +#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_API_UTILS_H_
 +
++#include <cstdint>
++#include <map>
 +#include <optional>
 +#include <string>
 +#include <unordered_map>
++#include <utility>
 +
 +#include "base/memory/raw_ptr.h"
++#include "base/time/time.h"
 +#include "base/values.h"
 +#include "chrome/common/extensions/api/browser_os.h"
++#include "ui/accessibility/ax_mode.h"
 +#include "ui/accessibility/ax_node_data.h"
 +#include "ui/accessibility/ax_tree_id.h"
++#include "ui/accessibility/ax_tree_update.h"
 +#include "ui/gfx/geometry/rect_f.h"
 +
 +namespace content {
@@ -54,16 +60,83 @@ index 0000000000000..f4fdcb73186cd
 +
 +  int32_t ax_node_id;
 +  ui::AXTreeID ax_tree_id;  // Tree ID for change detection
++  int32_t dom_node_id;  // DOM node ID (DevTools backend node ID), 0 if none
 +  gfx::RectF bounds;  // Absolute bounds in CSS pixels
 +  std::unordered_map<std::string, std::string> attributes;  // All computed attributes
 +  browser_os::InteractiveNodeType node_type;  // Cached node type to avoid recomputation
 +  bool in_viewport;  // Whether the node is currently visible in viewport
++  uint32_t generation;  // Snapshot generation that last refreshed this entry
 +};
 +
 +// Global node ID mappings storage
 +std::unordered_map<int, std::unordered_map<uint32_t, NodeInfo>>& 
 +GetNodeIdMappings();
 +
++// Interactive node IDs of a tab. An ID is bound to one AX node (tree ID and
++// AX node ID) and is reused by every snapshot that still contains that node,
++// so IDs from older snapshots stay valid until the node goes away.
++struct TabNodeIdState {
++  TabNodeIdState();
++  ~TabNodeIdState();
++
++  // Incremented for every snapshot of the tab
++  uint32_t generation = 0;
++  uint32_t next_id = 1;
++  std::map<std::pair<ui::AXTreeID, int32_t>, uint32_t> ids;
++};
++
++// Global per-tab node ID state
++std::unordered_map<int, TabNodeIdState>& GetTabNodeIdStates();
++
++// Returns the stable interactive node ID for the given AX node in a tab's
++// |state|, assigning a new one the first time the node is seen. Takes the
++// state rather than the tab ID so that it never recreates the state of a
++// closed tab.
++uint32_t GetOrAssignStableNodeId(TabNodeIdState& state,
++                                 const ui::AXTreeID& ax_tree_id,
++                                 int32_t ax_node_id);
++
++// Drops mappings of |tab_id| that the snapshot of |generation| did not
++// refresh, i.e. whose AX node no longer exists
++void PruneNodeIdMappings(int tab_id, uint32_t generation);
++
++// Drops all node ID mappings and state of |tab_id| once |web_contents| is
++// destroyed, so closed tabs do not keep them for the rest of the session
++void ClearNodeIdMappingsOnDestruction(content::WebContents* web_contents,
++                                      int tab_id);
++
++// What an accessibility tree snapshot is used for. Each profile requests
++// only the data its consumer reads, since every extra AXMode flag adds
++// renderer serialization work and, for inline text boxes, many extra nodes.
++enum class AXSnapshotProfile {
++  // Interactive snapshots: roles, names, bounds and HTML attributes
++  kInteractive,
++  // Content extraction: roles, names, values, URLs and heading levels
++  kText,
++  // Everything, including inline text boxes; only when a caller asks
++  kFull,
++};
++
++ui::AXMode GetAXModeForProfile(AXSnapshotProfile profile);
++
++// Bounds on a single accessibility tree snapshot. The renderer stops
++// serializing once either is reached and returns the nodes it has so far.
++struct AXSnapshotLimits {
++  size_t max_nodes = 50000;
++  base::TimeDelta timeout = base::Seconds(5);
++};
++
++// Limits from optional per-call options; missing or non-positive values
++// keep the defaults
++AXSnapshotLimits GetAXSnapshotLimits(std::optional<int> max_nodes,
++                                     std::optional<int> timeout_ms);
++
++// Whether |tree_update|, received |elapsed| after it was requested, was
++// probably cut short by |limits|
++bool IsAXSnapshotTruncated(const AXSnapshotLimits& limits,
++                           const ui::AXTreeUpdate& tree_update,
++                           base::TimeDelta elapsed);
++
 +// Helper to get WebContents and tab ID from optional tab_id parameter
 +// Returns nullptr if tab is not found, with error message set
 +std::optional<TabInfo> GetTabFromOptionalId(
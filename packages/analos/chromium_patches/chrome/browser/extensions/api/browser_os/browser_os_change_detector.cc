@@ -1,27 +1,71 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_change_detector.cc b/chrome/browser/extensions/api/browser_os/browser_os_change_detector.cc
 new file mode 100644
-index 0000000000000..ea45bebcce461
+index 0000000000000..22115aa113196
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_change_detector.cc
-@@ -0,0 +1,205 @@
+@@ -0,0 +1,349 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
 +
 +#include "chrome/browser/extensions/api/browser_os/browser_os_change_detector.h"
 +
++#include <string>
++
 +#include "base/functional/bind.h"
 +#include "base/logging.h"
 +#include "base/run_loop.h"
++#include "base/strings/string_util.h"
++#include "base/strings/utf_string_conversions.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +#include "content/public/browser/focused_node_details.h"
 +#include "content/public/browser/navigation_handle.h"
 +#include "content/public/browser/render_frame_host.h"
 +#include "content/public/browser/web_contents.h"
++#include "ui/accessibility/ax_enums.mojom.h"
++#include "ui/accessibility/ax_node_data.h"
++#include "ui/accessibility/ax_role_properties.h"
 +#include "ui/accessibility/ax_updates_and_events.h"
 +
 +namespace extensions {
 +namespace api {
 +
++namespace {
++
++// Bounds on the snapshot that reads a value back after the wait timed out
++constexpr size_t kReadBackMaxNodes = 50000;
++constexpr base::TimeDelta kReadBackTimeout = base::Milliseconds(500);
++
++// Returns true if |node| reports |expected| as its value, allowing for what
++// the page and the AX tree do to a value on the way:
++//  - password fields expose a mask of the same length
++//  - single-line fields drop line breaks; others turn CRLF into LF
++//  - maxlength and the AX string attribute limit cut long values short, so
++//    a non-empty prefix of the expected value counts as well
++bool ValueMatches(const ui::AXNodeData& node, const std::string& expected) {
++  const std::string& value =
++      node.GetStringAttribute(ax::mojom::StringAttribute::kValue);
++  if (value == expected) {
++    return true;
++  }
++
++  if (node.HasState(ax::mojom::State::kProtected)) {
++    return base::UTF8ToUTF16(value).size() ==
++           base::UTF8ToUTF16(expected).size();
++  }
++
++  std::string normalized = expected;
++  if (ui::IsTextField(node.role) &&
++      !node.HasState(ax::mojom::State::kMultiline)) {
++    std::erase_if(normalized, [](char c) { return c == '\r' || c == '\n'; });
++  } else {
++    base::ReplaceSubstringsAfterOffset(&normalized, 0, "\r\n", "\n");
++  }
++  return !value.empty() && base::StartsWith(normalized, value);
++}
++
++}  // namespace
++
 +AnalOSChangeDetector::AnalOSChangeDetector(content::WebContents* web_contents)
 +    : content::WebContentsObserver(web_contents) {}
 +
@@ -49,6 +93,21 @@ index 0000000000000..ea45bebcce461
 +  detector->ExecuteAndNotify(std::move(action), std::move(callback), timeout);
 +}
 +
++// Static method for synchronous value read-back
++bool AnalOSChangeDetector::ExecuteWithValueVerification(
++    content::WebContents* web_contents,
++    int32_t ax_node_id,
++    const ui::AXTreeID& ax_tree_id,
++    const std::string& expected_value,
++    std::function<void()> action,
++    base::TimeDelta timeout) {
++  auto detector = std::make_unique<AnalOSChangeDetector>(web_contents);
++  detector->expected_value_ = expected_value;
++  detector->watched_node_id_ = ax_node_id;
++  detector->watched_tree_id_ = ax_tree_id;
++  return detector->ExecuteAndWait(std::move(action), timeout);
++}
++
 +void AnalOSChangeDetector::StartMonitoring() {
 +  monitoring_ = true;
 +  change_detected_ = false;
@@ -140,7 +199,18 @@ index 0000000000000..ea45bebcce461
 +}
 +
 +void AnalOSChangeDetector::OnTimeout() {
++  // A value set without a matching update (e.g. one coalesced into a later
++  // serialization) may still be in place; check before reporting failure
++  if (monitoring_ && expected_value_ && !read_back_requested_) {
++    ReadBackValue();
++    return;
++  }
++
 +  VLOG(1) << "[analos] Change detection timeout";
++  OnNoChange();
++}
++
++void AnalOSChangeDetector::OnNoChange() {
 +  monitoring_ = false;
 +  
 +  // If synchronous wait, quit the run loop
@@ -155,12 +225,58 @@ index 0000000000000..ea45bebcce461
 +  }
 +}
 +
++void AnalOSChangeDetector::ReadBackValue() {
++  read_back_requested_ = true;
++  if (!web_contents()) {
++    OnNoChange();
++    return;
++  }
++
++  VLOG(1) << "[analos] No value update received, reading node "
++          << watched_node_id_ << " back";
++  web_contents()->RequestAXTreeSnapshot(
++      base::BindOnce(&AnalOSChangeDetector::OnValueReadBack,
++                     weak_factory_.GetWeakPtr()),
++      GetAXModeForProfile(AXSnapshotProfile::kText), kReadBackMaxNodes,
++      kReadBackTimeout, content::WebContents::AXTreeSnapshotPolicy::kAll);
++
++  // The snapshot is not answered if the page goes away; give up after twice
++  // its own deadline
++  timeout_timer_.Start(FROM_HERE, 2 * kReadBackTimeout,
++                       base::BindOnce(&AnalOSChangeDetector::OnTimeout,
++                                      weak_factory_.GetWeakPtr()));
++}
++
++void AnalOSChangeDetector::OnValueReadBack(ui::AXTreeUpdate& tree_update) {
++  if (!monitoring_) {
++    return;  // An update arrived meanwhile
++  }
++
++  if (HasExpectedValue(tree_update.nodes)) {
++    VLOG(2) << "[analos] Expected value read back from snapshot";
++    OnChangeDetected();
++    return;
++  }
++
++  VLOG(1) << "[analos] Value not read back from snapshot";
++  OnNoChange();
++}
++
 +// WebContentsObserver overrides - any of these counts as a "change"
 +
 +void AnalOSChangeDetector::AccessibilityEventReceived(
 +    const ui::AXUpdatesAndEvents& details) {
 +  if (!monitoring_) return;
 +  
++  // When verifying a value, wait for the node itself to report it
++  if (expected_value_) {
++    if (MatchesExpectedValue(details)) {
++      VLOG(2) << "[analos] Expected value read back from AX tree";
++      OnChangeDetected();
++    }
++    return;
++  }
++
 +  // Any accessibility event indicates a change
 +  if (!details.updates.empty() || !details.events.empty()) {
 +    VLOG(2) << "[analos] Accessibility event detected";
@@ -168,9 +284,37 @@ index 0000000000000..ea45bebcce461
 +  }
 +}
 +
++bool AnalOSChangeDetector::MatchesExpectedValue(
++    const ui::AXUpdatesAndEvents& details) const {
++  // The snapshot may carry a tree ID the live tree no longer uses (e.g. the
++  // combined snapshot tree); only filter on it when both sides are known.
++  if (watched_tree_id_ != ui::AXTreeIDUnknown() &&
++      details.ax_tree_id != ui::AXTreeIDUnknown() &&
++      details.ax_tree_id != watched_tree_id_) {
++    return false;
++  }
++
++  for (const auto& update : details.updates) {
++    if (HasExpectedValue(update.nodes)) {
++      return true;
++    }
++  }
++  return false;
++}
++
++bool AnalOSChangeDetector::HasExpectedValue(
++    const std::vector<ui::AXNodeData>& nodes) const {
++  for (const auto& node : nodes) {
++    if (node.id == watched_node_id_ && ValueMatches(node, *expected_value_)) {
++      return true;
++    }
++  }
++  return false;
++}
++
 +void AnalOSChangeDetector::DidFinishNavigation(
 +    content::NavigationHandle* navigation_handle) {
-+  if (!monitoring_) return;
++  if (!monitoring_ || expected_value_) return;
 +  
 +  VLOG(2) << "[analos] Navigation detected";
 +  OnChangeDetected();
@@ -178,7 +322,7 @@ index 0000000000000..ea45bebcce461
 +
 +void AnalOSChangeDetector::DOMContentLoaded(
 +    content::RenderFrameHost* render_frame_host) {
-+  if (!monitoring_) return;
++  if (!monitoring_ || expected_value_) return;
 +  
 +  VLOG(2) << "[analos] DOM content loaded";
 +  OnChangeDetected();
@@ -186,7 +330,7 @@ index 0000000000000..ea45bebcce461
 +
 +void AnalOSChangeDetector::OnFocusChangedInPage(
 +    const content::FocusedNodeDetails& details) {
-+  if (!monitoring_) return;
++  if (!monitoring_ || expected_value_) return;
 +
 +  VLOG(2) << "[analos] Focus changed";
 +  OnChangeDetected();
@@ -201,7 +345,7 @@ index 0000000000000..ea45bebcce461
 +    ui::PageTransition transition,
 +    bool started_from_context_menu,
 +    bool renderer_initiated) {
-+  if (!monitoring_) return;
++  if (!monitoring_ || expected_value_) return;
 +  
 +  VLOG(2) << "[analos] New URL opened";
 +  OnChangeDetected();
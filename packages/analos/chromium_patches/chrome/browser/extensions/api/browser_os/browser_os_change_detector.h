@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_change_detector.h b/chrome/browser/extensions/api/browser_os/browser_os_change_detector.h
 new file mode 100644
-index 0000000000000..a45117498c829
+index 0000000000000..17b0fe4fbf9ff
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_change_detector.h
-@@ -0,0 +1,108 @@
+@@ -0,0 +1,149 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -12,18 +12,24 @@ index 0000000000000..a45117498c829
 +#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_CHANGE_DETECTOR_H_
 +
 +#include <functional>
++#include <optional>
++#include <string>
++#include <vector>
 +
 +#include "base/functional/callback.h"
 +#include "base/memory/weak_ptr.h"
 +#include "base/time/time.h"
 +#include "base/timer/timer.h"
 +#include "content/public/browser/web_contents_observer.h"
++#include "ui/accessibility/ax_tree_id.h"
++#include "ui/accessibility/ax_tree_update.h"
 +
 +namespace content {
 +class WebContents;
 +}  // namespace content
 +
 +namespace ui {
++struct AXNodeData;
 +struct AXUpdatesAndEvents;
 +}  // namespace ui
 +
@@ -49,6 +55,20 @@ index 0000000000000..a45117498c829
 +      base::OnceCallback<void(bool)> callback,
 +      base::TimeDelta timeout = base::Milliseconds(300));
 +
++  // Execute an action and wait until the accessibility tree reports
++  // |expected_value| as the value of node |ax_node_id|, allowing for masked
++  // password values, line break normalization and truncation. Other changes
++  // in the page are ignored. If no update carries the value before
++  // |timeout|, the node is read back from a fresh snapshot before giving up.
++  // Returns true if the value was read back.
++  static bool ExecuteWithValueVerification(
++      content::WebContents* web_contents,
++      int32_t ax_node_id,
++      const ui::AXTreeID& ax_tree_id,
++      const std::string& expected_value,
++      std::function<void()> action,
++      base::TimeDelta timeout = base::Milliseconds(500));
++
 +  // Constructor and destructor are public for use by factory methods
 +  explicit AnalOSChangeDetector(content::WebContents* web_contents);
 +  ~AnalOSChangeDetector() override;
@@ -60,6 +80,17 @@ index 0000000000000..a45117498c829
 +  // Start monitoring for changes
 +  void StartMonitoring();
 +
++  // Returns true if |details| carries the expected value for the watched node
++  bool MatchesExpectedValue(const ui::AXUpdatesAndEvents& details) const;
++
++  // Returns true if |nodes| holds the watched node with the expected value
++  bool HasExpectedValue(const std::vector<ui::AXNodeData>& nodes) const;
++
++  // Snapshots the page to read the watched node's value, for values whose
++  // update was coalesced away or never sent
++  void ReadBackValue();
++  void OnValueReadBack(ui::AXTreeUpdate& tree_update);
++
 +  // Execute the action and wait for changes
 +  bool ExecuteAndWait(std::function<void()> action, base::TimeDelta timeout);
 +
@@ -93,9 +124,19 @@ index 0000000000000..a45117498c829
 +  // Called when timeout expires
 +  void OnTimeout();
 +
++  // Ends monitoring without a change
++  void OnNoChange();
++
 +  // Simple state tracking
 +  bool monitoring_ = false;
 +  bool change_detected_ = false;
++
++  // Value watch for ExecuteWithValueVerification; when set, only an update
++  // carrying this value for the watched node counts as a change
++  std::optional<std::string> expected_value_;
++  int32_t watched_node_id_ = 0;
++  ui::AXTreeID watched_tree_id_;
++  bool read_back_requested_ = false;
 +  
 +  // Callbacks
 +  base::OnceClosure wait_callback_;
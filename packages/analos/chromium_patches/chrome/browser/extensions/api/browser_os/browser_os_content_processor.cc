@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_content_processor.cc b/chrome/browser/extensions/api/browser_os/browser_os_content_processor.cc
 new file mode 100644
-index 0000000000000..4166f1a38737c
+index 0000000000000..b3060ba6f7ab4
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_content_processor.cc
-@@ -0,0 +1,247 @@
+@@ -0,0 +1,366 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -64,9 +64,9 @@ index 0000000000000..4166f1a38737c
 +  LOG(INFO) << "analos: ExtractPageContent - processing " << tree_update.nodes.size() << " nodes";
 +
 +  // Build node map for O(1) lookup
-+  std::unordered_map<int32_t, ui::AXNodeData> node_map;
++  NodeMap node_map;
 +  for (const auto& node : tree_update.nodes) {
-+    node_map[node.id] = node;
++    node_map[node.id] = &node;
 +  }
 +
 +  // Start DFS from root
@@ -77,23 +77,135 @@ index 0000000000000..4166f1a38737c
 +  return items;
 +}
 +
++ContentProcessor::SeenContent::SeenContent() = default;
++ContentProcessor::SeenContent::~SeenContent() = default;
++
++void ContentProcessor::SeenContent::Clear() {
++  node_ids.clear();
++  content_keys.clear();
++}
++
++// static
++std::vector<browser_os::ContentItem> ContentProcessor::ExtractNewPageContent(
++    const ui::AXTreeUpdate& tree_update,
++    bool dedupe_by_node_id,
++    size_t max_items,
++    SeenContent& seen) {
++  std::vector<browser_os::ContentItem> new_items;
++
++  if (tree_update.nodes.empty()) {
++    return new_items;
++  }
++
++  NodeMap node_map;
++  for (const auto& node : tree_update.nodes) {
++    node_map[node.id] = &node;
++  }
++
++  std::vector<browser_os::ContentItem> items;
++  std::vector<int32_t> source_ids;
++  TraverseDFS(tree_update.root_id, node_map, items, &source_ids);
++  CollectNewItems(items, source_ids, dedupe_by_node_id, max_items, seen,
++                  new_items);
++
++  VLOG(1) << "analos: ExtractNewPageContent - " << new_items.size()
++          << " new of " << items.size() << " items";
++
++  return new_items;
++}
++
++// static
++std::vector<browser_os::ContentItem>
++ContentProcessor::ExtractNewContentFromUpdates(
++    const std::vector<ui::AXTreeUpdate>& updates,
++    bool dedupe_by_node_id,
++    size_t max_items,
++    SeenContent& seen) {
++  std::vector<browser_os::ContentItem> new_items;
++  size_t node_count = 0;
++
++  for (const auto& update : updates) {
++    if (new_items.size() >= max_items) {
++      break;
++    }
++    node_count += update.nodes.size();
++
++    // An update serializes changed subtrees in pre-order; their roots are
++    // the nodes no other node in the update lists as a child
++    NodeMap node_map;
++    std::unordered_set<int32_t> child_ids;
++    for (const auto& node : update.nodes) {
++      node_map[node.id] = &node;
++      child_ids.insert(node.child_ids.begin(), node.child_ids.end());
++    }
++
++    std::vector<browser_os::ContentItem> items;
++    std::vector<int32_t> source_ids;
++    for (const auto& node : update.nodes) {
++      if (!child_ids.contains(node.id)) {
++        TraverseDFS(node.id, node_map, items, &source_ids);
++      }
++    }
++    CollectNewItems(items, source_ids, dedupe_by_node_id, max_items, seen,
++                    new_items);
++  }
++
++  VLOG(1) << "analos: ExtractNewContentFromUpdates - " << new_items.size()
++          << " new items from " << node_count << " updated nodes";
++
++  return new_items;
++}
++
++// static
++void ContentProcessor::CollectNewItems(
++    std::vector<browser_os::ContentItem>& items,
++    const std::vector<int32_t>& source_ids,
++    bool dedupe_by_node_id,
++    size_t max_items,
++    SeenContent& seen,
++    std::vector<browser_os::ContentItem>& new_items) {
++  for (size_t i = 0; i < items.size() && new_items.size() < max_items; ++i) {
++    bool is_new = dedupe_by_node_id
++                      ? seen.node_ids.insert(source_ids[i]).second
++                      : seen.content_keys.insert(GetContentKey(items[i]))
++                            .second;
++    if (is_new) {
++      new_items.push_back(std::move(items[i]));
++    }
++  }
++}
++
++// static
++std::string ContentProcessor::GetContentKey(
++    const browser_os::ContentItem& item) {
++  std::string key = browser_os::ToString(item.type);
++  for (const auto* field : {&item.text, &item.url, &item.alt}) {
++    key += '\x1f';
++    if (field->has_value()) {
++      key += **field;
++    }
++  }
++  return key;
++}
++
 +// static
 +void ContentProcessor::TraverseDFS(
 +    int32_t node_id,
-+    const std::unordered_map<int32_t, ui::AXNodeData>& node_map,
-+    std::vector<browser_os::ContentItem>& items) {
++    const NodeMap& node_map,
++    std::vector<browser_os::ContentItem>& items,
++    std::vector<int32_t>* source_ids) {
 +
 +  auto it = node_map.find(node_id);
 +  if (it == node_map.end()) {
 +    return;
 +  }
 +
-+  const ui::AXNodeData& node = it->second;
++  const ui::AXNodeData& node = *it->second;
 +
 +  // Skip extracting from ignored nodes, but still recurse to children
 +  if (node.IsIgnored()) {
 +    for (int32_t child_id : node.child_ids) {
-+      TraverseDFS(child_id, node_map, items);
++      TraverseDFS(child_id, node_map, items, source_ids);
 +    }
 +    return;
 +  }
@@ -101,23 +213,30 @@ index 0000000000000..4166f1a38737c
 +  // Extract content at semantic boundaries
 +  // Don't recurse into these - their children are just formatting
 +
++  auto add_item = [&](browser_os::ContentItem item) {
++    items.push_back(std::move(item));
++    if (source_ids) {
++      source_ids->push_back(node.id);
++    }
++  };
++
 +  if (ui::IsHeading(node.role)) {
-+    items.push_back(ExtractHeading(node));
++    add_item(ExtractHeading(node));
 +    return;
 +  }
 +
 +  if (ui::IsLink(node.role)) {
-+    items.push_back(ExtractLink(node));
++    add_item(ExtractLink(node));
 +    return;
 +  }
 +
 +  if (ui::IsImage(node.role)) {
-+    items.push_back(ExtractImage(node));
++    add_item(ExtractImage(node));
 +    return;
 +  }
 +
 +  if (node.role == ax::mojom::Role::kVideo) {
-+    items.push_back(ExtractVideo(node));
++    add_item(ExtractVideo(node));
 +    return;
 +  }
 +
@@ -125,14 +244,14 @@ index 0000000000000..4166f1a38737c
 +    // Extract text content
 +    auto item = ExtractText(node);
 +    if (item.text.has_value() && !item.text->empty()) {
-+      items.push_back(std::move(item));
++      add_item(std::move(item));
 +    }
 +    return;
 +  }
 +
 +  // For container nodes (divs, sections, etc.), recurse to children
 +  for (int32_t child_id : node.child_ids) {
-+    TraverseDFS(child_id, node_map, items);
++    TraverseDFS(child_id, node_map, items, source_ids);
 +  }
 +}
 +
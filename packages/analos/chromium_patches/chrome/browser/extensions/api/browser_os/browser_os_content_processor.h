@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_content_processor.h b/chrome/browser/extensions/api/browser_os/browser_os_content_processor.h
 new file mode 100644
-index 0000000000000..472c7b114fe97
+index 0000000000000..2357fd1db7e62
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_content_processor.h
-@@ -0,0 +1,57 @@
+@@ -0,0 +1,107 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -11,8 +11,10 @@ index 0000000000000..472c7b114fe97
 +#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_CONTENT_PROCESSOR_H_
 +#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_CONTENT_PROCESSOR_H_
 +
++#include <cstdint>
 +#include <string>
 +#include <unordered_map>
++#include <unordered_set>
 +#include <vector>
 +
 +#include "chrome/common/extensions/api/browser_os.h"
@@ -39,12 +41,60 @@ index 0000000000000..472c7b114fe97
 +  static std::vector<browser_os::ContentItem> ExtractPageContent(
 +      const ui::AXTreeUpdate& tree_update);
 +
++  // Items already returned by earlier harvesting rounds for a tab
++  struct SeenContent {
++    SeenContent();
++    ~SeenContent();
++
++    void Clear();
++
++    std::unordered_set<int32_t> node_ids;
++    // Full content keys rather than hashes, so distinct items never collide
++    std::unordered_set<std::string> content_keys;
++  };
++
++  // Extracts at most |max_items| items that are not in |seen| yet, in
++  // document order, and records only those returned in |seen|. When
++  // |dedupe_by_node_id| is true, items are keyed by their AX node; otherwise
++  // by their content, which also drops repeats re-rendered by virtualized
++  // lists.
++  static std::vector<browser_os::ContentItem> ExtractNewPageContent(
++      const ui::AXTreeUpdate& tree_update,
++      bool dedupe_by_node_id,
++      size_t max_items,
++      SeenContent& seen);
++
++  // Same as ExtractNewPageContent(), but for incremental updates of a live
++  // tree: only the subtrees serialized in |updates| are visited, so the cost
++  // follows the amount of changed content rather than the page size.
++  static std::vector<browser_os::ContentItem> ExtractNewContentFromUpdates(
++      const std::vector<ui::AXTreeUpdate>& updates,
++      bool dedupe_by_node_id,
++      size_t max_items,
++      SeenContent& seen);
++
 + private:
-+  // DFS traversal to extract content in document order
++  using NodeMap = std::unordered_map<int32_t, const ui::AXNodeData*>;
++
++  // DFS traversal to extract content in document order. If |source_ids| is
++  // set, the AX node ID of each extracted item is appended to it.
 +  static void TraverseDFS(
 +      int32_t node_id,
-+      const std::unordered_map<int32_t, ui::AXNodeData>& node_map,
-+      std::vector<browser_os::ContentItem>& items);
++      const NodeMap& node_map,
++      std::vector<browser_os::ContentItem>& items,
++      std::vector<int32_t>* source_ids = nullptr);
++
++  // Moves the items of |items| not in |seen| to |new_items|, until it holds
++  // |max_items|, and records them in |seen|
++  static void CollectNewItems(std::vector<browser_os::ContentItem>& items,
++                              const std::vector<int32_t>& source_ids,
++                              bool dedupe_by_node_id,
++                              size_t max_items,
++                              SeenContent& seen,
++                              std::vector<browser_os::ContentItem>& new_items);
++
++  // Key made of the fields that identify an item's content
++  static std::string GetContentKey(const browser_os::ContentItem& item);
 +
 +  // Content extraction helpers
 +  static browser_os::ContentItem ExtractHeading(const ui::AXNodeData& node);
@@ -0,0 +1,63 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_harvest_state.cc b/chrome/browser/extensions/api/browser_os/browser_os_harvest_state.cc
+new file mode 100644
+index 0000000000000..e04e9287fc42c
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_harvest_state.cc
+@@ -0,0 +1,57 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_harvest_state.h"
++
++#include <utility>
++
++#include "base/logging.h"
++#include "content/public/browser/page.h"
++#include "content/public/browser/scoped_accessibility_mode.h"
++#include "content/public/browser/web_contents.h"
++#include "ui/accessibility/ax_updates_and_events.h"
++
++namespace extensions {
++namespace api {
++
++AnalOSHarvestState::AnalOSHarvestState(content::WebContents* web_contents)
++    : content::WebContentsObserver(web_contents),
++      content::WebContentsUserData<AnalOSHarvestState>(*web_contents) {}
++
++AnalOSHarvestState::~AnalOSHarvestState() = default;
++
++void AnalOSHarvestState::StartCollecting(ui::AXMode mode) {
++  updates_.clear();
++  accessibility_mode_ = web_contents()->CreateScopedAccessibilityMode(mode);
++}
++
++std::vector<ui::AXTreeUpdate> AnalOSHarvestState::TakeUpdates() {
++  return std::exchange(updates_, {});
++}
++
++void AnalOSHarvestState::StopCollecting() {
++  accessibility_mode_.reset();
++  updates_.clear();
++}
++
++void AnalOSHarvestState::PrimaryPageChanged(content::Page& page) {
++  // Content of the previous document is not on the new one
++  VLOG(1) << "[analos] HarvestContent: Page changed, clearing seen content";
++  seen_.Clear();
++  updates_.clear();
++}
++
++void AnalOSHarvestState::AccessibilityEventReceived(
++    const ui::AXUpdatesAndEvents& details) {
++  if (!accessibility_mode_) {
++    return;
++  }
++  updates_.insert(updates_.end(), details.updates.begin(),
++                  details.updates.end());
++}
++
++WEB_CONTENTS_USER_DATA_KEY_IMPL(AnalOSHarvestState);
++
++}  // namespace api
++}  // namespace extensions
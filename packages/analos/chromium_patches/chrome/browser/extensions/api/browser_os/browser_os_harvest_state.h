@@ -0,0 +1,85 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_harvest_state.h b/chrome/browser/extensions/api/browser_os/browser_os_harvest_state.h
+new file mode 100644
+index 0000000000000..1bfc8ccdb19c1
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_harvest_state.h
+@@ -0,0 +1,79 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_HARVEST_STATE_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_HARVEST_STATE_H_
++
++#include <memory>
++#include <vector>
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_content_processor.h"
++#include "content/public/browser/web_contents_observer.h"
++#include "content/public/browser/web_contents_user_data.h"
++#include "ui/accessibility/ax_mode.h"
++#include "ui/accessibility/ax_tree_update.h"
++
++namespace content {
++class Page;
++class ScopedAccessibilityMode;
++}  // namespace content
++
++namespace ui {
++struct AXUpdatesAndEvents;
++}  // namespace ui
++
++namespace extensions {
++namespace api {
++
++// harvestContent state of a tab. Records the content already returned, so
++// later calls only return new items, and while a harvest runs collects the
++// live accessibility updates that later rounds extract content from.
++//
++// The state belongs to the tab's WebContents and is dropped with it; the
++// record of returned content is also cleared when the primary page changes.
++class AnalOSHarvestState
++    : public content::WebContentsObserver,
++      public content::WebContentsUserData<AnalOSHarvestState> {
++ public:
++  AnalOSHarvestState(const AnalOSHarvestState&) = delete;
++  AnalOSHarvestState& operator=(const AnalOSHarvestState&) = delete;
++  ~AnalOSHarvestState() override;
++
++  ContentProcessor::SeenContent& seen() { return seen_; }
++
++  // Enables |mode| for the page and starts queueing its accessibility
++  // updates. Queued updates are discarded.
++  void StartCollecting(ui::AXMode mode);
++
++  // Returns and clears the updates queued since the last call
++  std::vector<ui::AXTreeUpdate> TakeUpdates();
++
++  // Stops queueing and releases the accessibility mode
++  void StopCollecting();
++
++  // Whether a harvest is running in this tab
++  bool is_collecting() const { return accessibility_mode_ != nullptr; }
++
++ private:
++  friend class content::WebContentsUserData<AnalOSHarvestState>;
++
++  explicit AnalOSHarvestState(content::WebContents* web_contents);
++
++  // WebContentsObserver overrides
++  void PrimaryPageChanged(content::Page& page) override;
++  void AccessibilityEventReceived(
++      const ui::AXUpdatesAndEvents& details) override;
++
++  ContentProcessor::SeenContent seen_;
++
++  std::unique_ptr<content::ScopedAccessibilityMode> accessibility_mode_;
++  std::vector<ui::AXTreeUpdate> updates_;
++
++  WEB_CONTENTS_USER_DATA_KEY_DECL();
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_HARVEST_STATE_H_
@@ -0,0 +1,113 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_script_registry.cc b/chrome/browser/extensions/api/browser_os/browser_os_script_registry.cc
+new file mode 100644
+index 0000000000000..675d447fb1323
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_script_registry.cc
+@@ -0,0 +1,107 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_script_registry.h"
++
++#include <memory>
++#include <utility>
++
++#include "base/json/json_writer.h"
++#include "base/json/string_escape.h"
++#include "base/strings/string_number_conversions.h"
++#include "content/public/browser/browser_context.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++const char kUserDataKey[] = "analos_script_registry";
++
++// Global holding installed functions, keyed by "name@version". runScript
++// uses the extension's isolated world by default, where page scripts cannot
++// see or replace it.
++const char kScriptsGlobal[] = "globalThis.__analosScripts";
++
++// Property set on the result when the function is not installed
++const char kNotInstalledKey[] = "__analosNotInstalled";
++
++std::string GetQuotedKey(const std::string& name,
++                         const AnalOSScriptRegistry::Script& script) {
++  return base::GetQuotedJSONString(name + "@" +
++                                   base::NumberToString(script.version));
++}
++
++std::string GetArgsJson(const base::Value& args) {
++  return base::WriteJson(args).value_or("null");
++}
++
++}  // namespace
++
++AnalOSScriptRegistry::AnalOSScriptRegistry() = default;
++AnalOSScriptRegistry::~AnalOSScriptRegistry() = default;
++
++// static
++AnalOSScriptRegistry* AnalOSScriptRegistry::Get(
++    content::BrowserContext* context) {
++  auto* registry =
++      static_cast<AnalOSScriptRegistry*>(context->GetUserData(kUserDataKey));
++  if (!registry) {
++    auto new_registry = std::make_unique<AnalOSScriptRegistry>();
++    registry = new_registry.get();
++    context->SetUserData(kUserDataKey, std::move(new_registry));
++  }
++  return registry;
++}
++
++void AnalOSScriptRegistry::Register(const std::string& name,
++                                    std::string code) {
++  Script& script = scripts_[name];
++  script.code = std::move(code);
++  script.version = next_version_++;
++}
++
++const AnalOSScriptRegistry::Script* AnalOSScriptRegistry::Find(
++    const std::string& name) const {
++  auto it = scripts_.find(name);
++  return it == scripts_.end() ? nullptr : &it->second;
++}
++
++// static
++std::string AnalOSScriptRegistry::BuildCallSource(const std::string& name,
++                                                  const Script& script,
++                                                  const base::Value& args) {
++  // (() => { const f = globalThis.__analosScripts?.["name@1"];
++  //          return f ? f(args) : {__analosNotInstalled: true}; })()
++  return std::string("(() => { const f = ") + kScriptsGlobal + "?.[" +
++         GetQuotedKey(name, script) + "]; return f ? f(" + GetArgsJson(args) +
++         ") : {" + kNotInstalledKey + ": true}; })()";
++}
++
++// static
++std::string AnalOSScriptRegistry::BuildInstallSource(const std::string& name,
++                                                     const Script& script,
++                                                     const base::Value& args) {
++  // Registered code is the body of a function taking |args|. Functions of
++  // older versions of the same script are dropped first:
++  // (() => { const s = (globalThis.__analosScripts ??= {});
++  //          for (const k of Object.keys(s))
++  //            if (k.slice(0, k.lastIndexOf("@")) === "name") delete s[k];
++  //          const f = s["name@2"] = function(args) {...}; return f(args); })()
++  return std::string("(() => { const s = (") + kScriptsGlobal +
++         " ??= {}); for (const k of Object.keys(s)) if (k.slice(0, "
++         "k.lastIndexOf(\"@\")) === " +
++         base::GetQuotedJSONString(name) + ") delete s[k]; const f = s[" +
++         GetQuotedKey(name, script) + "] = function(args) {\n" + script.code +
++         "\n}; return f(" + GetArgsJson(args) + "); })()";
++}
++
++// static
++bool AnalOSScriptRegistry::IsNotInstalledResult(const base::Value& result) {
++  return result.is_dict() &&
++         result.GetDict().FindBool(kNotInstalledKey).value_or(false);
++}
++
++}  // namespace api
++}  // namespace extensions
@@ -0,0 +1,79 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_script_registry.h b/chrome/browser/extensions/api/browser_os/browser_os_script_registry.h
+new file mode 100644
+index 0000000000000..9e6c485e888a3
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_script_registry.h
+@@ -0,0 +1,73 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCRIPT_REGISTRY_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCRIPT_REGISTRY_H_
++
++#include <map>
++#include <string>
++
++#include "base/supports_user_data.h"
++#include "base/values.h"
++
++namespace content {
++class BrowserContext;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// Per-profile store of helper scripts registered via analOS.registerScript.
++//
++// A registered script is installed into a frame once, as a function on a
++// global of the world it runs in (an isolated world by default), and later
++// runs only send a short call expression with the arguments. The renderer therefore compiles each script once per document
++// instead of once per call, and the IPC payload no longer carries the source.
++class AnalOSScriptRegistry : public base::SupportsUserData::Data {
++ public:
++  struct Script {
++    std::string code;
++    // Bumped on every registration so frames holding an older version
++    // reinstall the new source instead of calling the stale function
++    int version = 0;
++  };
++
++  AnalOSScriptRegistry();
++  AnalOSScriptRegistry(const AnalOSScriptRegistry&) = delete;
++  AnalOSScriptRegistry& operator=(const AnalOSScriptRegistry&) = delete;
++  ~AnalOSScriptRegistry() override;
++
++  // Returns the registry for |context|, creating it on first use
++  static AnalOSScriptRegistry* Get(content::BrowserContext* context);
++
++  // Adds or replaces the script stored under |name|
++  void Register(const std::string& name, std::string code);
++
++  // Returns nullptr if no script is registered under |name|
++  const Script* Find(const std::string& name) const;
++
++  // Expression that calls the installed function with |args|. Evaluates to
++  // a marker object if the frame does not have this version installed yet.
++  static std::string BuildCallSource(const std::string& name,
++                                     const Script& script,
++                                     const base::Value& args);
++
++  // Expression that installs the function, replacing any older version of
++  // the script in the frame, and then calls it with |args|
++  static std::string BuildInstallSource(const std::string& name,
++                                        const Script& script,
++                                        const base::Value& args);
++
++  // Returns true if |result| is the marker produced by BuildCallSource
++  static bool IsNotInstalledResult(const base::Value& result);
++
++ private:
++  std::map<std::string, Script> scripts_;
++  int next_version_ = 1;
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCRIPT_REGISTRY_H_
@@ -0,0 +1,167 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_scroll_observer.cc b/chrome/browser/extensions/api/browser_os/browser_os_scroll_observer.cc
+new file mode 100644
+index 0000000000000..dc414bb2028c0
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_scroll_observer.cc
+@@ -0,0 +1,161 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_scroll_observer.h"
++
++#include <utility>
++
++#include "base/functional/bind.h"
++#include "base/logging.h"
++#include "content/public/browser/scoped_accessibility_mode.h"
++#include "content/public/browser/web_contents.h"
++#include "ui/accessibility/ax_enums.mojom.h"
++#include "ui/accessibility/ax_mode.h"
++#include "ui/accessibility/ax_node_data.h"
++#include "ui/accessibility/ax_updates_and_events.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Returns true if the node carries scroll offset attributes, i.e. it is a
++// scroller whose update may be caused by the scroll itself
++bool IsScrollOffsetUpdate(const ui::AXNodeData& node) {
++  return node.HasIntAttribute(ax::mojom::IntAttribute::kScrollX) ||
++         node.HasIntAttribute(ax::mojom::IntAttribute::kScrollY);
++}
++
++}  // namespace
++
++// static
++void AnalOSScrollObserver::ExecuteAndWaitForSettle(
++    content::WebContents* web_contents,
++    AsyncAction action,
++    SettleCallback callback,
++    base::TimeDelta quiet_period,
++    base::TimeDelta timeout) {
++  // Owns itself; deleted in Finish()
++  auto* observer =
++      new AnalOSScrollObserver(web_contents, std::move(callback), quiet_period);
++  observer->Start(std::move(action), timeout);
++}
++
++// static
++void AnalOSScrollObserver::ExecuteAndWaitForSettle(
++    content::WebContents* web_contents,
++    base::OnceClosure action,
++    SettleCallback callback,
++    base::TimeDelta quiet_period,
++    base::TimeDelta timeout) {
++  ExecuteAndWaitForSettle(
++      web_contents,
++      base::BindOnce(
++          [](base::OnceClosure action, base::OnceClosure on_dispatched) {
++            std::move(action).Run();
++            std::move(on_dispatched).Run();
++          },
++          std::move(action)),
++      std::move(callback), quiet_period, timeout);
++}
++
++AnalOSScrollObserver::AnalOSScrollObserver(content::WebContents* web_contents,
++                                           SettleCallback callback,
++                                           base::TimeDelta quiet_period)
++    : content::WebContentsObserver(web_contents),
++      callback_(std::move(callback)),
++      quiet_period_(quiet_period) {}
++
++AnalOSScrollObserver::~AnalOSScrollObserver() = default;
++
++void AnalOSScrollObserver::Start(AsyncAction action,
++                                 base::TimeDelta timeout) {
++  start_time_ = base::TimeTicks::Now();
++
++  timeout_timer_.Start(FROM_HERE, timeout,
++                       base::BindOnce(&AnalOSScrollObserver::Finish,
++                                      weak_factory_.GetWeakPtr(), false));
++
++  // Without accessibility no updates arrive and every scroll would look
++  // settled right away
++  const bool had_accessibility =
++      web_contents()->GetAccessibilityMode().has_mode(
++          ui::AXMode::kWebContents);
++  accessibility_mode_ =
++      web_contents()->CreateScopedAccessibilityMode(ui::kAXModeBasic);
++  if (had_accessibility) {
++    RunAction(std::move(action));
++  } else {
++    pending_action_ = std::move(action);
++  }
++}
++
++void AnalOSScrollObserver::RunAction(AsyncAction action) {
++  std::move(action).Run(base::BindOnce(
++      &AnalOSScrollObserver::OnActionDispatched, weak_factory_.GetWeakPtr()));
++}
++
++void AnalOSScrollObserver::OnActionDispatched() {
++  dispatched_ = true;
++  RestartQuietTimer();
++}
++
++void AnalOSScrollObserver::AccessibilityEventReceived(
++    const ui::AXUpdatesAndEvents& details) {
++  if (details.updates.empty() && details.events.empty()) {
++    return;
++  }
++
++  // The initial tree has arrived
++  if (pending_action_) {
++    RunAction(std::move(pending_action_));
++    return;
++  }
++  // Updates from before the scroll was sent are not caused by it
++  if (!dispatched_) {
++    return;
++  }
++
++  for (const auto& update : details.updates) {
++    for (const auto& node : update.nodes) {
++      if (IsScrollOffsetUpdate(node)) {
++        result_.scrolled = true;
++      } else {
++        result_.content_changed = true;
++        result_.updated_nodes++;
++      }
++    }
++  }
++
++  RestartQuietTimer();
++}
++
++void AnalOSScrollObserver::WebContentsDestroyed() {
++  Finish(false);
++}
++
++void AnalOSScrollObserver::RestartQuietTimer() {
++  quiet_timer_.Start(FROM_HERE, quiet_period_,
++                     base::BindOnce(&AnalOSScrollObserver::Finish,
++                                    weak_factory_.GetWeakPtr(), true));
++}
++
++void AnalOSScrollObserver::Finish(bool settled) {
++  quiet_timer_.Stop();
++  timeout_timer_.Stop();
++
++  result_.settled = settled;
++  result_.elapsed = base::TimeTicks::Now() - start_time_;
++
++  VLOG(1) << "[analos] Scroll " << (settled ? "settled" : "timed out")
++          << " after " << result_.elapsed.InMilliseconds() << " ms"
++          << " (scrolled: " << result_.scrolled
++          << ", updated nodes: " << result_.updated_nodes << ")";
++
++  std::move(callback_).Run(result_);
++  delete this;
++}
++
++}  // namespace api
++}  // namespace extensions
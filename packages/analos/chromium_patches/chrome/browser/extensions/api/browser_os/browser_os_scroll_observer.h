@@ -0,0 +1,124 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_scroll_observer.h b/chrome/browser/extensions/api/browser_os/browser_os_scroll_observer.h
+new file mode 100644
+index 0000000000000..e7ab7fa1aa8d0
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_scroll_observer.h
+@@ -0,0 +1,118 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCROLL_OBSERVER_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCROLL_OBSERVER_H_
++
++#include <memory>
++
++#include "base/functional/callback.h"
++#include "base/memory/weak_ptr.h"
++#include "base/time/time.h"
++#include "base/timer/timer.h"
++#include "content/public/browser/web_contents_observer.h"
++
++namespace content {
++class ScopedAccessibilityMode;
++class WebContents;
++}  // namespace content
++
++namespace ui {
++struct AXUpdatesAndEvents;
++}  // namespace ui
++
++namespace extensions {
++namespace api {
++
++// Observes a page after a scroll action and reports once it has settled.
++// Scrolling itself only produces accessibility updates for the scroller's
++// offset (and location changes), so the page is considered settled once no
++// accessibility updates arrived for a quiet period. Updates touching any
++// other node mean content was added or changed, e.g. by lazy loading.
++// Accessibility is kept on while observing; if it was off, the action waits
++// for the initial tree so it is not counted as changed content.
++class AnalOSScrollObserver : public content::WebContentsObserver {
++ public:
++  struct Result {
++    // True if the quiet period was reached before the timeout
++    bool settled = false;
++    // True if a scroll offset change was reported by the AX tree
++    bool scrolled = false;
++    // True if nodes other than scrollers were updated after the action
++    bool content_changed = false;
++    // Number of non-scroller nodes reported in updates
++    int updated_nodes = 0;
++    base::TimeDelta elapsed;
++  };
++
++  using SettleCallback = base::OnceCallback<void(const Result&)>;
++
++  // An action that dispatches the scroll asynchronously and runs
++  // |on_dispatched| once it has been sent to the page
++  using AsyncAction = base::OnceCallback<void(base::OnceClosure on_dispatched)>;
++
++  // Runs |action| and invokes |callback| once the page has settled or
++  // |timeout| expired. The quiet period starts once the action has been
++  // dispatched. The observer owns itself and is deleted after the callback
++  // runs (or when the WebContents goes away).
++  static void ExecuteAndWaitForSettle(
++      content::WebContents* web_contents,
++      AsyncAction action,
++      SettleCallback callback,
++      base::TimeDelta quiet_period = base::Milliseconds(150),
++      base::TimeDelta timeout = base::Seconds(2));
++
++  // Same for an action that dispatches the scroll before returning
++  static void ExecuteAndWaitForSettle(
++      content::WebContents* web_contents,
++      base::OnceClosure action,
++      SettleCallback callback,
++      base::TimeDelta quiet_period = base::Milliseconds(150),
++      base::TimeDelta timeout = base::Seconds(2));
++
++  AnalOSScrollObserver(const AnalOSScrollObserver&) = delete;
++  AnalOSScrollObserver& operator=(const AnalOSScrollObserver&) = delete;
++
++ private:
++  AnalOSScrollObserver(content::WebContents* web_contents,
++                       SettleCallback callback,
++                       base::TimeDelta quiet_period);
++  ~AnalOSScrollObserver() override;
++
++  void Start(AsyncAction action, base::TimeDelta timeout);
++  void RunAction(AsyncAction action);
++  void OnActionDispatched();
++
++  // WebContentsObserver overrides
++  void AccessibilityEventReceived(
++      const ui::AXUpdatesAndEvents& details) override;
++  void WebContentsDestroyed() override;
++
++  // Restarts the quiet period after any activity
++  void RestartQuietTimer();
++
++  // Reports the result and deletes this observer
++  void Finish(bool settled);
++
++  SettleCallback callback_;
++  base::TimeDelta quiet_period_;
++  base::TimeTicks start_time_;
++  Result result_;
++
++  std::unique_ptr<content::ScopedAccessibilityMode> accessibility_mode_;
++
++  // Set while the action waits for the initial accessibility tree
++  AsyncAction pending_action_;
++  bool dispatched_ = false;
++
++  base::OneShotTimer quiet_timer_;
++  base::OneShotTimer timeout_timer_;
++
++  base::WeakPtrFactory<AnalOSScrollObserver> weak_factory_{this};
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCROLL_OBSERVER_H_
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.cc b/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.cc
 new file mode 100644
-index 0000000000000..885942336dcd6
+index 0000000000000..221b00e68b468
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.cc
-@@ -0,0 +1,648 @@
+@@ -0,0 +1,913 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -14,6 +14,7 @@ index 0000000000000..885942336dcd6
 +#include <atomic>
 +#include <cctype>
 +#include <functional>
++#include <iterator>
 +#include <future>
 +#include <memory>
 +#include <queue>
@@ -21,13 +22,19 @@ index 0000000000000..885942336dcd6
 +#include <unordered_set>
 +#include <utility>
 +
++#include "base/containers/span.h"
 +#include "base/functional/bind.h"
 +#include "base/logging.h"
 +#include "base/memory/raw_ptr.h"
 +#include "base/memory/ref_counted.h"
++#include "base/metrics/histogram_macros_local.h"
++#include "base/no_destructor.h"
 +#include "base/strings/string_util.h"
++#include "base/system/sys_info.h"
++#include "base/task/sequenced_task_runner.h"
 +#include "base/task/thread_pool.h"
 +#include "base/time/time.h"
++#include "base/trace_event/trace_event.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +#include "content/public/browser/browser_thread.h"
 +#include "content/public/browser/render_widget_host_view.h"
@@ -136,6 +143,13 @@ index 0000000000000..885942336dcd6
 +  return false;
 +}
 +
++// Output of one batch, written only by the worker that processed it
++struct BatchOutput {
++  std::vector<browser_os::InteractiveNode> elements;
++  // Node mappings, recorded on the UI thread which owns the mapping table
++  std::vector<std::pair<uint32_t, NodeInfo>> mappings;
++};
++
 +}  // namespace
 +
 +// Internal structure for managing async processing
@@ -151,16 +165,89 @@ index 0000000000000..885942336dcd6
 +  float device_scale_factor = 1.0f;  // For converting physical to CSS pixels
 +  gfx::Size viewport_size;  // For visibility checks
 +  base::TimeTicks start_time;
++  base::TimeTicks batch_start_time;
++  SnapshotPhaseTimings timings;
++  // Node ID generation of this snapshot
++  uint32_t generation = 0;
++  // Whether the tree stopped at a snapshot limit; nodes it lacks may still
++  // exist, so their IDs are not pruned
++  bool truncated = false;
++  // Interactive nodes to process and their stable IDs, indexed alike.
++  // Batches read consecutive ranges of both.
++  std::vector<ui::AXNodeData> nodes;
++  std::vector<uint32_t> node_ids;
++  // One slot per batch, sized before any batch is posted so workers can
++  // write without locking; concatenated in batch order once all are done
++  std::vector<BatchOutput> batch_outputs;
 +  size_t total_nodes;
 +  size_t processed_batches;
 +  size_t total_batches;
-+  base::OnceCallback<void(SnapshotProcessingResult)> callback;
++  // Callers waiting for this snapshot, including those of snapshots of the
++  // same tab that this one superseded
++  std::vector<base::OnceCallback<void(SnapshotProcessingResult)>> callbacks;
++  // Set when a newer snapshot of the tab takes over; checked by batch tasks
++  // before they start so superseded work is dropped
++  std::atomic<bool> cancelled{false};
 +  
 + private:
 +  friend class base::RefCountedThreadSafe<ProcessingContext>;
 +  ~ProcessingContext() = default;
 +};
 +
++namespace {
++
++// Snapshot currently being processed for each tab
++std::unordered_map<int, scoped_refptr<SnapshotProcessor::ProcessingContext>>&
++GetInFlightSnapshots() {
++  static base::NoDestructor<std::unordered_map<
++      int, scoped_refptr<SnapshotProcessor::ProcessingContext>>>
++      g_in_flight;
++  return *g_in_flight;
++}
++
++// Batch processing shares a small, fixed set of sequences so that snapshots
++// of many tabs never occupy more than a few cores between them and do not
++// starve page rendering
++constexpr size_t kMaxSnapshotSequences = 4;
++
++const std::vector<scoped_refptr<base::SequencedTaskRunner>>&
++GetSnapshotTaskRunners() {
++  static base::NoDestructor<
++      std::vector<scoped_refptr<base::SequencedTaskRunner>>>
++      g_runners([] {
++        size_t count = std::clamp<size_t>(
++            base::SysInfo::NumberOfProcessors() / 2, 1, kMaxSnapshotSequences);
++        std::vector<scoped_refptr<base::SequencedTaskRunner>> runners;
++        for (size_t i = 0; i < count; ++i) {
++          runners.push_back(base::ThreadPool::CreateSequencedTaskRunner(
++              {base::TaskPriority::USER_VISIBLE,
++               base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN}));
++        }
++        return runners;
++      }());
++  return *g_runners;
++}
++
++base::SequencedTaskRunner* GetSnapshotTaskRunner(size_t batch_index) {
++  const auto& runners = GetSnapshotTaskRunners();
++  return runners[batch_index % runners.size()].get();
++}
++
++// Batch size bounds. Small pages run as a single batch to avoid task
++// overhead; large pages are split so each sequence gets a few batches to
++// balance uneven per-node cost, without flooding the pool.
++constexpr size_t kMinBatchSize = 64;
++constexpr size_t kMaxBatchSize = 1000;
++constexpr size_t kBatchesPerSequence = 4;
++
++size_t ComputeBatchSize(size_t node_count) {
++  size_t target_batches = GetSnapshotTaskRunners().size() * kBatchesPerSequence;
++  size_t batch_size = (node_count + target_batches - 1) / target_batches;
++  return std::clamp(batch_size, kMinBatchSize, kMaxBatchSize);
++}
++
++}  // namespace
++
 +// Helper to collect text from a node's subtree
 +std::string CollectTextFromNode(
 +    int32_t node_id,
@@ -325,17 +412,18 @@ index 0000000000000..885942336dcd6
 +
 +// Process a batch of nodes
 +std::vector<SnapshotProcessor::ProcessedNode> SnapshotProcessor::ProcessNodeBatch(
-+    const std::vector<ui::AXNodeData>& nodes_to_process,
++    base::span<const ui::AXNodeData> nodes_to_process,
 +    const std::unordered_map<int32_t, ui::AXNodeData>& node_map,
 +    ui::AXTree* ax_tree,
-+    uint32_t start_node_id,
++    base::span<const uint32_t> node_ids,
 +    float device_scale_factor) {
++  TRACE_EVENT("browser", "AnalOS.Snapshot.ProcessBatch", "nodes",
++              nodes_to_process.size());
 +  std::vector<ProcessedNode> results;
 +  results.reserve(nodes_to_process.size());
 +  
-+  uint32_t current_node_id = start_node_id;
-+  
-+  for (const auto& node_data : nodes_to_process) {
++  for (size_t i = 0; i < nodes_to_process.size(); ++i) {
++    const ui::AXNodeData& node_data = nodes_to_process[i];
 +    // Skip invisible, ignored, or non-interactive elements
 +    if (ShouldSkipNode(node_data)) {
 +      continue;
@@ -351,7 +439,7 @@ index 0000000000000..885942336dcd6
 +    
 +    ProcessedNode data;
 +    data.node_data = &node_data;
-+    data.node_id = current_node_id++;
++    data.node_id = node_ids[i];
 +    data.node_type = node_type;
 +    
 +    // Get accessible name
@@ -420,24 +508,42 @@ index 0000000000000..885942336dcd6
 +  return results;
 +}
 +
-+// Helper to handle batch processing results
-+void SnapshotProcessor::OnBatchProcessed(
++// static
++void SnapshotProcessor::ProcessBatchIntoSlot(
 +    scoped_refptr<ProcessingContext> context,
-+    std::vector<ProcessedNode> batch_results) {
-+  // Process batch results
-+  for (const auto& node_data : batch_results) {
-+    // Store mapping from our nodeId to AX node ID, bounds, and attributes
++    size_t batch_index,
++    size_t begin,
++    size_t end) {
++  if (context->cancelled) {
++    return;
++  }
++
++  std::vector<ProcessedNode> batch_results = ProcessNodeBatch(
++      base::span(context->nodes).subspan(begin, end - begin),
++      context->node_map, context->ax_tree.get(),
++      base::span(context->node_ids).subspan(begin, end - begin),
++      context->device_scale_factor);
++
++  TRACE_EVENT("browser", "AnalOS.Snapshot.SerializeBatch", "nodes",
++              batch_results.size());
++  BatchOutput& output = context->batch_outputs[batch_index];
++  output.elements.reserve(batch_results.size());
++  output.mappings.reserve(batch_results.size());
++
++  for (auto& node_data : batch_results) {
++    // Mapping from our nodeId to AX node ID, bounds, and attributes
 +    NodeInfo info;
 +    info.ax_node_id = node_data.node_data->id;
 +    info.ax_tree_id = context->tree_id;  // Store tree ID for change detection
++    info.dom_node_id = node_data.node_data->GetIntAttribute(
++        ax::mojom::IntAttribute::kDOMNodeId);
 +    info.bounds = node_data.absolute_bounds;
-+    info.attributes = node_data.attributes;  // Store all computed attributes
 +    info.node_type = node_data.node_type;  // Store node type for efficient filtering
 +    // Extract in_viewport from attributes (stored as "true"/"false" string)
 +    auto viewport_it = node_data.attributes.find("in_viewport");
 +    info.in_viewport = (viewport_it != node_data.attributes.end() && viewport_it->second == "true");
-+    GetNodeIdMappings()[context->tab_id][node_data.node_id] = info;
-+    
++    info.generation = context->generation;
++
 +    // Log the mapping for debugging
 +    VLOG(2) << "Node ID Mapping: Interactive nodeId=" << node_data.node_id 
 +            << " -> AX node ID=" << info.ax_node_id 
@@ -447,7 +553,7 @@ index 0000000000000..885942336dcd6
 +    browser_os::InteractiveNode interactive_node;
 +    interactive_node.node_id = node_data.node_id;
 +    interactive_node.type = node_data.node_type;
-+    interactive_node.name = node_data.name;
++    interactive_node.name = std::move(node_data.name);
 +    
 +    // Set the bounding rectangle
 +    browser_os::Rect rect;
@@ -468,40 +574,139 @@ index 0000000000000..885942336dcd6
 +      
 +      interactive_node.attributes = std::move(attributes);
 +    }
++    info.attributes = std::move(node_data.attributes);  // Store all computed attributes
 +    
-+    context->snapshot.elements.push_back(std::move(interactive_node));
++    output.mappings.emplace_back(node_data.node_id, std::move(info));
++    output.elements.push_back(std::move(interactive_node));
++  }
++}
++
++// static
++void SnapshotProcessor::AssembleElements(
++    scoped_refptr<ProcessingContext> context) {
++  TRACE_EVENT("browser", "AnalOS.Snapshot.Assemble", "batches",
++              context->batch_outputs.size());
++  // Stable IDs no longer follow document order, so keep elements in batch
++  // order rather than sorting by ID
++  size_t total = 0;
++  for (const auto& output : context->batch_outputs) {
++    total += output.elements.size();
 +  }
++  auto& elements = context->snapshot.elements;
++  elements.reserve(total);
++  for (auto& output : context->batch_outputs) {
++    std::move(output.elements.begin(), output.elements.end(),
++              std::back_inserter(elements));
++  }
++  context->batch_outputs.clear();
++  context->nodes.clear();
++}
++
++// Helper to handle batch processing results
++void SnapshotProcessor::OnBatchProcessed(
++    scoped_refptr<ProcessingContext> context,
++    size_t batch_index) {
++  // Superseded; the newer snapshot answers this one's callers
++  if (context->cancelled) {
++    return;
++  }
++
++  base::TimeTicks serialize_start = base::TimeTicks::Now();
++
++  // A newer snapshot of this tab already owns the mapping table; IDs in this
++  // result are still valid as long as the newer snapshot saw the same nodes.
++  // If the tab was closed meanwhile its state is gone and must stay gone.
++  const auto& states = GetTabNodeIdStates();
++  auto state_it = states.find(context->tab_id);
++  const bool is_latest = state_it != states.end() &&
++                         context->generation == state_it->second.generation;
++  if (is_latest) {
++    auto& mappings = GetNodeIdMappings()[context->tab_id];
++    for (auto& [node_id, info] :
++         context->batch_outputs[batch_index].mappings) {
++      mappings[node_id] = std::move(info);
++    }
++  }
++  context->batch_outputs[batch_index].mappings.clear();
 +  
 +  context->processed_batches++;
++  context->timings.serialize += base::TimeTicks::Now() - serialize_start;
 +  
 +  // Check if all batches are complete
-+  if (context->processed_batches == context->total_batches) {
-+    // Sort elements by node_id to maintain consistent ordering
-+    std::sort(context->snapshot.elements.begin(), 
-+              context->snapshot.elements.end(),
-+              [](const browser_os::InteractiveNode& a, 
-+                 const browser_os::InteractiveNode& b) {
-+                return a.node_id < b.node_id;
-+              });
-+
-+    // Leave hierarchical_structure empty for now as requested
-+    context->snapshot.hierarchical_structure = "";
-+
-+    base::TimeDelta processing_time = base::TimeTicks::Now() - context->start_time;
-+    LOG(INFO) << "[PERF] Interactive snapshot processed in " 
-+              << processing_time.InMilliseconds() << " ms"
-+              << " (nodes: " << context->snapshot.elements.size() << ")";
-+
-+    // Set processing time in the snapshot
-+    context->snapshot.processing_time_ms = processing_time.InMilliseconds();
++  if (context->processed_batches < context->total_batches) {
++    return;
++  }
 +
-+    SnapshotProcessingResult result;
-+    result.snapshot = std::move(context->snapshot);
-+    result.nodes_processed = context->total_nodes;
-+    result.processing_time_ms = processing_time.InMilliseconds();
-+    
-+    // Run callback (context will be deleted when last ref is released)
-+    std::move(context->callback).Run(std::move(result));
++  context->timings.batch = base::TimeTicks::Now() - context->batch_start_time;
++
++  // Forget IDs of nodes this snapshot no longer contains
++  if (is_latest && !context->truncated) {
++    PruneNodeIdMappings(context->tab_id, context->generation);
++  }
++
++  // Moving every element into the result is linear in the page size, so do
++  // it on the pool rather than on the UI thread
++  base::ThreadPool::PostTaskAndReply(
++      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
++      base::BindOnce(&SnapshotProcessor::AssembleElements, context),
++      base::BindOnce(&SnapshotProcessor::OnElementsAssembled, context));
++}
++
++// static
++void SnapshotProcessor::OnElementsAssembled(
++    scoped_refptr<ProcessingContext> context) {
++  if (context->cancelled) {
++    return;
++  }
++
++  // Leave hierarchical_structure empty for now as requested
++  context->snapshot.hierarchical_structure = "";
++
++  base::TimeDelta processing_time = base::TimeTicks::Now() - context->start_time;
++  LOG(INFO) << "[PERF] Interactive snapshot processed in " 
++            << processing_time.InMilliseconds() << " ms"
++            << " (nodes: " << context->snapshot.elements.size() << ")";
++  LOCAL_HISTOGRAM_TIMES("AnalOS.Snapshot.BatchTime", context->timings.batch);
++  LOCAL_HISTOGRAM_TIMES("AnalOS.Snapshot.SerializeTime",
++                        context->timings.serialize);
++  LOCAL_HISTOGRAM_TIMES("AnalOS.Snapshot.ProcessingTime", processing_time);
++  LOCAL_HISTOGRAM_COUNTS_100000("AnalOS.Snapshot.InteractiveNodeCount",
++                                context->snapshot.elements.size());
++
++  // Set processing time in the snapshot
++  context->snapshot.processing_time_ms = processing_time.InMilliseconds();
++
++  SnapshotProcessingResult result;
++  result.snapshot = std::move(context->snapshot);
++  result.nodes_processed = context->total_nodes;
++  result.processing_time_ms = processing_time.InMilliseconds();
++  result.timings = context->timings;
++  
++  // Run callbacks (context will be deleted when last ref is released)
++  Complete(std::move(context), std::move(result));
++}
++
++// static
++void SnapshotProcessor::Complete(scoped_refptr<ProcessingContext> context,
++                                 SnapshotProcessingResult result) {
++  auto& in_flight = GetInFlightSnapshots();
++  auto it = in_flight.find(context->tab_id);
++  if (it != in_flight.end() && it->second == context) {
++    in_flight.erase(it);
++  }
++
++  // Coalesced callers share the same snapshot
++  auto callbacks = std::move(context->callbacks);
++  for (size_t i = 0; i + 1 < callbacks.size(); ++i) {
++    SnapshotProcessingResult copy;
++    copy.snapshot = result.snapshot.Clone();
++    copy.nodes_processed = result.nodes_processed;
++    copy.processing_time_ms = result.processing_time_ms;
++    copy.timings = result.timings;
++    std::move(callbacks[i]).Run(std::move(copy));
++  }
++  if (!callbacks.empty()) {
++    std::move(callbacks.back()).Run(std::move(result));
 +  }
 +}
 +
@@ -532,9 +737,10 @@ index 0000000000000..885942336dcd6
 +}
 +
 +void SnapshotProcessor::ProcessAccessibilityTree(
-+    const ui::AXTreeUpdate& tree_update,
++    ui::AXTreeUpdate tree_update,
 +    int tab_id,
 +    uint32_t snapshot_id,
++    bool truncated,
 +    content::WebContents* web_contents,
 +    base::OnceCallback<void(SnapshotProcessingResult)> callback) {
 +  base::TimeTicks start_time = base::TimeTicks::Now();
@@ -542,113 +748,172 @@ index 0000000000000..885942336dcd6
 +  // Extract viewport info from WebContents on UI thread
 +  auto [viewport_size, device_scale_factor] = ExtractViewportInfo(web_contents);
 +  
-+  // Build node ID map, parent map and children map for efficient lookup
-+  std::unordered_map<int32_t, ui::AXNodeData> node_map;
-+  std::unordered_map<int32_t, int32_t> parent_map;
-+  std::unordered_map<int32_t, std::vector<int32_t>> children_map;
++  // Prepare processing context using RefCounted
++  auto context = base::MakeRefCounted<ProcessingContext>();
++  context->snapshot.snapshot_id = snapshot_id;
++  context->snapshot.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
++  context->tab_id = tab_id;
++  context->truncated = truncated;
++  context->device_scale_factor = device_scale_factor;  // For CSS pixel conversion
++  context->viewport_size = viewport_size;  // For visibility checks
++  context->start_time = start_time;
 +  
++  // Previous mappings stay valid while this snapshot is processed; entries
++  // for nodes that disappeared are pruned once it completes, and all of them
++  // once the tab is closed
++  if (web_contents) {
++    ClearNodeIdMappingsOnDestruction(web_contents, tab_id);
++  }
++  context->generation = ++GetTabNodeIdStates()[tab_id].generation;
++  
++  // Viewport size is passed in but not currently used for viewport bounds calculation
++  // TODO: Implement proper viewport detection if needed
++  context->processed_batches = 0;
++
++  // Supersede any snapshot of this tab that is still being processed: its
++  // remaining work is skipped and its callers get this result instead
++  auto& in_flight = GetInFlightSnapshots()[tab_id];
++  if (in_flight) {
++    VLOG(1) << "[analos] Superseding in-flight snapshot for tab " << tab_id;
++    in_flight->cancelled = true;
++    context->callbacks = std::move(in_flight->callbacks);
++  }
++  context->callbacks.push_back(std::move(callback));
++  in_flight = context;
++  
++  // Building the lookup maps and the AXTree is linear in the page size, so
++  // it runs on the pool; the update is moved there rather than copied
++  base::ThreadPool::PostTaskAndReply(
++      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
++      base::BindOnce(&SnapshotProcessor::BuildTree, context,
++                     std::move(tree_update)),
++      base::BindOnce(&SnapshotProcessor::OnTreeBuilt, context));
++}
++
++// static
++void SnapshotProcessor::BuildTree(scoped_refptr<ProcessingContext> context,
++                                  ui::AXTreeUpdate tree_update) {
++  if (context->cancelled) {
++    return;
++  }
++
++  TRACE_EVENT("browser", "AnalOS.Snapshot.BuildTree", "nodes",
++              tree_update.nodes.size());
++  base::TimeTicks build_start = base::TimeTicks::Now();
++
++  // Build node ID map, parent map and children map for efficient lookup
 +  for (const auto& node : tree_update.nodes) {
-+    node_map[node.id] = node;
++    context->node_map[node.id] = node;
 +    // Build parent and children relationships
 +    for (int32_t child_id : node.child_ids) {
-+      parent_map[child_id] = node.id;
-+      children_map[node.id].push_back(child_id);
++      context->parent_map[child_id] = node.id;
++      context->children_map[node.id].push_back(child_id);
 +    }
 +  }
 +  
-+  // Clear previous mappings for this tab
-+  GetNodeIdMappings()[tab_id].clear();
-+
 +  // Create an AXTree from the tree update for accurate bounds computation
-+  std::unique_ptr<ui::AXTree> ax_tree = std::make_unique<ui::AXTree>(tree_update);
-+  
-+  if (!ax_tree) {
-+    LOG(ERROR) << "[analos] Failed to create AXTree from update";
-+    SnapshotProcessingResult result;
-+    result.nodes_processed = 0;
-+    result.processing_time_ms = 0;
-+    std::move(callback).Run(std::move(result));
-+    return;
-+  }
++  context->ax_tree = std::make_unique<ui::AXTree>(tree_update);
 +  
 +  LOG(INFO) << "[analos] Created AXTree with " << tree_update.nodes.size() 
 +            << " nodes for bounds computation";
 +  
-+  // Prepare processing context using RefCounted
-+  auto context = base::MakeRefCounted<ProcessingContext>();
-+  context->snapshot.snapshot_id = snapshot_id;
-+  context->snapshot.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
-+  context->tab_id = tab_id;
-+  context->node_map = std::move(node_map);
-+  context->parent_map = std::move(parent_map); 
-+  context->children_map = std::move(children_map);
-+  context->ax_tree = std::move(ax_tree);  // Store AXTree for bounds computation
-+  context->device_scale_factor = device_scale_factor;  // For CSS pixel conversion
-+  context->viewport_size = viewport_size;  // For visibility checks
-+  context->start_time = start_time;
-+  
 +  // Store the tree ID for change detection
 +  if (tree_update.has_tree_data) {
 +    context->tree_id = tree_update.tree_data.tree_id;
 +  }
 +  
-+  // Viewport size is passed in but not currently used for viewport bounds calculation
-+  // TODO: Implement proper viewport detection if needed
-+  context->callback = std::move(callback);
-+  context->processed_batches = 0;
-+  
-+  // Collect all nodes to process and filter
-+  std::vector<ui::AXNodeData> nodes_to_process;
-+  for (const auto& node : tree_update.nodes) {
++  // Collect all nodes to process and filter; the update is not needed
++  // afterwards, so the kept nodes are moved out of it
++  for (auto& node : tree_update.nodes) {
 +    // Skip invisible, ignored, or non-interactive nodes
 +    if (ShouldSkipNode(node)) {
 +      continue;
 +    }
-+    nodes_to_process.push_back(node);
++    context->nodes.push_back(std::move(node));
 +  }
 +  
-+  context->total_nodes = nodes_to_process.size();
++  context->total_nodes = context->nodes.size();
++  context->timings.tree_node_count = tree_update.nodes.size();
++  context->timings.tree_build = base::TimeTicks::Now() - build_start;
++}
++
++// static
++void SnapshotProcessor::OnTreeBuilt(scoped_refptr<ProcessingContext> context) {
++  if (context->cancelled) {
++    return;
++  }
++
++  const int tab_id = context->tab_id;
++  LOCAL_HISTOGRAM_TIMES("AnalOS.Snapshot.TreeBuildTime",
++                        context->timings.tree_build);
++  LOCAL_HISTOGRAM_COUNTS_100000("AnalOS.Snapshot.TreeNodeCount",
++                                context->timings.tree_node_count);
 +  
 +  // Handle empty case
-+  if (nodes_to_process.empty()) {
-+    base::TimeDelta processing_time = base::TimeTicks::Now() - start_time;
++  if (context->nodes.empty()) {
++    if (!context->truncated) {
++      PruneNodeIdMappings(tab_id, context->generation);
++    }
++    base::TimeDelta processing_time =
++        base::TimeTicks::Now() - context->start_time;
 +    context->snapshot.processing_time_ms = processing_time.InMilliseconds();
 +    
 +    SnapshotProcessingResult result;
 +    result.snapshot = std::move(context->snapshot);
 +    result.nodes_processed = 0;
 +    result.processing_time_ms = processing_time.InMilliseconds();
-+    std::move(context->callback).Run(std::move(result));
++    result.timings = context->timings;
++    Complete(std::move(context), std::move(result));
 +    return;
 +  }
 +  
-+  // Process nodes in batches using ThreadPool
-+  const size_t batch_size = 100;  // Process 100 nodes per batch
-+  size_t num_batches = (nodes_to_process.size() + batch_size - 1) / batch_size;
++  // The tab was closed while the tree was built, which erased its ID
++  // state, or a newer snapshot owns it. Assigning IDs would bring the state
++  // back for good, so the snapshot is dropped.
++  auto& states = GetTabNodeIdStates();
++  auto state_it = states.find(tab_id);
++  if (state_it == states.end() ||
++      state_it->second.generation != context->generation) {
++    VLOG(1) << "[analos] Dropping snapshot of tab " << tab_id
++            << ": node ID state is gone or newer";
++    SnapshotProcessingResult result;
++    result.snapshot = std::move(context->snapshot);
++    result.processing_time_ms =
++        (base::TimeTicks::Now() - context->start_time).InMilliseconds();
++    result.timings = context->timings;
++    Complete(std::move(context), std::move(result));
++    return;
++  }
++
++  // Stable IDs are looked up on the UI thread, which owns the ID table
++  TabNodeIdState& state = state_it->second;
++  context->node_ids.reserve(context->nodes.size());
++  for (const auto& node : context->nodes) {
++    context->node_ids.push_back(
++        GetOrAssignStableNodeId(state, context->tree_id, node.id));
++  }
++
++  // Process nodes in batches on the snapshot sequences
++  const size_t total = context->nodes.size();
++  const size_t batch_size = ComputeBatchSize(total);
++  size_t num_batches = (total + batch_size - 1) / batch_size;
 +  context->total_batches = num_batches;
-+  
-+  for (size_t i = 0; i < nodes_to_process.size(); i += batch_size) {
-+    size_t end = std::min(i + batch_size, nodes_to_process.size());
-+    std::vector<ui::AXNodeData> batch(
-+        std::make_move_iterator(nodes_to_process.begin() + i),
-+        std::make_move_iterator(nodes_to_process.begin() + end));
-+    uint32_t start_node_id = i + 1;  // Node IDs start at 1
-+    
-+    // Post task to ThreadPool and handle result on UI thread
-+    base::ThreadPool::PostTaskAndReplyWithResult(
++  context->timings.batch_count = num_batches;
++  context->batch_outputs.resize(num_batches);
++  context->batch_start_time = base::TimeTicks::Now();
++  
++  for (size_t batch = 0; batch < num_batches; ++batch) {
++    size_t begin = batch * batch_size;
++    size_t end = std::min(begin + batch_size, total);
++    // Workers read the shared context and write only their own slot; the
++    // reply records node mappings on the UI thread
++    GetSnapshotTaskRunner(batch)->PostTaskAndReply(
 +        FROM_HERE,
-+        {base::TaskPriority::USER_VISIBLE},
-+        base::BindOnce(&SnapshotProcessor::ProcessNodeBatch, 
-+                       std::move(batch), 
-+                       context->node_map,
-+                       context->ax_tree.get(),  // Pass AXTree pointer for bounds computation
-+                       start_node_id,
-+                       context->device_scale_factor),  // Pass DSF for CSS pixel conversion
-+        base::BindOnce(&SnapshotProcessor::OnBatchProcessed,
-+                       context));
++        base::BindOnce(&SnapshotProcessor::ProcessBatchIntoSlot, context,
++                       batch, begin, end),
++        base::BindOnce(&SnapshotProcessor::OnBatchProcessed, context, batch));
 +  }
 +}
 +
-+
 +}  // namespace api
 +}  // namespace extensions
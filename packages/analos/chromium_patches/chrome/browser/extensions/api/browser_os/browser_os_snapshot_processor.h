@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h b/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h
 new file mode 100644
-index 0000000000000..5c85cd73b26f3
+index 0000000000000..708186a7535a8
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h
-@@ -0,0 +1,111 @@
+@@ -0,0 +1,165 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -16,8 +16,11 @@ index 0000000000000..5c85cd73b26f3
 +#include <unordered_map>
 +#include <vector>
 +
++#include "base/containers/span.h"
 +#include "base/functional/callback.h"
 +#include "base/memory/raw_ptr.h"
++#include "base/memory/ref_counted.h"
++#include "base/time/time.h"
 +#include "chrome/common/extensions/api/browser_os.h"
 +#include "ui/gfx/geometry/rect_f.h"
 +
@@ -37,11 +40,25 @@ index 0000000000000..5c85cd73b26f3
 +namespace extensions {
 +namespace api {
 +
++// Time spent in each processing phase, for tracing and the optional timing
++// breakdown in the snapshot result
++struct SnapshotPhaseTimings {
++  // Building lookup maps and the AXTree on the thread pool
++  base::TimeDelta tree_build;
++  // From posting the first batch until the last batch returned
++  base::TimeDelta batch;
++  // Recording node mappings from finished batches on the UI thread
++  base::TimeDelta serialize;
++  size_t tree_node_count = 0;
++  size_t batch_count = 0;
++};
++
 +// Result of snapshot processing
 +struct SnapshotProcessingResult {
 +  browser_os::InteractiveSnapshot snapshot;
 +  int nodes_processed = 0;
 +  int64_t processing_time_ms = 0;
++  SnapshotPhaseTimings timings;
 +};
 +
 +// Processes accessibility trees into interactive snapshots with parallel processing
@@ -65,34 +82,44 @@ index 0000000000000..5c85cd73b26f3
 +    std::unordered_map<std::string, std::string> attributes;
 +  };
 +
++  // Internal processing context
++  struct ProcessingContext;
++
 +  SnapshotProcessor() = default;
 +  ~SnapshotProcessor() = default;
 +
 +  // Main processing function - handles all threading internally
++  // A newer call for the same |tab_id| supersedes one still in progress: the
++  // older call's remaining work is dropped and its callback receives the
++  // newer snapshot.
 +  // This function processes the accessibility tree into an interactive snapshot
 +  // using parallel processing on the thread pool. Extracts viewport info from
-+  // web_contents on UI thread before processing.
++  // web_contents on UI thread before processing; everything else apart from
++  // node ID bookkeeping runs on the pool.
++  // A |truncated| tree misses part of the page, so node IDs of nodes it does
++  // not contain are kept instead of pruned.
 +  static void ProcessAccessibilityTree(
-+      const ui::AXTreeUpdate& tree_update,
++      ui::AXTreeUpdate tree_update,
 +      int tab_id,
 +      uint32_t snapshot_id,
++      bool truncated,
 +      content::WebContents* web_contents,
 +      base::OnceCallback<void(SnapshotProcessingResult)> callback);
 +
 +  // Process a batch of nodes (exposed for testing)
 +  // The ax_tree is used to compute accurate bounds for each node
 +  // device_scale_factor is used to convert physical pixels to CSS pixels
++  // |node_ids| holds the stable interactive node ID of each entry in
++  // |nodes_to_process|.
 +  static std::vector<ProcessedNode> ProcessNodeBatch(
-+      const std::vector<ui::AXNodeData>& nodes_to_process,
++      base::span<const ui::AXNodeData> nodes_to_process,
 +      const std::unordered_map<int32_t, ui::AXNodeData>& node_map,
 +      ui::AXTree* ax_tree,
-+      uint32_t start_node_id,
++      base::span<const uint32_t> node_ids,
 +      float device_scale_factor = 1.0f);
 +
 + private:
-+  // Internal processing context
-+  struct ProcessingContext;
-+  
++
 +  // Compute absolute bounds for a node using AXTree and convert to CSS pixels
 +  // This implements the same logic as BrowserAccessibility::GetBoundsRect
 +  // Returns bounds in CSS pixels by applying device_scale_factor
@@ -103,9 +130,36 @@ index 0000000000000..5c85cd73b26f3
 +                                   float device_scale_factor = 1.0f,
 +                                   bool* out_offscreen = nullptr);
 +  
-+  // Batch processing callback
++  // Builds the lookup maps, the AXTree and the filtered node list of
++  // |context| from |tree_update|. Runs on the thread pool.
++  static void BuildTree(scoped_refptr<ProcessingContext> context,
++                        ui::AXTreeUpdate tree_update);
++
++  // Assigns stable node IDs and posts the batches once the tree is built
++  static void OnTreeBuilt(scoped_refptr<ProcessingContext> context);
++
++  // Runs ProcessNodeBatch over nodes [begin, end) of |context| and stores
++  // the converted elements and node mappings in slot |batch_index|. Skipped
++  // if the snapshot was superseded before the batch started.
++  static void ProcessBatchIntoSlot(scoped_refptr<ProcessingContext> context,
++                                   size_t batch_index,
++                                   size_t begin,
++                                   size_t end);
++
++  // Concatenates the batch slots into the snapshot, off the UI thread
++  static void AssembleElements(scoped_refptr<ProcessingContext> context);
++
++  // Finishes the snapshot once elements are assembled
++  static void OnElementsAssembled(scoped_refptr<ProcessingContext> context);
++
++  // Runs all callbacks waiting for |context| with |result|
++  static void Complete(scoped_refptr<ProcessingContext> context,
++                       SnapshotProcessingResult result);
++
++  // Batch processing callback. Batches cover consecutive ranges of the tree
++  // in document order; |batch_index| identifies the range.
 +  static void OnBatchProcessed(scoped_refptr<ProcessingContext> context,
-+                               std::vector<ProcessedNode> batch_results);
++                               size_t batch_index);
 +
 +  SnapshotProcessor(const SnapshotProcessor&) = delete;
 +  SnapshotProcessor& operator=(const SnapshotProcessor&) = delete;
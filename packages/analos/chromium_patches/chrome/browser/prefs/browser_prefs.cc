@@ -43,7 +43,7 @@ index 12845dd2464bb..58c652de0d234 100644
    RegisterPrefersDefaultScrollbarStylesPrefs(registry);
    RegisterSafetyHubProfilePrefs(registry);
  #if BUILDFLAG(IS_CHROMEOS)
-@@ -2508,6 +2514,20 @@ void RegisterGeminiSettingsPrefs(user_prefs::PrefRegistrySyncable* registry) {
+@@ -2508,6 +2514,23 @@ void RegisterGeminiSettingsPrefs(user_prefs::PrefRegistrySyncable* registry) {
    registry->RegisterIntegerPref(prefs::kGeminiSettings, 0);
  }
  
@@ -59,6 +59,9 @@ index 12845dd2464bb..58c652de0d234 100644
 +  
 +  // Custom providers list - stored as a JSON string
 +  registry->RegisterStringPref(prefs::kAnalOSCustomProviders, "[]");
++
++  // Last fetched extensions config, for conditional fetches
++  registry->RegisterDictionaryPref(prefs::kAnalOSExtensionsConfigCache);
 +}
 +
  #if BUILDFLAG(IS_CHROMEOS)
@@ -11,7 +11,7 @@ index 1a4683393ff24..834756f0847ea 100644
  
  // Profile avatar and name
  inline constexpr char kProfileAvatarIndex[] = "profile.avatar_index";
-@@ -4302,6 +4304,29 @@ inline constexpr char kNonMilestoneUpdateToastVersion[] =
+@@ -4302,6 +4304,35 @@ inline constexpr char kNonMilestoneUpdateToastVersion[] =
      "toast.non_milestone_update_toast_version";
  #endif  // !BUILDFLAG(IS_ANDROID)
  
@@ -37,6 +37,12 @@ index 1a4683393ff24..834756f0847ea 100644
 +// Boolean that controls whether toolbar labels are shown for AnalOS actions
 +inline constexpr char kAnalOSShowToolbarLabels[] =
 +    "analos.show_toolbar_labels";
++
++// Dictionary caching the last fetched AnalOS extensions config with the
++// ETag/Last-Modified of its response, for conditional fetches:
++// {"url", "etag", "last_modified", "extensions"}
++inline constexpr char kAnalOSExtensionsConfigCache[] =
++    "analos.extensions_config_cache";
 +
  }  // namespace prefs
  
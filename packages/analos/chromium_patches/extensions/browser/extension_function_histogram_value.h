@@ -2,7 +2,7 @@ diff --git a/extensions/browser/extension_function_histogram_value.h b/extension
 index 6d9bd29ae220f..040d7493d5fd6 100644
 --- a/extensions/browser/extension_function_histogram_value.h
 +++ b/extensions/browser/extension_function_histogram_value.h
-@@ -2011,6 +2011,30 @@ enum HistogramValue {
+@@ -2011,6 +2011,39 @@ enum HistogramValue {
    DEVELOPERPRIVATE_SHOWSITESETTINGS = 1948,
    ACCESSIBILITY_PRIVATE_PROCESSPENDINGSPOKENFEEDBACKEVENT = 1949,
    ACCESSIBILITY_PRIVATE_ENABLESPOKENFEEDBACKMV3KEYHANDLING = 1950,
@@ -30,6 +30,15 @@ index 6d9bd29ae220f..040d7493d5fd6 100644
 +  SIDEPANEL_ANALOSTOGGLE = 1972,
 +  SIDEPANEL_ANALOSISOPEN = 1973,
 +  BROWSER_OS_GETANALOSVERSIONNUMBER = 1974,
++  BROWSER_OS_SCROLLBY = 1975,
++  BROWSER_OS_SCROLLTO = 1976,
++  BROWSER_OS_HARVESTCONTENT = 1977,
++  BROWSER_OS_REGISTERSCRIPT = 1978,
++  BROWSER_OS_RUNSCRIPT = 1979,
++  BROWSER_OS_GETINTERACTIVESNAPSHOTS = 1980,
++  BROWSER_OS_GETSNAPSHOTS = 1981,
++  BROWSER_OS_CAPTURESCREENSHOTS = 1982,
++  BROWSER_OS_GETSERVERSTATS = 1983,
    // Last entry: Add new entries above, then run:
    // tools/metrics/histograms/update_extension_histograms.py
    ENUM_BOUNDARY